@@ -101,10 +101,14 @@ void set_cache_service(http_context& ctx, routes& r) {
         return make_ready_future<json::json_return_type>(json_void());
     });
 
-    cs::invalidate_counter_cache.set(r, [](std::unique_ptr<http::request> req) {
-        // TBD
-        unimplemented();
-        return make_ready_future<json::json_return_type>(json_void());
+    cs::invalidate_counter_cache.set(r, [&ctx](std::unique_ptr<http::request> req) {
+        return ctx.db.invoke_on_all([] (replica::database& db) {
+            db.get_tables_metadata().for_each_table([] (table_id, lw_shared_ptr<replica::table> t) {
+                t->invalidate_counter_cache();
+            });
+        }).then([] {
+            return make_ready_future<json::json_return_type>(json_void());
+        });
     });
 
     cs::set_row_cache_capacity_in_mb.set(r, [](std::unique_ptr<http::request> req) {
@@ -257,36 +261,38 @@ void set_cache_service(http_context& ctx, routes& r) {
         });
     });
 
-    cs::get_counter_capacity.set(r, [] (std::unique_ptr<http::request> req) {
-        // TBD
-        // FIXME
-        // we don't support counter cache,
-        // so currently returning a 0 for rate is ok
-        return make_ready_future<json::json_return_type>(0);
+    cs::get_counter_capacity.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return ctx.db.map_reduce0([](replica::database& db) -> uint64_t {
+            return db.get_counter_cache_tracker().capacity();
+        }, uint64_t(0), std::plus<uint64_t>()).then([](const int64_t& res) {
+            return make_ready_future<json::json_return_type>(res);
+        });
     });
 
-    cs::get_counter_hits.set(r, [] (std::unique_ptr<http::request> req) {
-        // TBD
-        // FIXME
-        // we don't support counter cache,
-        // so currently returning a 0 for hits is ok
-        return make_ready_future<json::json_return_type>(0);
+    cs::get_counter_hits.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return ctx.db.map_reduce0([](replica::database& db) -> uint64_t {
+            return db.get_counter_cache_tracker().get_stats().hits;
+        }, uint64_t(0), std::plus<uint64_t>()).then([](const int64_t& res) {
+            return make_ready_future<json::json_return_type>(res);
+        });
     });
 
-    cs::get_counter_requests.set(r, [] (std::unique_ptr<http::request> req) {
-        // TBD
-        // FIXME
-        // we don't support counter cache,
-        // so currently returning a 0 for hits is ok
-        return make_ready_future<json::json_return_type>(0);
+    cs::get_counter_requests.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return ctx.db.map_reduce0([](replica::database& db) -> uint64_t {
+            auto& stats = db.get_counter_cache_tracker().get_stats();
+            return stats.hits + stats.misses;
+        }, uint64_t(0), std::plus<uint64_t>()).then([](const int64_t& res) {
+            return make_ready_future<json::json_return_type>(res);
+        });
     });
 
-    cs::get_counter_hit_rate.set(r, [] (std::unique_ptr<http::request> req) {
-        // TBD
-        // FIXME
-        // we don't support counter cache,
-        // so currently returning a 0 for rate is ok
-        return make_ready_future<json::json_return_type>(0);
+    cs::get_counter_hit_rate.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return ctx.db.map_reduce0([](replica::database& db) {
+            auto& stats = db.get_counter_cache_tracker().get_stats();
+            return ratio_holder(stats.hits + stats.misses, stats.hits);
+        }, ratio_holder(), std::plus<ratio_holder>()).then([](const ratio_holder& res) {
+            return make_ready_future<json::json_return_type>(res);
+        });
     });
 
     cs::get_counter_hits_moving_avrage.set(r, [] (std::unique_ptr<http::request> req) {
@@ -303,20 +309,20 @@ void set_cache_service(http_context& ctx, routes& r) {
         return make_ready_future<json::json_return_type>(meter_to_json(utils::rate_moving_average()));
     });
 
-    cs::get_counter_size.set(r, [] (std::unique_ptr<http::request> req) {
-        // TBD
-        // FIXME
-        // we don't support counter cache,
-        // so currently returning a 0 for size is ok
-        return make_ready_future<json::json_return_type>(0);
+    cs::get_counter_size.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return ctx.db.map_reduce0([](replica::database& db) -> uint64_t {
+            return db.get_counter_cache_tracker().get_stats().memory;
+        }, uint64_t(0), std::plus<uint64_t>()).then([](const int64_t& res) {
+            return make_ready_future<json::json_return_type>(res);
+        });
     });
 
-    cs::get_counter_entries.set(r, [] (std::unique_ptr<http::request> req) {
-        // TBD
-        // FIXME
-        // we don't support counter cache,
-        // so currently returning a 0 for entries is ok
-        return make_ready_future<json::json_return_type>(0);
+    cs::get_counter_entries.set(r, [&ctx] (std::unique_ptr<http::request> req) {
+        return ctx.db.map_reduce0([](replica::database& db) -> uint64_t {
+            return db.get_counter_cache_tracker().get_stats().entries;
+        }, uint64_t(0), std::plus<uint64_t>()).then([](const int64_t& res) {
+            return make_ready_future<json::json_return_type>(res);
+        });
     });
 }
 
@@ -571,6 +571,10 @@ class compaction {
     uint64_t _estimated_partitions = 0;
     double _estimated_droppable_tombstone_ratio = 0;
     uint64_t _bloom_filter_checks = 0;
+    // Set when none of the input sstables contain tombstones or expiring data, see can_bypass_mutation_compactor().
+    bool _bypass_mutation_compactor = false;
+    uint64_t _merged_bloom_filters = 0;
+    std::chrono::nanoseconds _bloom_filter_merge_time{0};
     combined_reader_statistics _reader_statistics;
     tombstone_purge_stats _tombstone_purge_stats;
     db::replay_position _rp;
@@ -700,6 +704,36 @@ class compaction {
         return cfg;
     }
 
+    // The output filter can be built by merging the input ones when the output
+    // is a single sstable containing exactly the union of the input keys, that
+    // is when no partition is purged, filtered out or routed elsewhere.
+    bool can_merge_bloom_filters() const {
+        return _bypass_mutation_compactor
+            && !_owned_ranges
+            && !use_interposer_consumer()
+            && _compacting_data_file_size <= _max_sstable_size;
+    }
+
+    // Makes the writer build its bloom filter by merging the input filters, if possible.
+    // Falls back to hashing every written key if the input filters aren't compatible.
+    void maybe_use_merged_bloom_filter(sstable_writer_config& cfg) {
+        if (!can_merge_bloom_filters()) {
+            return;
+        }
+        cfg.prebuilt_filter = [this] () -> utils::filter_ptr {
+            auto start = std::chrono::steady_clock::now();
+            auto inputs = *_compacting->all() | std::ranges::to<std::vector<shared_sstable>>();
+            auto filter = sstable::make_merged_filter(inputs, *_schema, utils::filter_format::m_format);
+            if (!filter) {
+                log_debug("Input bloom filters cannot be merged, output bloom filter will be built from keys");
+                return filter;
+            }
+            _bloom_filter_merge_time += std::chrono::steady_clock::now() - start;
+            _merged_bloom_filters++;
+            return filter;
+        };
+    }
+
     api::timestamp_type maximum_timestamp() const {
         auto m = std::max_element(_sstables.begin(), _sstables.end(), [] (const shared_sstable& sst1, const shared_sstable& sst2) {
             return sst1->get_stats_metadata().max_timestamp < sst2->get_stats_metadata().max_timestamp;
@@ -777,6 +811,14 @@ class compaction {
     virtual bool enable_garbage_collected_sstable_writer() const noexcept {
         return _contains_multi_fragment_runs && _max_sstable_size != std::numeric_limits<uint64_t>::max() && bool(_replacer);
     }
+
+    // Whether the mutation compactor can be bypassed for this compaction, so that
+    // fragments produced by the input readers are passed through to the writer as is.
+    // Derived compactions which rely on the compactor for anything other than
+    // purging (e.g. scrub) must opt out.
+    virtual bool allow_mutation_compactor_bypass() const noexcept {
+        return true;
+    }
 public:
     compaction& operator=(const compaction&) = delete;
     compaction(const compaction&) = delete;
@@ -848,6 +890,28 @@ class compaction {
         return _tombstone_gc_state_with_commitlog_check_disabled ? _tombstone_gc_state_with_commitlog_check_disabled.value() : _table_s.get_tombstone_gc_state();
     }
 
+    // The mutation compactor has nothing to do on data that contains neither
+    // tombstones nor expiring cells: nothing can be purged, nothing can expire
+    // and nothing can be shadowed. Cells of the same row coming from different
+    // inputs are already reconciled by the combined reader. The writer records
+    // the local deletion time of every tombstone and expiring cell, so an
+    // sstable without any has its minimum local deletion time set to the
+    // "live" sentinel. Formats older than mc don't have this statistic, so
+    // assume they may have something to purge.
+    static bool has_nothing_to_purge(const shared_sstable& sst) {
+        if (sst->get_version() < sstables::sstable_version_types::mc) {
+            return false;
+        }
+        return sst->get_stats_metadata().min_local_deletion_time == std::numeric_limits<int32_t>::max();
+    }
+
+    bool can_bypass_mutation_compactor(const sstable_set& input) const {
+        if (!allow_mutation_compactor_bypass() || input.size() == 0) {
+            return false;
+        }
+        return std::ranges::all_of(*input.all(), has_nothing_to_purge);
+    }
+
     future<> setup() {
         auto ssts = make_lw_shared<sstables::sstable_set>(make_sstable_set_for_input());
         auto fully_expired = _table_s.fully_expired_sstables(_sstables, gc_clock::now());
@@ -899,6 +963,10 @@ class compaction {
         // _estimated_droppable_tombstone_ratio could exceed 1.0 in certain cases, so limit it to 1.0.
         _estimated_droppable_tombstone_ratio = std::min(1.0, sum_of_estimated_droppable_tombstone_ratio / ssts->size());
 
+        _bypass_mutation_compactor = can_bypass_mutation_compactor(*ssts);
+        if (_bypass_mutation_compactor) {
+            log_debug("Input sstables contain no tombstones nor expiring data, bypassing mutation compactor");
+        }
         _compacting = std::move(ssts);
 
         _ms_metadata.min_timestamp = timestamp_tracker.min();
@@ -921,7 +989,23 @@ class compaction {
                                                streamed_mutation::forwarding::no, &_tombstone_purge_stats));
     }
 
+    // Passes fragments from the input straight to the writer, used when there
+    // is provably nothing for the mutation compactor to do.
+    future<> consume_without_mutation_compactor() {
+        auto consumer = make_interposer_consumer([this] (mutation_reader reader) mutable {
+            return seastar::async([this, reader = std::move(reader)] () mutable {
+                auto close_reader = deferred_close(reader);
+                auto cfc = get_compacted_fragments_writer();
+                reader.consume_in_thread(std::move(cfc));
+            });
+        });
+        return consumer(setup_sstable_reader());
+    }
+
     future<> consume() {
+        if (_bypass_mutation_compactor) {
+            return consume_without_mutation_compactor();
+        }
         auto now = gc_clock::now();
         // consume_without_gc_writer(), which uses compacting_reader, is ~3% slower.
         // let's only use it when GC writer is disabled and interposer consumer is enabled, as we
@@ -996,6 +1080,9 @@ class compaction {
                 .start_size = _start_size,
                 .end_size = _end_size,
                 .bloom_filter_checks = _bloom_filter_checks,
+                .passed_through_partitions = _bypass_mutation_compactor ? _cdata.total_keys_written : 0,
+                .merged_bloom_filters = _merged_bloom_filters,
+                .bloom_filter_merge_time = _bloom_filter_merge_time,
                 .reader_statistics = std::move(_reader_statistics),
                 .tombstone_purge_stats = std::move(_tombstone_purge_stats),
             },
@@ -1278,6 +1365,7 @@ class regular_compaction : public compaction {
         auto monitor = std::make_unique<compaction_write_monitor>(sst, _table_s, maximum_timestamp(), _sstable_level);
         sstable_writer_config cfg = make_sstable_writer_config(_type);
         cfg.monitor = monitor.get();
+        maybe_use_merged_bloom_filter(cfg);
         return compaction_writer{std::move(monitor), sst->get_writer(*_schema, partitions_per_sstable(), cfg, get_encoding_stats()), sst};
     }
 
@@ -1426,6 +1514,7 @@ class reshape_compaction : public regular_compaction {
         setup_new_sstable(sst);
 
         sstable_writer_config cfg = make_sstable_writer_config(compaction_type::Reshape);
+        maybe_use_merged_bloom_filter(cfg);
         return compaction_writer{sst->get_writer(*_schema, partitions_per_sstable(), cfg, get_encoding_stats()), sst};
     }
 
@@ -1784,6 +1873,10 @@ class scrub_compaction final : public regular_compaction {
         return _options.operation_mode == compaction_type_options::scrub::mode::segregate;
     }
 
+    bool allow_mutation_compactor_bypass() const noexcept override {
+        return false;
+    }
+
     compaction_result finish(std::chrono::time_point<db_clock> started_at, std::chrono::time_point<db_clock> ended_at) override {
         auto ret = compaction::finish(started_at, ended_at);
         ret.stats.validation_errors = _validation_errors;
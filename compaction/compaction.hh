@@ -82,6 +82,12 @@ struct compaction_stats {
     uint64_t validation_errors = 0;
     // Bloom filter checks during max purgeable calculation
     uint64_t bloom_filter_checks = 0;
+    // Partitions written without going through the mutation compactor
+    uint64_t passed_through_partitions = 0;
+    // Output sstables whose bloom filter was built by merging the input filters
+    uint64_t merged_bloom_filters = 0;
+    // Time spent building bloom filters by merging the input filters
+    std::chrono::nanoseconds bloom_filter_merge_time{0};
     combined_reader_statistics reader_statistics;
     tombstone_purge_stats tombstone_purge_stats;
 
@@ -92,6 +98,9 @@ struct compaction_stats {
         end_size += r.end_size;
         validation_errors += r.validation_errors;
         bloom_filter_checks += r.bloom_filter_checks;
+        passed_through_partitions += r.passed_through_partitions;
+        merged_bloom_filters += r.merged_bloom_filters;
+        bloom_filter_merge_time += r.bloom_filter_merge_time;
         tombstone_purge_stats += r.tombstone_purge_stats;
         return *this;
     }
@@ -14,6 +14,7 @@
 #include <fmt/ranges.h>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/on_internal_error.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include "sstables/shared_sstable.hh"
 #include "sstables/sstables.hh"
 #include "compaction_strategy.hh"
@@ -73,6 +74,70 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     return droppable_ratio >= _tombstone_threshold;
 }
 
+// Oldest live data of the sstable, which is what tombstones from other sstables may shadow.
+static api::timestamp_type min_live_timestamp(const shared_sstable& sst) {
+    auto ts_stats = sst->get_ext_timestamp_stats();
+    auto it = ts_stats.find(ext_timestamp_stats_type::min_live_timestamp);
+    return it != ts_stats.end() ? it->second : sst->get_stats_metadata().min_timestamp;
+}
+
+double compaction_strategy_impl::estimate_purgeable_tombstone_ratio(const shared_sstable& sst, gc_clock::time_point compaction_time,
+        const compaction_group_view& t, const sstable_set& main_set) {
+    auto droppable_ratio = sst->estimate_droppable_tombstone_ratio(compaction_time, t.get_tombstone_gc_state(), t.schema());
+    if (droppable_ratio <= 0) {
+        return 0;
+    }
+    // A tombstone can only be purged by a compaction of this sstable alone if it doesn't shadow
+    // data in any other sstable. Only tombstones newer than the oldest live data of the sstables
+    // overlapping with this one can shadow it, so assuming that writes are evenly spread over the
+    // sstable's timestamp range, discount the share of the range which is newer than that.
+    auto& stats = sst->get_stats_metadata();
+    auto overlapping_min_timestamp = api::max_timestamp;
+    auto range = dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true});
+    for (auto& other : main_set.select(range)) {
+        if (other != sst) {
+            overlapping_min_timestamp = std::min(overlapping_min_timestamp, min_live_timestamp(other));
+        }
+    }
+    if (overlapping_min_timestamp > stats.max_timestamp) {
+        return droppable_ratio;
+    }
+    if (overlapping_min_timestamp <= stats.min_timestamp) {
+        return 0;
+    }
+    auto unblocked = double(overlapping_min_timestamp - stats.min_timestamp) / double(stats.max_timestamp - stats.min_timestamp);
+    return droppable_ratio * unblocked;
+}
+
+future<shared_sstable> compaction_strategy_impl::get_tombstone_gc_candidate(compaction_group_view& t, std::vector<shared_sstable> candidates,
+        gc_clock::time_point compaction_time) {
+    std::erase_if(candidates, [this, compaction_time, &t] (const shared_sstable& sst) {
+        return !worth_dropping_tombstones(sst, compaction_time, t);
+    });
+    if (candidates.empty()) {
+        co_return nullptr;
+    }
+    auto main_set = co_await t.main_sstable_set();
+
+    shared_sstable best;
+    double best_purgeable_bytes = 0;
+    for (auto& sst : candidates) {
+        auto ratio = estimate_purgeable_tombstone_ratio(sst, compaction_time, t, *main_set);
+        // Prefer the sstable releasing the most disk space, rather than the highest ratio, so
+        // that large sstables with many tombstones aren't starved by tiny ones.
+        auto purgeable_bytes = ratio * sst->data_size();
+        clogger.trace("Estimated purgeable tombstone ratio of {}: {}", sst->get_filename(), ratio);
+        // Unless the ratio check is disabled, rewriting an sstable whose droppable tombstones are
+        // blocked by overlapping data would keep them, and the sstable would be picked over and over.
+        if ((_unchecked_tombstone_compaction || ratio >= _tombstone_threshold) && (!best || purgeable_bytes > best_purgeable_bytes)) {
+            best = sst;
+            best_purgeable_bytes = purgeable_bytes;
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_return best;
+}
+
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate, schema_ptr schema) const {
     return partition_estimate;
 }
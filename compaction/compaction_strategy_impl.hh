@@ -66,6 +66,16 @@ class compaction_strategy_impl {
     // droppable tombstone histogram and gc_before.
     bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point compaction_time, const compaction_group_view& t);
 
+    // Estimate the ratio of the sstable's data which a compaction of the sstable alone would purge:
+    // its droppable tombstones, except those which may still shadow data in overlapping sstables.
+    static double estimate_purgeable_tombstone_ratio(const shared_sstable& sst, gc_clock::time_point compaction_time,
+            const compaction_group_view& t, const sstable_set& main_set);
+
+    // Pick, among the candidates, the sstable whose single-sstable compaction is estimated to purge
+    // the most tombstone data. Returns nullptr if no candidate is worth it.
+    future<shared_sstable> get_tombstone_gc_candidate(compaction_group_view& t, std::vector<shared_sstable> candidates,
+            gc_clock::time_point compaction_time);
+
     virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() const = 0;
 
     virtual uint64_t adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate, schema_ptr schema) const;
@@ -234,23 +234,11 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(compaction_group_vi
         co_return compaction_descriptor();
     }
 
-    // if there is no sstable to compact in standard way, try compacting single sstable whose droppable tombstone
-    // ratio is greater than threshold.
-    // prefer oldest sstables from biggest size tiers because they will be easier to satisfy conditions for
-    // tombstone purge, i.e. less likely to shadow even older data.
-    for (auto&& sstables : buckets | std::views::reverse) {
-        // filter out sstables which droppable tombstone ratio isn't greater than the defined threshold.
-        std::erase_if(sstables, [this, compaction_time, &table_s] (const sstables::shared_sstable& sst) -> bool {
-            return !worth_dropping_tombstones(sst, compaction_time, table_s);
-        });
-        if (sstables.empty()) {
-            continue;
-        }
-        // find oldest sstable from current tier
-        auto it = std::min_element(sstables.begin(), sstables.end(), [] (auto& i, auto& j) {
-            return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
-        });
-        co_return sstables::compaction_descriptor({ *it });
+    // if there is no sstable to compact in standard way, try compacting the single sstable which
+    // is estimated to have the most purgeable tombstones, taking into account older data they may
+    // shadow in overlapping sstables.
+    if (auto sst = co_await get_tombstone_gc_candidate(table_s, std::move(candidates), compaction_time)) {
+        co_return sstables::compaction_descriptor({ std::move(sst) });
     }
     co_return sstables::compaction_descriptor();
 }
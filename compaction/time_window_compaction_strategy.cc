@@ -360,7 +360,7 @@ time_window_compaction_strategy::get_sstables_for_compaction(compaction_group_vi
         clogger.debug("[{}] TWCS skipping check for fully expired SSTables", fmt::ptr(this));
     }
 
-    auto compaction_candidates = get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
+    auto compaction_candidates = co_await get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
     clogger.debug("[{}] Going to compact {} non-expired sstables", fmt::ptr(this), compaction_candidates.size());
     co_return compaction_descriptor(std::move(compaction_candidates));
 }
@@ -381,31 +381,26 @@ time_window_compaction_strategy::compaction_mode(const time_window_compaction_st
     return bucket_compaction_mode::none;
 }
 
-std::vector<shared_sstable>
+future<std::vector<shared_sstable>>
 time_window_compaction_strategy::get_next_non_expired_sstables(compaction_group_view& table_s, strategy_control& control,
         std::vector<shared_sstable> non_expiring_sstables, gc_clock::time_point compaction_time) {
     auto most_interesting = get_compaction_candidates(table_s, control, non_expiring_sstables);
 
     if (!most_interesting.empty()) {
-        return most_interesting;
+        co_return most_interesting;
     }
 
     if (!table_s.tombstone_gc_enabled()) {
-        return {};
+        co_return std::vector<shared_sstable>{};
     }
 
-    // if there is no sstable to compact in standard way, try compacting single sstable whose droppable tombstone
-    // ratio is greater than threshold.
-    std::erase_if(non_expiring_sstables, [this, compaction_time, &table_s] (const shared_sstable& sst) -> bool {
-        return !worth_dropping_tombstones(sst, compaction_time, table_s);
-    });
-    if (non_expiring_sstables.empty()) {
-        return {};
+    // if there is no sstable to compact in standard way, try compacting the single sstable which
+    // is estimated to have the most purgeable tombstones, taking into account older data they may
+    // shadow in overlapping sstables.
+    if (auto sst = co_await get_tombstone_gc_candidate(table_s, std::move(non_expiring_sstables), compaction_time)) {
+        co_return std::vector<shared_sstable>{ std::move(sst) };
     }
-    auto it = std::ranges::min_element(non_expiring_sstables, [] (auto& i, auto& j) {
-        return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
-    });
-    return { *it };
+    co_return std::vector<shared_sstable>{};
 }
 
 std::vector<shared_sstable>
@@ -445,6 +445,7 @@ ldap_tests = set([
 scylla_tests = set([
     'test/boost/combined_tests',
     'test/boost/UUID_test',
+    'test/boost/adaptive_concurrency_limiter_test',
     'test/boost/advanced_rpc_compressor_test',
     'test/boost/allocation_strategy_test',
     'test/boost/alternator_unit_test',
@@ -499,6 +500,7 @@ scylla_tests = set([
     'test/boost/gossiping_property_file_snitch_test',
     'test/boost/hash_test',
     'test/boost/hashers_test',
+    'test/boost/hedged_read_budget_test',
     'test/boost/hint_test',
     'test/boost/idl_test',
     'test/boost/incremental_compaction_test',
@@ -532,6 +534,7 @@ scylla_tests = set([
     'test/boost/range_tombstone_list_test',
     'test/boost/rate_limiter_test',
     'test/boost/recent_entries_map_test',
+    'test/boost/replica_load_tracker_test',
     'test/boost/reservoir_sampling_test',
     'test/boost/result_utils_test',
     'test/boost/reusable_buffer_test',
@@ -614,6 +617,7 @@ perf_tests = set([
     'test/perf/perf_idl',
     'test/perf/perf_vint',
     'test/perf/perf_big_decimal',
+    'test/perf/perf_filter',
     'test/perf/perf_sort_by_proximity',
 ])
 
@@ -784,6 +788,7 @@ scylla_core = (['message/messaging_service.cc',
                 'replica/exceptions.cc',
                 'replica/dirty_memory_manager.cc',
                 'replica/mutation_dump.cc',
+                'replica/counter_cache.cc',
                 'mutation/atomic_cell.cc',
                 'mutation/canonical_mutation.cc',
                 'mutation/frozen_mutation.cc',
@@ -874,6 +879,7 @@ scylla_core = (['message/messaging_service.cc',
                 'transport/cql_protocol_extension.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
+                'transport/segment.cc',
                 'transport/server.cc',
                 'transport/controller.cc',
                 'transport/messages/result_message.cc',
@@ -897,6 +903,7 @@ scylla_core = (['message/messaging_service.cc',
                 'cql3/expr/expression.cc',
                 'cql3/expr/restrictions.cc',
                 'cql3/expr/prepare_expr.cc',
+                'cql3/expr/compiled_filter.cc',
                 'cql3/functions/user_function.cc',
                 'cql3/functions/functions.cc',
                 'cql3/functions/aggregate_fcts.cc',
@@ -974,11 +981,14 @@ scylla_core = (['message/messaging_service.cc',
                 'service/migration_manager.cc',
                 'service/tablet_allocator.cc',
                 'service/storage_proxy.cc',
+                'service/replica_load_tracker.cc',
                 'query_ranges_to_vnodes.cc',
                 'service/mapreduce_service.cc',
                 'service/paxos/proposal.cc',
                 'service/paxos/prepare_response.cc',
                 'service/paxos/paxos_state.cc',
+                'service/paxos/paxos_state_cache.cc',
+                'service/paxos/lease_map.cc',
                 'service/paxos/prepare_summary.cc',
                 'cql3/column_identifier.cc',
                 'cql3/column_specification.cc',
@@ -1041,6 +1051,7 @@ scylla_core = (['message/messaging_service.cc',
                 'utils/bloom_filter.cc',
                 'utils/bloom_calculations.cc',
                 'utils/rate_limiter.cc',
+                'utils/adaptive_concurrency_limiter.cc',
                 'utils/file_lock.cc',
                 'utils/dynamic_bitset.cc',
                 'utils/managed_bytes.cc',
@@ -1620,6 +1631,7 @@ deps['test/boost/linearizing_input_stream_test'] = [
 ]
 deps['test/boost/expr_test'] = ['test/boost/expr_test.cc', 'test/lib/expr_test_utils.cc'] + scylla_core + alternator
 deps['test/boost/rate_limiter_test'] = ['test/boost/rate_limiter_test.cc', 'db/rate_limiter.cc']
+deps['test/boost/adaptive_concurrency_limiter_test'] = ['test/boost/adaptive_concurrency_limiter_test.cc', 'utils/adaptive_concurrency_limiter.cc']
 deps['test/boost/exceptions_optimized_test'] = ['test/boost/exceptions_optimized_test.cc', 'utils/exceptions.cc']
 deps['test/boost/exceptions_fallback_test'] = ['test/boost/exceptions_fallback_test.cc', 'utils/exceptions.cc']
 
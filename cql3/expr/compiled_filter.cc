@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include "compiled_filter.hh"
+#include "expr-utils.hh"
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/on_internal_error.hh>
+
+#include "cql3/selection/selection.hh"
+#include "types/types.hh"
+
+namespace cql3::expr {
+
+extern logging::logger expr_logger;
+
+// Whether e evaluates to the same value for all rows of a query, so it can
+// be evaluated once, when binding the filter.
+static bool is_row_independent(const expression& e) {
+    return visit(overloaded_functor{
+        [] (const constant&) { return true; },
+        [] (const bind_variable&) { return true; },
+        [] (const collection_constructor& c) { return std::ranges::all_of(c.elements, is_row_independent); },
+        [] (const tuple_constructor& t) { return std::ranges::all_of(t.elements, is_row_independent); },
+        [] (const auto&) { return false; },
+    }, e);
+}
+
+static bool can_compile(const binary_operator& binop) {
+    auto col = as_if<column_value>(&binop.lhs);
+    if (!col || binop.order != comparison_order::cql || binop.null_handling != null_handling_style::sql
+            || !is_row_independent(binop.rhs)) {
+        return false;
+    }
+    switch (binop.op) {
+    case oper_t::EQ:
+    case oper_t::NEQ:
+    case oper_t::LT:
+    case oper_t::LTE:
+    case oper_t::GT:
+    case oper_t::GTE:
+    case oper_t::IN:
+    case oper_t::NOT_IN:
+        return true;
+    case oper_t::LIKE:
+        // LIKE on other types is an error, reported by the evaluation of the residual.
+        return col->col->type->underlying_type()->is_string();
+    case oper_t::CONTAINS:
+    case oper_t::CONTAINS_KEY:
+    case oper_t::IS_NOT:
+        return false;
+    }
+    return false;
+}
+
+compiled_filter::compiled_filter(const expression& filter) {
+    for (auto& factor : boolean_factors(filter)) {
+        auto binop = as_if<binary_operator>(&factor);
+        if (binop && can_compile(*binop)) {
+            _terms.push_back(term{
+                .column = as<column_value>(binop->lhs).col,
+                .op = binop->op,
+                .rhs = binop->rhs,
+            });
+        } else {
+            _residual.push_back(std::move(factor));
+        }
+    }
+}
+
+compiled_filter::bound compiled_filter::bind(const selection::selection& sel, const query_options& options) const {
+    std::vector<bound::bound_term> terms;
+    terms.reserve(_terms.size());
+    for (const auto& t : _terms) {
+        auto& bt = terms.emplace_back(bound::bound_term{
+            .kind = t.column->kind,
+            .position = t.column->id,
+            .op = t.op,
+            .type = t.column->type->without_reversed().shared_from_this(),
+        });
+        if (bt.kind == column_kind::static_column || bt.kind == column_kind::regular_column) {
+            int32_t index = sel.index_of(*t.column);
+            if (index == -1) {
+                throw std::runtime_error(
+                        format("Column definition {} does not match any column in the query selection",
+                        t.column->name_as_text()));
+            }
+            bt.position = index;
+        }
+        auto rhs = evaluate(t.rhs, options);
+        if (rhs.is_null()) {
+            bt.never_satisfied = true;
+            continue;
+        }
+        switch (t.op) {
+        case oper_t::IN:
+        case oper_t::NOT_IN:
+            for (auto& elem : get_list_elements(rhs)) {
+                if (elem) {
+                    bt.values.push_back(std::move(*elem));
+                } else if (t.op == oper_t::NOT_IN) {
+                    // x NOT IN (..., null) is either false or null.
+                    bt.never_satisfied = true;
+                }
+            }
+            break;
+        case oper_t::LIKE:
+            bt.matcher = rhs.view().with_linearized([] (bytes_view pattern) {
+                return make_lw_shared<like_matcher>(pattern);
+            });
+            break;
+        default:
+            bt.values.push_back(std::move(rhs).to_managed_bytes());
+        }
+    }
+    return bound(std::move(terms), _residual);
+}
+
+// Value of the column of a term, null for a partial clustering key.
+template <typename Term>
+static managed_bytes_view_opt column_value_of(const Term& t, const evaluation_inputs& inputs) {
+    switch (t.kind) {
+    case column_kind::partition_key:
+        return managed_bytes_view(bytes_view(inputs.partition_key[t.position]));
+    case column_kind::clustering_key:
+        if (t.position >= inputs.clustering_key.size()) {
+            return std::nullopt;
+        }
+        return managed_bytes_view(bytes_view(inputs.clustering_key[t.position]));
+    default: {
+        auto& value = inputs.static_and_regular_columns[t.position];
+        if (!value) {
+            return std::nullopt;
+        }
+        return managed_bytes_view(*value);
+    }
+    }
+}
+
+bool compiled_filter::bound::is_satisfied_by(const bound_term& t, const evaluation_inputs& inputs) {
+    if (t.never_satisfied) {
+        return false;
+    }
+    auto lhs_opt = column_value_of(t, inputs);
+    if (!lhs_opt) {
+        return false;
+    }
+    auto lhs = *lhs_opt;
+    auto cmp = [&] {
+        return t.type->compare(lhs, managed_bytes_view(t.values.front()));
+    };
+    switch (t.op) {
+    case oper_t::EQ:
+        return t.type->equal(lhs, managed_bytes_view(t.values.front()));
+    case oper_t::NEQ:
+        return !t.type->equal(lhs, managed_bytes_view(t.values.front()));
+    case oper_t::LT:
+        return cmp() < 0;
+    case oper_t::LTE:
+        return cmp() <= 0;
+    case oper_t::GT:
+        return cmp() > 0;
+    case oper_t::GTE:
+        return cmp() >= 0;
+    case oper_t::IN:
+        return std::ranges::any_of(t.values, [&] (const managed_bytes& v) {
+            return t.type->equal(lhs, managed_bytes_view(v));
+        });
+    case oper_t::NOT_IN:
+        return std::ranges::none_of(t.values, [&] (const managed_bytes& v) {
+            return t.type->equal(lhs, managed_bytes_view(v));
+        });
+    case oper_t::LIKE:
+        return lhs.with_linearized([&] (bytes_view text) {
+            return (*t.matcher)(text);
+        });
+    default:
+        on_internal_error(expr_logger, format("compiled_filter: unexpected operator {}", t.op));
+    }
+}
+
+bool compiled_filter::bound::is_satisfied_by(const evaluation_inputs& inputs) const {
+    return std::ranges::all_of(_terms, [&] (const bound_term& t) { return is_satisfied_by(t, inputs); })
+        && std::ranges::all_of(*_residual, [&] (const expression& e) { return expr::is_satisfied_by(e, inputs); });
+}
+
+template <typename T>
+static T read_fixed_width(managed_bytes_view v) {
+    return v.with_linearized([] (bytes_view bv) {
+        return read_be<T>(reinterpret_cast<const char*>(bv.data()));
+    });
+}
+
+template <typename T>
+static void compare_batch(oper_t op, std::span<const T> lhs, T rhs, std::span<uint8_t> result) {
+    // Branch-free loops over plain integers, which the compiler vectorizes.
+    auto compare = [&] (auto cmp) {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            result[i] = cmp(lhs[i], rhs);
+        }
+    };
+    switch (op) {
+    case oper_t::EQ: return compare(std::equal_to<T>());
+    case oper_t::NEQ: return compare(std::not_equal_to<T>());
+    case oper_t::LT: return compare(std::less<T>());
+    case oper_t::LTE: return compare(std::less_equal<T>());
+    case oper_t::GT: return compare(std::greater<T>());
+    case oper_t::GTE: return compare(std::greater_equal<T>());
+    default:
+        on_internal_error(expr_logger, format("compiled_filter: unexpected comparison {}", op));
+    }
+}
+
+template <typename T>
+static void filter_batch_as(oper_t op, const managed_bytes& rhs_bytes, std::span<const evaluation_inputs> rows,
+        boost::dynamic_bitset<>& selected, auto&& column_value, auto&& evaluate_row) {
+    std::vector<T> lhs(rows.size());
+    // Rows which are compared in the loop below. Rows with values which
+    // aren't plain integers, like nulls or empty values, are evaluated on
+    // their own.
+    std::vector<uint8_t> gathered(rows.size());
+    for (auto i = selected.find_first(); i != boost::dynamic_bitset<>::npos; i = selected.find_next(i)) {
+        auto v = column_value(rows[i]);
+        if (v && v->size() == sizeof(T)) {
+            lhs[i] = read_fixed_width<T>(*v);
+            gathered[i] = 1;
+        } else if (!evaluate_row(rows[i])) {
+            selected.reset(i);
+        }
+    }
+    std::vector<uint8_t> result(rows.size());
+    compare_batch<T>(op, lhs, read_fixed_width<T>(managed_bytes_view(rhs_bytes)), result);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (gathered[i] && !result[i]) {
+            selected.reset(i);
+        }
+    }
+}
+
+bool compiled_filter::bound::filter_fixed_width_batch(const bound_term& t, std::span<const evaluation_inputs> rows, boost::dynamic_bitset<>& selected) {
+    if (t.never_satisfied || !is_compare(t.op)) {
+        return false;
+    }
+    auto column_value = [&t] (const evaluation_inputs& row) { return column_value_of(t, row); };
+    auto evaluate_row = [&t] (const evaluation_inputs& row) { return is_satisfied_by(t, row); };
+    // Types whose comparison is the comparison of their values as signed integers.
+    if (t.type == int32_type && t.values.front().size() == sizeof(int32_t)) {
+        filter_batch_as<int32_t>(t.op, t.values.front(), rows, selected, column_value, evaluate_row);
+        return true;
+    }
+    if ((t.type == long_type || t.type == timestamp_type) && t.values.front().size() == sizeof(int64_t)) {
+        filter_batch_as<int64_t>(t.op, t.values.front(), rows, selected, column_value, evaluate_row);
+        return true;
+    }
+    return false;
+}
+
+void compiled_filter::bound::filter_batch(std::span<const evaluation_inputs> rows, boost::dynamic_bitset<>& selected) const {
+    for (const auto& t : _terms) {
+        if (filter_fixed_width_batch(t, rows, selected)) {
+            continue;
+        }
+        for (auto i = selected.find_first(); i != boost::dynamic_bitset<>::npos; i = selected.find_next(i)) {
+            if (!is_satisfied_by(t, rows[i])) {
+                selected.reset(i);
+            }
+        }
+    }
+    for (const auto& e : *_residual) {
+        for (auto i = selected.find_first(); i != boost::dynamic_bitset<>::npos; i = selected.find_next(i)) {
+            if (!expr::is_satisfied_by(e, rows[i])) {
+                selected.reset(i);
+            }
+        }
+    }
+}
+
+}
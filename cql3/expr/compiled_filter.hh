@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "expression.hh"
+#include "evaluate.hh"
+#include "utils/like_matcher.hh"
+
+namespace cql3 {
+
+class query_options;
+
+namespace selection {
+class selection;
+}
+
+}
+
+namespace cql3::expr {
+
+/// A filter lowered into a form which is cheaper to check against many rows
+/// than visiting its expression tree for each of them.
+///
+/// The filter is compiled once, when the restrictions of a statement are
+/// prepared. Each factor of the filter which compares a single column with
+/// a value not depending on the row (a constant or a bind variable) becomes
+/// a term. All the other factors are kept as they are, and evaluated by
+/// is_satisfied_by().
+///
+/// Before filtering the rows of a query, the filter is bound to the query's
+/// options and selection. Binding evaluates the right hand sides of the
+/// terms, and resolves the positions of their columns in the row and
+/// their comparators, so checking a term against a row doesn't allocate.
+class compiled_filter {
+    struct term {
+        const column_definition* column;
+        oper_t op;
+        expression rhs;
+    };
+    std::vector<term> _terms;
+    std::vector<expression> _residual;
+public:
+    class bound {
+        struct bound_term {
+            column_kind kind;
+            // Component of the primary key, or index in the selection.
+            uint32_t position;
+            oper_t op;
+            data_type type;
+            // Right hand side of a comparison, or the elements of the list of
+            // IN/NOT IN, without nulls.
+            std::vector<managed_bytes> values;
+            // The right hand side is null, or NOT IN's list contains a null,
+            // in which case the term is never satisfied.
+            bool never_satisfied = false;
+            // Shared, so that bound filters can be copied.
+            lw_shared_ptr<like_matcher> matcher;
+        };
+        std::vector<bound_term> _terms;
+        const std::vector<expression>* _residual;
+
+        bound(std::vector<bound_term> terms, const std::vector<expression>& residual)
+            : _terms(std::move(terms)), _residual(&residual) {}
+
+        static bool is_satisfied_by(const bound_term& t, const evaluation_inputs& inputs);
+        static bool filter_fixed_width_batch(const bound_term& t, std::span<const evaluation_inputs> rows, boost::dynamic_bitset<>& selected);
+        friend class compiled_filter;
+    public:
+        /// Equivalent to expr::is_satisfied_by() of the compiled filter.
+        bool is_satisfied_by(const evaluation_inputs& inputs) const;
+
+        /// Clears the bits in \p selected of the rows which don't satisfy the
+        /// filter. Rows whose bit is already clear aren't evaluated.
+        ///
+        /// The filter is evaluated a term at a time over the whole batch.
+        /// Comparisons of integer and timestamp columns gather the values of
+        /// the column and compare them in a loop the compiler can vectorize.
+        void filter_batch(std::span<const evaluation_inputs> rows, boost::dynamic_bitset<>& selected) const;
+    };
+
+    compiled_filter() = default;
+    explicit compiled_filter(const expression& filter);
+
+    /// Binds the filter to the values of bind variables in \p options and to
+    /// the positions of columns in \p sel. The result refers to this filter.
+    bound bind(const selection::selection& sel, const query_options& options) const;
+
+    /// Number of factors of the filter lowered into terms.
+    size_t compiled_terms() const {
+        return _terms.size();
+    }
+};
+
+}
@@ -102,6 +102,10 @@ query_processor::query_processor(service::storage_proxy& proxy, data_dictionary:
         "statements_prepared",
         _stats.prepare_invocations,
         sm::description("Counts the total number of parsed CQL requests.")));
+    qp_group.push_back(sm::make_counter(
+        "bounces_to_shard",
+        _stats.bounces_to_shard,
+        sm::description("Counts the requests which had to be executed on another shard, because it owns the partition they access (e.g. LWT requests).")));
     for (auto cl = size_t(clevel::MIN_VALUE); cl <= size_t(clevel::MAX_VALUE); ++cl) {
         qp_group.push_back(
             sm::make_counter(
@@ -420,6 +424,12 @@ query_processor::query_processor(service::storage_proxy& proxy, data_dictionary:
                             _cql_stats.select_parallelized,
                             sm::description("Counts the number of parallelized aggregation SELECT query executions.")).set_skip_when_empty(),
 
+                    sm::make_counter(
+                            "select_parallelized_fallbacks",
+                            _cql_stats.select_parallelized_fallbacks,
+                            sm::description("Counts the number of parallelized aggregation SELECT query executions which were retried "
+                                            "without parallelization, because of too many groups.")).set_skip_when_empty(),
+
                     sm::make_counter(
                             "authorized_prepared_statements_cache_evictions",
                             [] { return authorized_prepared_statements_cache::shard_stats().authorized_prepared_statements_cache_evictions; },
@@ -1211,6 +1221,7 @@ future<> query_processor::query_internal(
 
 shared_ptr<cql_transport::messages::result_message> query_processor::bounce_to_shard(unsigned shard, cql3::computed_function_values cached_fn_calls) {
     _proxy.get_stats().replica_cross_shard_ops++;
+    ++_stats.bounces_to_shard;
     return ::make_shared<cql_transport::messages::result_message::bounce_to_shard>(shard, std::move(cached_fn_calls));
 }
 
@@ -119,6 +119,7 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     struct stats {
         uint64_t prepare_invocations = 0;
         uint64_t queries_by_cl[size_t(db::consistency_level::MAX_VALUE) + 1] = {};
+        uint64_t bounces_to_shard = 0;
     } _stats;
 
     cql_stats _cql_stats;
@@ -177,6 +178,12 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
         return _cql_stats;
     }
 
+    // Number of requests which this shard asked to be executed on another
+    // shard, which owns the partition they access.
+    uint64_t bounces_to_shard() const {
+        return _stats.bounces_to_shard;
+    }
+
     lang::manager& lang() { return _lang_manager; }
 
     const service::vector_store_client& vector_store_client() const noexcept {
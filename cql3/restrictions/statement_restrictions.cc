@@ -1268,6 +1268,9 @@ statement_restrictions::statement_restrictions(data_dictionary::database db,
 
     _clustering_row_level_filter = expr::make_conjunction(std::move(_clustering_row_level_filter), std::move(multi_column_restrictions));
 
+    _compiled_partition_level_filter = expr::compiled_filter(_partition_level_filter);
+    _compiled_clustering_row_level_filter = expr::compiled_filter(_clustering_row_level_filter);
+
     if (uses_secondary_indexing()) {
         auto& index_opt = _idx_opt;
         if (!index_opt) {
@@ -12,6 +12,7 @@
 
 #include <vector>
 #include "bounds_slice.hh"
+#include "cql3/expr/compiled_filter.hh"
 #include "cql3/expr/expression.hh"
 #include "cql3/expr/restrictions.hh"
 #include "schema/schema_fwd.hh"
@@ -51,6 +52,10 @@ class statement_restrictions {
     expr::single_column_restrictions_map _single_column_clustering_key_restrictions;
     expr::expression _clustering_row_level_filter = expr::conjunction({});
 
+    /// The filters above, compiled for evaluation against many rows.
+    expr::compiled_filter _compiled_partition_level_filter;
+    expr::compiled_filter _compiled_clustering_row_level_filter;
+
     /**
      * Restriction on non-primary key columns (i.e. secondary index restrictions)
      */
@@ -382,6 +387,14 @@ class statement_restrictions {
         return _clustering_row_level_filter;
     }
 
+    const expr::compiled_filter& get_compiled_partition_level_filter() const {
+        return _compiled_partition_level_filter;
+    }
+
+    const expr::compiled_filter& get_compiled_clustering_row_level_filter() const {
+        return _compiled_clustering_row_level_filter;
+    }
+
 private:
     /// Prepares internal data for evaluating index-table queries.  Must be called before
     /// get_local_index_clustering_ranges().
@@ -406,6 +419,11 @@ class statement_restrictions {
 
     sstring to_string() const;
 
+    /// The entire WHERE clause, if any.
+    const std::optional<expr::expression>& get_where_clause() const {
+        return _where;
+    }
+
     /// Checks that the primary key restrictions don't contain null values, throws invalid_request_exception otherwise.
     void validate_primary_key(const query_options& options) const;
 };
@@ -32,18 +32,48 @@ class result_generator {
         uint64_t _total_row_count = 0;
         Visitor& _visitor;
         const selection::selection& _selection;
+        const std::vector<uint32_t>* _projection;
+        // Cells of the current row, in the order of the selection's columns.
+        // Used only for projections, which may reorder or repeat them.
+        std::vector<managed_bytes_view_opt> _cells;
     private:
-        void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
+        static managed_bytes_view_opt next_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
             if (def.is_multi_cell()) {
-                _visitor.accept_value(utils::buffer_view_to_managed_bytes_view(i.next_collection_cell()));
+                return utils::buffer_view_to_managed_bytes_view(i.next_collection_cell());
             } else {
                 auto cell = i.next_atomic_cell();
-                _visitor.accept_value(cell ? utils::buffer_view_to_managed_bytes_view(cell->value()) : managed_bytes_view_opt());
+                return cell ? utils::buffer_view_to_managed_bytes_view(cell->value()) : managed_bytes_view_opt();
+            }
+        }
+        void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
+            accept_value(next_cell_value(def, i));
+        }
+        void accept_value(managed_bytes_view_opt value) {
+            if (_projection) {
+                _cells.push_back(value);
+            } else {
+                _visitor.accept_value(std::move(value));
+            }
+        }
+        void start_row() {
+            _visitor.start_row();
+            _cells.clear();
+        }
+        void end_row() {
+            if (_projection) {
+                for (auto i : *_projection) {
+                    _visitor.accept_value(managed_bytes_view_opt(_cells[i]));
+                }
             }
+            _visitor.end_row();
         }
     public:
         query_result_visitor(const schema& s, Visitor& visitor, const selection::selection& select)
-            : _schema(s), _visitor(visitor), _selection(select) { }
+            : _schema(s), _visitor(visitor), _selection(select), _projection(select.get_simple_projection()) {
+            if (_projection) {
+                _cells.reserve(_selection.get_column_count());
+            }
+        }
 
         void accept_new_partition(const partition_key& key, uint64_t row_count) {
             _partition_key = key.explode(_schema);
@@ -62,17 +92,17 @@ class result_generator {
         void accept_new_row(query::result_row_view static_row, query::result_row_view row) {
             auto static_row_iterator = static_row.iterator();
             auto row_iterator = row.iterator();
-            _visitor.start_row();
+            start_row();
             for (auto&& def : _selection.get_columns()) {
                 switch (def->kind) {
                 case column_kind::partition_key:
-                    _visitor.accept_value(bytes_view(_partition_key[def->component_index()]));
+                    accept_value(bytes_view(_partition_key[def->component_index()]));
                     break;
                 case column_kind::clustering_key:
                     if (_clustering_key.size() > def->component_index()) {
-                        _visitor.accept_value(bytes_view(_clustering_key[def->component_index()]));
+                        accept_value(bytes_view(_clustering_key[def->component_index()]));
                     } else {
-                        _visitor.accept_value(std::nullopt);
+                        accept_value(std::nullopt);
                     }
                     break;
                 case column_kind::regular_column:
@@ -83,24 +113,24 @@ class result_generator {
                     break;
                 }
             }
-            _visitor.end_row();
+            end_row();
         }
 
         void accept_partition_end(const query::result_row_view& static_row) {
             if (_partition_row_count == 0) {
                 _total_row_count++;
-                _visitor.start_row();
+                start_row();
                 auto static_row_iterator = static_row.iterator();
                 for (auto&& def : _selection.get_columns()) {
                     if (def->is_partition_key()) {
-                        _visitor.accept_value(bytes_view(_partition_key[def->component_index()]));
+                        accept_value(bytes_view(_partition_key[def->component_index()]));
                     } else if (def->is_static()) {
                         accept_cell_value(*def, static_row_iterator);
                     } else {
-                        _visitor.accept_value(std::nullopt);
+                        accept_value(std::nullopt);
                     }
                 }
-                _visitor.end_row();
+                end_row();
             }
         }
 
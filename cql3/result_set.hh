@@ -174,6 +174,36 @@ class result_set {
         std::sort(_rows.begin(), _rows.end(), cmp);
     }
 
+    // Adds a row to a result set which holds only the least `limit` rows
+    // according to cmp. The rows are kept as a heap, with the greatest one on
+    // top, so a row which wouldn't make it into the result is rejected after
+    // a single comparison. sort_heap() must be called once all rows are added.
+    template<typename RowComparator>
+    requires requires (RowComparator cmp, const row_type& row) {
+        { cmp(row, row) } -> std::same_as<bool>;
+    }
+    void add_row_to_heap(row_type row, const RowComparator& cmp, size_t limit) {
+        if (_rows.size() >= limit) {
+            if (limit == 0 || !cmp(row, _rows.front())) {
+                return;
+            }
+            std::pop_heap(_rows.begin(), _rows.end(), cmp);
+            _rows.back() = std::move(row);
+        } else {
+            _rows.emplace_back(std::move(row));
+        }
+        std::push_heap(_rows.begin(), _rows.end(), cmp);
+    }
+
+    // Sorts the rows added by add_row_to_heap().
+    template<typename RowComparator>
+    requires requires (RowComparator cmp, const row_type& row) {
+        { cmp(row, row) } -> std::same_as<bool>;
+    }
+    void sort_heap(const RowComparator& cmp) {
+        std::sort_heap(_rows.begin(), _rows.end(), cmp);
+    }
+
     metadata& get_metadata();
 
     const metadata& get_metadata() const;
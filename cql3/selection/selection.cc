@@ -193,9 +193,13 @@ contains_ttl(const expr::expression& e) {
 class selection_with_processing : public selection {
 private:
     std::vector<expr::expression> _selectors;
+    // Selectors past this one were added by add_column_for_post_processing().
+    size_t _post_processing_selectors_start;
     std::vector<expr::expression> _inner_loop;
     std::vector<expr::expression> _outer_loop;
     std::vector<raw_value> _initial_values_for_temporaries;
+    // Set if all the selectors are columns, see get_simple_projection().
+    std::optional<std::vector<uint32_t>> _simple_projection;
 public:
     selection_with_processing(schema_ptr schema, std::vector<const column_definition*> columns,
             std::vector<lw_shared_ptr<column_specification>> metadata,
@@ -204,11 +208,21 @@ class selection_with_processing : public selection {
             contains_writetime(expr::tuple_constructor{selectors}),
             contains_ttl(expr::tuple_constructor{selectors}))
         , _selectors(std::move(selectors))
+        , _post_processing_selectors_start(_selectors.size())
     {
         auto agg_split = expr::split_aggregation(_selectors);
         _outer_loop = std::move(agg_split.outer_loop);
         _inner_loop = std::move(agg_split.inner_loop);
         _initial_values_for_temporaries = std::move(agg_split.initial_values_for_temporaries);
+        if (std::ranges::all_of(_selectors, [] (const expr::expression& e) { return expr::is<expr::column_value>(e); })) {
+            _simple_projection = _selectors | std::views::transform([this] (const expr::expression& e) {
+                return uint32_t(index_of(*expr::as<expr::column_value>(e).col));
+            }) | std::ranges::to<std::vector>();
+        }
+    }
+
+    virtual const std::vector<uint32_t>* get_simple_projection() const override {
+        return _simple_projection ? &*_simple_projection : nullptr;
     }
 
     virtual uint32_t add_column_for_post_processing(const column_definition& c) override {
@@ -245,18 +259,45 @@ class selection_with_processing : public selection {
         return !_inner_loop.empty();
     }
 
+    // Whether the i-th selector only retrieves a column for filtering, which
+    // isn't sent to the client.
+    bool is_filtering_column(size_t i) const {
+        return i >= _post_processing_selectors_start && expr::is<expr::column_value>(_selectors[i]);
+    }
+
     virtual bool is_count() const override {
-        return _selectors.size() == 1
+        // Columns retrieved only for filtering don't change what's counted.
+        return _post_processing_selectors_start == 1
+            && std::ranges::all_of(std::views::iota(size_t(1), _selectors.size()), [this] (size_t i) { return is_filtering_column(i); })
             && expr::find_in_expression<expr::function_call>(_selectors[0], [] (const expr::function_call& fc) {
                 auto& func = std::get<shared_ptr<cql3::functions::function>>(fc.func);
                 return func->name() == functions::function_name::native_function(functions::aggregate_fcts::COUNT_ROWS_FUNCTION_NAME);
             });
     }
 
-    virtual bool is_reducible() const override {
+    // Position, among the grouping columns, of the column selected by a selector
+    // which selects nothing else.
+    std::optional<size_t> group_by_position(const expr::expression& e, const std::vector<size_t>& group_by_cell_indices) const {
+        auto col = expr::as_if<expr::column_value>(&e);
+        if (!col) {
+            return std::nullopt;
+        }
+        auto it = std::ranges::find(group_by_cell_indices, size_t(index_of(*col->col)));
+        if (it == group_by_cell_indices.end()) {
+            return std::nullopt;
+        }
+        return it - group_by_cell_indices.begin();
+    }
+
+    virtual bool is_reducible(const std::vector<size_t>& group_by_cell_indices) const override {
         return std::ranges::all_of(
-                _selectors,
-               [] (const expr::expression& e) {
+                std::views::iota(size_t(0), _selectors.size()),
+               [&] (size_t i) {
+                    const auto& e = _selectors[i];
+                    // Grouping columns are the same for all rows of a group.
+                    if (group_by_position(e, group_by_cell_indices) || is_filtering_column(i)) {
+                        return true;
+                    }
                     auto fc = expr::as_if<expr::function_call>(&e);
                     if (!fc) {
                         return false;
@@ -278,13 +319,25 @@ class selection_with_processing : public selection {
         );
     }
 
-    virtual query::mapreduce_request::reductions_info get_reductions() const override {
+    virtual query::mapreduce_request::reductions_info get_reductions(const std::vector<size_t>& group_by_cell_indices) const override {
         std::vector<query::mapreduce_request::reduction_type> types;
         std::vector<query::mapreduce_request::aggregation_info> infos;
+        std::vector<std::optional<size_t>> selector_positions;
         auto bad = [] {
             throw std::runtime_error("Selection doesn't have a reduction");
         };
-        for (const auto& e : _selectors) {
+        for (size_t i = 0; i < _selectors.size(); i++) {
+            const auto& e = _selectors[i];
+            // Grouped results hold the grouping columns, followed by the reductions.
+            if (auto pos = group_by_position(e, group_by_cell_indices)) {
+                selector_positions.push_back(*pos);
+                continue;
+            }
+            if (is_filtering_column(i)) {
+                selector_positions.push_back(std::nullopt);
+                continue;
+            }
+            selector_positions.push_back(group_by_cell_indices.size() + types.size());
             auto fc = expr::as_if<expr::function_call>(&e);
             if (!fc) {
                 bad();
@@ -314,7 +367,7 @@ class selection_with_processing : public selection {
             types.push_back(type);
             infos.push_back(std::move(info));
         }
-        return {types, infos};
+        return {types, infos, selector_positions};
     }
 
     virtual std::vector<shared_ptr<functions::function>> used_functions() const override {
@@ -586,6 +639,25 @@ bool result_set_builder::last_group_ended() const {
             _group_by_cell_indices | std::views::reverse | std::views::transform([this](size_t i) { return current[i]; }));
 }
 
+void result_set_builder::add_output_row(std::vector<managed_bytes_opt> row) {
+    if (_top_n_comparator) {
+        _result_set->add_row_to_heap(std::move(row), _top_n_comparator, _top_n_limit);
+    } else {
+        _result_set->add_row(std::move(row));
+    }
+}
+
+void result_set_builder::keep_top_n(row_comparator cmp, bool reversed, uint64_t limit) {
+    SCYLLA_ASSERT(_result_set->empty());
+    if (reversed) {
+        cmp = [cmp = std::move(cmp)] (const std::vector<managed_bytes_opt>& r1, const std::vector<managed_bytes_opt>& r2) {
+            return cmp(r2, r1);
+        };
+    }
+    _top_n_comparator = std::move(cmp);
+    _top_n_limit = limit;
+}
+
 void result_set_builder::flush_selectors() {
     if (!_selectors->is_aggregate()) {
         // handled by process_current_row
@@ -596,7 +668,7 @@ void result_set_builder::flush_selectors() {
     }
     if (_result_set->size() < _limit) {
         if (_per_partition_remaining > 0) {
-            _result_set->add_row(_selectors->get_output_row());
+            add_output_row(_selectors->get_output_row());
             --_per_partition_remaining;
         }
         _selectors->reset();
@@ -606,7 +678,7 @@ void result_set_builder::flush_selectors() {
 void result_set_builder::complete_row() {
     if (!_selectors->is_aggregate()) {
         // Fast path when not aggregating
-        _result_set->add_row(_selectors->transform_input_row(*this));
+        add_output_row(_selectors->transform_input_row(*this));
         return;
     }
     if (last_group_ended()) {
@@ -684,6 +756,9 @@ std::unique_ptr<result_set> result_set_builder::build() {
     if (_result_set->empty() && _selectors->is_aggregate() && _group_by_cell_indices.empty()) {
         _result_set->add_row(_selectors->get_output_row());
     }
+    if (_top_n_comparator) {
+        _result_set->sort_heap(_top_n_comparator);
+    }
     return std::move(_result_set);
 }
 
@@ -696,8 +771,8 @@ result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<const
         uint64_t rows_fetched_for_last_partition)
     : _restrictions(restrictions)
     , _options(options)
-    , _partition_level_filter(_restrictions->get_partition_level_filter())
-    , _clustering_row_level_filter(_restrictions->get_clustering_row_level_filter())
+    , _partition_level_filter(_restrictions->get_compiled_partition_level_filter())
+    , _clustering_row_level_filter(_restrictions->get_compiled_clustering_row_level_filter())
     , _remaining(remaining)
     , _schema(schema)
     , _per_partition_limit(per_partition_limit)
@@ -706,6 +781,13 @@ result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<const
     , _last_pkey(std::move(last_pkey))
 { }
 
+void result_set_builder::restrictions_filter::bind_filters(const selection& selection) const {
+    if (!_bound_partition_level_filter) {
+        _bound_partition_level_filter.emplace(_partition_level_filter.bind(selection, _options));
+        _bound_clustering_row_level_filter.emplace(_clustering_row_level_filter.bind(selection, _options));
+    }
+}
+
 bool result_set_builder::restrictions_filter::do_filter(const selection& selection,
                                                          const std::vector<bytes>& partition_key,
                                                          const std::vector<bytes>& clustering_key,
@@ -718,29 +800,22 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
     }
 
     auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
+    auto inputs = expr::evaluation_inputs{
+        .partition_key = partition_key,
+        .clustering_key = clustering_key,
+        .static_and_regular_columns = static_and_regular_columns,
+        .selection = &selection,
+        .options = &_options,
+    };
 
-    if (!expr::is_satisfied_by(
-                    _partition_level_filter,
-                    expr::evaluation_inputs{
-                        .partition_key = partition_key,
-                        .clustering_key = clustering_key,
-                        .static_and_regular_columns = static_and_regular_columns,
-                        .selection = &selection,
-                        .options = &_options,
-                    })) {
+    bind_filters(selection);
+
+    if (!_bound_partition_level_filter->is_satisfied_by(inputs)) {
         _current_partition_does_not_match = true;
         return false;
     }
 
-    if (!expr::is_satisfied_by(
-                    _clustering_row_level_filter,
-                    expr::evaluation_inputs{
-                        .partition_key = partition_key,
-                        .clustering_key = clustering_key,
-                        .static_and_regular_columns = static_and_regular_columns,
-                        .selection = &selection,
-                        .options = &_options,
-                    })) {
+    if (!_bound_clustering_row_level_filter->is_satisfied_by(inputs)) {
         return false;
     }
 
@@ -766,6 +841,61 @@ bool result_set_builder::restrictions_filter::operator()(const selection& select
     return accepted;
 }
 
+void result_set_builder::restrictions_filter::filter_batch(const selection& selection,
+                                                           const std::vector<bytes>& partition_key,
+                                                           std::span<const std::vector<bytes>> clustering_keys,
+                                                           const query::result_row_view& static_row,
+                                                           std::span<const query::result_row_view> rows,
+                                                           boost::dynamic_bitset<>& accepted) const {
+    auto drop_all = [&] {
+        _rows_dropped += accepted.count();
+        accepted.reset();
+    };
+    if (_current_partition_does_not_match || _remaining == 0 || _per_partition_remaining == 0) {
+        drop_all();
+        return;
+    }
+
+    std::vector<std::vector<managed_bytes_opt>> static_and_regular_columns;
+    static_and_regular_columns.reserve(rows.size());
+    std::vector<expr::evaluation_inputs> inputs;
+    inputs.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        static_and_regular_columns.push_back(expr::get_non_pk_values(selection, static_row, &rows[i]));
+        inputs.push_back(expr::evaluation_inputs{
+            .partition_key = partition_key,
+            .clustering_key = clustering_keys[i],
+            .static_and_regular_columns = static_and_regular_columns.back(),
+            .selection = &selection,
+            .options = &_options,
+        });
+    }
+
+    bind_filters(selection);
+
+    // The partition level filter only depends on the partition key and on
+    // static columns, so it's the same for all rows of the partition.
+    if (!_bound_partition_level_filter->is_satisfied_by(inputs.front())) {
+        _current_partition_does_not_match = true;
+        drop_all();
+        return;
+    }
+
+    _bound_clustering_row_level_filter->filter_batch(inputs, accepted);
+
+    // Apply the limits to the accepted rows, in order.
+    _rows_dropped += rows.size() - accepted.count();
+    for (auto i = accepted.find_first(); i != boost::dynamic_bitset<>::npos; i = accepted.find_next(i)) {
+        if (_remaining == 0 || _per_partition_remaining == 0) {
+            accepted.reset(i);
+            ++_rows_dropped;
+            continue;
+        }
+        --_remaining;
+        --_per_partition_remaining;
+    }
+}
+
 void result_set_builder::restrictions_filter::reset(const partition_key* key) {
     _current_partition_does_not_match = false;
     _rows_dropped = 0;
@@ -16,9 +16,11 @@
 #include "query-result-reader.hh"
 #include "selector.hh"
 #include "cql3/column_specification.hh"
+#include "cql3/expr/compiled_filter.hh"
 #include "cql3/functions/function.hh"
 #include "exceptions/exceptions.hh"
 #include "unimplemented.hh"
+#include <boost/dynamic_bitset.hpp>
 #include <seastar/core/thread.hh>
 
 namespace cql3 {
@@ -155,9 +157,11 @@ class selection {
 
     virtual bool is_count() const {return false;}
 
-    virtual bool is_reducible() const {return false;}
+    // Whether the selection can be computed by mapreduce_service. With GROUP BY,
+    // selectors may also select grouping columns (by their index in the selection).
+    virtual bool is_reducible(const std::vector<size_t>& group_by_cell_indices) const {return false;}
 
-    virtual query::mapreduce_request::reductions_info get_reductions() const {return {{}, {}};}
+    virtual query::mapreduce_request::reductions_info get_reductions(const std::vector<size_t>& group_by_cell_indices) const {return {{}, {}, {}};}
 
     /**
      * Returns true if the selection is trivial, i.e. there are no function
@@ -165,6 +169,20 @@ class selection {
      */
     bool is_trivial() const { return _is_trivial; }
 
+    /**
+     * If each output column of the selection is a column of the table, with
+     * no function applied to it, returns the index in get_columns() of each
+     * of them. Returns nullptr otherwise, and for trivial selections, whose
+     * output columns are get_columns().
+     */
+    virtual const std::vector<uint32_t>* get_simple_projection() const { return nullptr; }
+
+    /**
+     * Returns true if the rows of the result can be written straight from
+     * query::result (see result_generator), without building a result_set.
+     */
+    bool is_simple_projection() const { return _is_trivial || get_simple_projection(); }
+
     friend class result_set_builder;
 };
 
@@ -183,6 +201,9 @@ class result_set_builder {
                                                           ///< but accept_partition_end() and accept_new_partition() will be called anyway.
     std::vector<managed_bytes_opt> _last_group; ///< Previous row's group: all of GROUP BY column values.
     bool _group_began; ///< Whether a group began being formed.
+    using row_comparator = std::function<bool(const std::vector<managed_bytes_opt>&, const std::vector<managed_bytes_opt>&)>;
+    row_comparator _top_n_comparator; ///< Order of the rows kept by keep_top_n(), if called.
+    uint64_t _top_n_limit = 0; ///< Number of rows kept by keep_top_n().
 public:
     std::vector<managed_bytes_opt> current;
     std::vector<bytes> current_partition_key;
@@ -216,8 +237,11 @@ class result_set_builder {
     class restrictions_filter {
         const ::shared_ptr<const restrictions::statement_restrictions> _restrictions;
         const query_options& _options;
-        const expr::expression& _partition_level_filter;
-        const expr::expression& _clustering_row_level_filter;
+        const expr::compiled_filter& _partition_level_filter;
+        const expr::compiled_filter& _clustering_row_level_filter;
+        // The filters, bound to the selection and options on the first row.
+        mutable std::optional<expr::compiled_filter::bound> _bound_partition_level_filter;
+        mutable std::optional<expr::compiled_filter::bound> _bound_clustering_row_level_filter;
         mutable bool _current_partition_does_not_match = false;
         mutable uint64_t _rows_dropped = 0;
         mutable uint64_t _remaining;
@@ -235,12 +259,21 @@ class result_set_builder {
                 uint64_t per_partition_limit,
                 std::optional<partition_key> last_pkey = {},
                 uint64_t rows_fetched_for_last_partition = 0);
+        // Rows of a partition are filtered in batches of up to this many rows.
+        static constexpr size_t batch_size = 256;
+
         bool operator()(const selection& selection, const std::vector<bytes>& pk, const std::vector<bytes>& ck, const query::result_row_view& static_row, const query::result_row_view* row) const;
+        // Filters a batch of rows of the current partition. Equivalent to calling
+        // operator() on each of the rows in order. Bits of rows which aren't
+        // accepted are cleared in \p accepted.
+        void filter_batch(const selection& selection, const std::vector<bytes>& pk, std::span<const std::vector<bytes>> cks,
+                const query::result_row_view& static_row, std::span<const query::result_row_view> rows, boost::dynamic_bitset<>& accepted) const;
         void reset(const partition_key* key = nullptr);
         uint64_t get_rows_dropped() const {
             return _rows_dropped;
         }
     private:
+        void bind_filters(const selection& selection) const;
         bool do_filter(const selection& selection, const std::vector<bytes>& pk, const std::vector<bytes>& ck, const query::result_row_view& static_row, const query::result_row_view* row) const;
     };
 
@@ -258,6 +291,11 @@ class result_set_builder {
     void accept_new_partition(const std::vector<bytes>& key);
     void accept_partition_end();
     std::unique_ptr<result_set> build();
+    /// Keeps only the first \c limit rows in the order of \c cmp (or in the
+    /// reverse order, if \c reversed) instead of all the rows, and has build()
+    /// return them sorted in this order. Used for ORDER BY with LIMIT, which
+    /// would otherwise keep all the rows until they are sorted.
+    void keep_top_n(row_comparator cmp, bool reversed, uint64_t limit);
     api::timestamp_type timestamp_of(size_t idx);
     int32_t ttl_of(size_t idx);
     size_t result_set_size() const;
@@ -273,6 +311,13 @@ class result_set_builder {
         std::vector<bytes>& _partition_key;
         std::vector<bytes>& _clustering_key;
         Filter _filter;
+
+        // Filters which can evaluate many rows at once get the rows of a
+        // partition in batches.
+        static constexpr bool batched = requires { Filter::batch_size; };
+        std::vector<std::vector<bytes>> _batch_clustering_keys;
+        std::vector<query::result_row_view> _batch_rows;
+        std::optional<query::result_row_view> _batch_static_row;
     public:
         visitor(cql3::selection::result_set_builder& builder, const schema& s,
                 const selection& selection, Filter filter = Filter())
@@ -318,16 +363,55 @@ class result_set_builder {
         }
 
         void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row) {
+            if constexpr (batched) {
+                buffer_row(key.explode(_schema), static_row, row);
+                return;
+            }
             _clustering_key = key.explode(_schema);
             accept_new_row(static_row, row);
         }
 
         void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {
-            auto static_row_iterator = static_row.iterator();
-            auto row_iterator = row.iterator();
+            if constexpr (batched) {
+                buffer_row(_clustering_key, static_row, row);
+                return;
+            }
             if (!_filter(_selection, _partition_key, _clustering_key, static_row, &row)) {
                 return;
             }
+            add_row(static_row, row);
+        }
+
+    private:
+        void buffer_row(std::vector<bytes> clustering_key, const query::result_row_view& static_row, const query::result_row_view& row) {
+            _batch_clustering_keys.push_back(std::move(clustering_key));
+            _batch_rows.push_back(row);
+            _batch_static_row.emplace(static_row);
+            if (_batch_rows.size() >= Filter::batch_size) {
+                flush_batch();
+            }
+        }
+
+        void flush_batch() {
+            if (_batch_rows.empty()) {
+                return;
+            }
+            boost::dynamic_bitset<> accepted(_batch_rows.size());
+            accepted.set();
+            _filter.filter_batch(_selection, _partition_key, _batch_clustering_keys, *_batch_static_row, _batch_rows, accepted);
+            auto last_clustering_key = _batch_clustering_keys.back();
+            for (auto i = accepted.find_first(); i != boost::dynamic_bitset<>::npos; i = accepted.find_next(i)) {
+                _clustering_key = std::move(_batch_clustering_keys[i]);
+                add_row(*_batch_static_row, _batch_rows[i]);
+            }
+            _clustering_key = std::move(last_clustering_key);
+            _batch_clustering_keys.clear();
+            _batch_rows.clear();
+        }
+
+        void add_row(const query::result_row_view& static_row, const query::result_row_view& row) {
+            auto static_row_iterator = static_row.iterator();
+            auto row_iterator = row.iterator();
             _builder.start_new_row();
             for (auto&& def : _selection.get_columns()) {
                 switch (def->kind) {
@@ -354,7 +438,11 @@ class result_set_builder {
             _builder.complete_row();
         }
 
+    public:
         uint64_t accept_partition_end(const query::result_row_view& static_row) {
+            if constexpr (batched) {
+                flush_batch();
+            }
             if (_row_count == 0) {
                 if (!_filter(_selection, _partition_key, _clustering_key, static_row, nullptr)) {
                     return _filter.get_rows_dropped();
@@ -389,6 +477,9 @@ class result_set_builder {
 
     /// Updates _last_group from the \c current row.
     void update_last_group();
+
+    /// Adds an output row to the result set, or to its top N if keep_top_n() was called.
+    void add_output_row(std::vector<managed_bytes_opt> row);
 };
 
 }
@@ -504,14 +504,28 @@ select_statement::execute_without_checking_exception_message_aggregate_or_paged(
     auto timeout = db::timeout_clock::now() + timeout_duration;
     auto p = service::pager::query_pagers::pager(qp.proxy(), _query_schema, _selection,
             state, options, command, std::move(key_ranges), _restrictions_need_filtering ? _restrictions : nullptr, std::move(cas_shard));
+    // With ORDER BY and IN on the partition key, the first `limit` rows which
+    // match the filter may not be the first in the requested order. Each
+    // partition returns its rows in this order, so it has to contribute at
+    // most `limit` of them, and only the best `limit` of those are kept.
+    // The filter is applied by the pager, so this is where the limit goes;
+    // the replicas return rows before filtering and can't apply it.
+    const bool top_n = nonpaged_filtering && !aggregate && needs_post_query_ordering();
+    if (top_n) {
+        p->apply_row_limit_per_partition();
+    }
 
     auto per_partition_limit = get_limit(options, _per_partition_limit, true);
 
     if (aggregate || nonpaged_filtering) {
         auto builder = cql3::selection::result_set_builder(*_selection, now, &options, *_group_by_cell_indices, limit, per_partition_limit);
+        if (top_n) {
+            builder.keep_top_n(_ordering_comparator, _is_reversed, limit);
+        }
         coordinator_result<void> result_void = co_await utils::result_do_until(
-                [&p, &builder, limit] {
-                    return p->is_exhausted() || (limit < builder.result_set_size());
+                [&p, &builder, limit, top_n] {
+                    // The top N rows are known only once all partitions are read.
+                    return p->is_exhausted() || (!top_n && limit < builder.result_set_size());
                 },
                 [&p, &builder, page_size, now, timeout] {
                     return p->fetch_page_result(builder, page_size, now, timeout);
@@ -538,7 +552,7 @@ select_statement::execute_without_checking_exception_message_aggregate_or_paged(
                         " you must either remove the ORDER BY or the IN and sort client side, or disable paging for this query");
     }
 
-    if (_selection->is_trivial() && !_restrictions_need_filtering && !_per_partition_limit) {
+    if (_selection->is_simple_projection() && !_restrictions_need_filtering && !_per_partition_limit) {
         coordinator_result<result_generator> result_gen = co_await p->fetch_page_generator_result(page_size, now, timeout, _stats);
         if (result_gen.has_error()) {
             co_return failed_result_to_result_message(std::move(result_gen));
@@ -911,7 +925,7 @@ select_statement::process_results(foreign_ptr<lw_shared_ptr<query::result>> resu
                                   const query_options& options,
                                   gc_clock::time_point now) const
 {
-    const bool fast_path = !needs_post_query_ordering() && _selection->is_trivial() && !_restrictions_need_filtering;
+    const bool fast_path = !needs_post_query_ordering() && _selection->is_simple_projection() && !_restrictions_need_filtering;
     if (fast_path) {
         return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(make_shared<cql_transport::messages::result_message::rows>(result(
             result_generator(_query_schema, std::move(results), std::move(cmd), _selection, _stats),
@@ -927,6 +941,9 @@ select_statement::process_results_complex(foreign_ptr<lw_shared_ptr<query::resul
                                   const query_options& options,
                                   gc_clock::time_point now) const {
     cql3::selection::result_set_builder builder(*_selection, now, &options);
+    if (needs_post_query_ordering()) {
+        builder.keep_top_n(_ordering_comparator, _is_reversed, cmd->get_row_limit());
+    }
     co_return co_await builder.with_thread_if_needed([&] {
         if (_restrictions_need_filtering) {
             results->ensure_counts();
@@ -940,14 +957,6 @@ select_statement::process_results_complex(foreign_ptr<lw_shared_ptr<query::resul
                             *_selection));
         }
         auto rs = builder.build();
-
-        if (needs_post_query_ordering()) {
-            rs->sort(_ordering_comparator);
-            if (_is_reversed) {
-                rs->reverse();
-            }
-            rs->trim(cmd->get_row_limit());
-        }
         update_stats_rows_read(rs->size());
         _stats.filtered_rows_matched_total += _restrictions_need_filtering ? rs->size() : 0;
         return shared_ptr<cql_transport::messages::result_message>(::make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs))));
@@ -1711,6 +1720,49 @@ parallelized_select_statement::parallelized_select_statement(
 ) {
 }
 
+// Whether the restrictions needing filtering can be sent to the shards computing the
+// reductions by make_mapreduce_filter(): each of them has to compare a single column,
+// possibly subscripted, with a value which doesn't depend on the row.
+static bool can_make_mapreduce_filter(const expr::expression& where) {
+    auto references_columns = [] (const expr::expression& e) {
+        return expr::find_in_expression<expr::column_value>(e, [] (const expr::column_value&) { return true; }) != nullptr;
+    };
+    return std::ranges::all_of(expr::boolean_factors(where), [&] (const expr::expression& e) {
+        auto binop = expr::as_if<expr::binary_operator>(&e);
+        if (!binop || binop->order != expr::comparison_order::cql || references_columns(binop->rhs)) {
+            return false;
+        }
+        if (auto sub = expr::as_if<expr::subscript>(&binop->lhs)) {
+            return expr::is<expr::column_value>(sub->val) && !references_columns(sub->sub);
+        }
+        return expr::is<expr::column_value>(binop->lhs);
+    });
+}
+
+static std::vector<query::mapreduce_request::filter_restriction> make_mapreduce_filter(const expr::expression& where, const query_options& options) {
+    std::vector<query::mapreduce_request::filter_restriction> filter;
+    for (const auto& e : expr::boolean_factors(where)) {
+        const auto& binop = expr::as<expr::binary_operator>(e);
+        const expr::expression* column = &binop.lhs;
+        std::optional<bytes> subscript;
+        if (auto sub = expr::as_if<expr::subscript>(column)) {
+            subscript = to_bytes_opt(expr::evaluate(sub->sub, options));
+            if (!subscript) {
+                throw exceptions::invalid_request_exception(format("Invalid null value in condition for column {}", expr::get_subscripted_column(*sub).col->name_as_text()));
+            }
+            column = &sub->val;
+        }
+        filter.push_back(query::mapreduce_request::filter_restriction{
+            .column_name = expr::as<expr::column_value>(*column).col->name_as_text(),
+            .subscript = std::move(subscript),
+            .op = static_cast<uint8_t>(binop.op),
+            .value = to_bytes_opt(expr::evaluate(binop.rhs, options)),
+            .value_type = expr::type_of(binop.rhs)->name(),
+        });
+    }
+    return filter;
+}
+
 future<::shared_ptr<cql_transport::messages::result_message>>
 parallelized_select_statement::do_execute(
     query_processor& qp,
@@ -1760,7 +1812,7 @@ parallelized_select_statement::do_execute(
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
     auto timeout_duration = get_timeout(state.get_client_state(), options);
     auto timeout = lowres_system_clock::now() + timeout_duration;
-    auto reductions = _selection->get_reductions();
+    auto reductions = _selection->get_reductions(*_group_by_cell_indices);
 
     query::mapreduce_request req = {
         .reduction_types = reductions.types,
@@ -1770,14 +1822,52 @@ parallelized_select_statement::do_execute(
         .timeout = timeout,
         .aggregation_infos = reductions.infos,
     };
+    if (has_group_by()) {
+        req.group_by = query::mapreduce_request::group_by_info{
+            .column_names = *_group_by_cell_indices | std::views::transform([this] (size_t idx) {
+                return _selection->get_columns()[idx]->name_as_text();
+            }) | std::ranges::to<std::vector<sstring>>(),
+            .max_groups = qp.db().get_config().parallelized_aggregation_max_groups(),
+        };
+    }
+    if (_restrictions_need_filtering) {
+        // Shards computing the reductions filter the rows they read, so the
+        // restrictions are sent along, evaluated with the options of this execution.
+        req.filter = make_mapreduce_filter(*_restrictions->get_where_clause(), options);
+    }
 
     // dispatch execution of this statement to other nodes
-    return qp.mapreduce(req, state.get_trace_state()).then([this] (query::mapreduce_result res) {
+    return qp.mapreduce(req, state.get_trace_state()).then([this, &qp, &state, &options, selector_positions = std::move(reductions.selector_positions)] (query::mapreduce_result res) {
+        if (res.group_limit_exceeded) {
+            // Too many groups to be gathered at once, fall back to paging through the
+            // rows on this coordinator, which isn't bounded by the number of groups.
+            tracing::trace(state.get_trace_state(), "Too many groups for a parallelized aggregation, falling back to a regular one");
+            _stats.select_parallelized_fallbacks += 1;
+            return select_statement::do_execute(qp, state, options);
+        }
+        if (res.grouped_query_results && options.get_page_size() > 0 && res.grouped_query_results->size() > size_t(options.get_page_size())) {
+            // The groups are gathered at once and can't be resumed from a
+            // paging state, so leave the paging to the regular path.
+            tracing::trace(state.get_trace_state(), "Groups of a parallelized aggregation don't fit in a page, falling back to a regular one");
+            _stats.select_parallelized_fallbacks += 1;
+            return select_statement::do_execute(qp, state, options);
+        }
         auto meta = _selection->get_result_metadata();
         auto rs = std::make_unique<result_set>(std::move(meta));
-        rs->add_row(res.query_results);
+        auto make_row = [&selector_positions] (const std::vector<bytes_opt>& values) {
+            return selector_positions | std::views::transform([&values] (const std::optional<size_t>& pos) {
+                return pos ? values[*pos] : bytes_opt();
+            }) | std::ranges::to<std::vector<bytes_opt>>();
+        };
+        if (res.grouped_query_results) {
+            for (auto& group : *res.grouped_query_results) {
+                rs->add_row(make_row(group));
+            }
+        } else {
+            rs->add_row(make_row(res.query_results));
+        }
         update_stats_rows_read(rs->size());
-        return shared_ptr<cql_transport::messages::result_message>(
+        return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(
             make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)))
         );
     });
@@ -1943,7 +2033,7 @@ mutation_fragments_select_statement::do_execute(query_processor& qp, service::qu
                 return do_query(std::move(erm_keepalive), this_node, sp, std::move(schema), std::move(cmd), std::move(partition_ranges), cl, std::move(optional_params));
             });
 
-    if (_selection->is_trivial() && !_restrictions_need_filtering && !_per_partition_limit) {
+    if (_selection->is_simple_projection() && !_restrictions_need_filtering && !_per_partition_limit) {
         return p->fetch_page_generator_result(page_size, now, timeout, _stats).then(wrap_result_to_error_message([this, p = std::move(p)] (result_generator&& generator) {
             auto meta = [&] () -> shared_ptr<const cql3::metadata> {
                 if (!p->is_exhausted()) {
@@ -2165,20 +2255,27 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
     auto prepared_attrs = _attrs->prepare(db, keyspace(), column_family());
     prepared_attrs->fill_prepare_context(ctx);
 
-    auto all_aggregates = [] (const std::vector<selection::prepared_selector>& prepared_selectors) {
+    auto is_aggregate = [] (const expr::expression& e) {
+        auto fn_expr = expr::as_if<expr::function_call>(&e);
+        if (!fn_expr) {
+            return false;
+        }
+        auto func = std::get_if<shared_ptr<functions::function>>(&fn_expr->func);
+        if (!func) {
+            return false;
+        }
+        return (*func)->is_aggregate();
+    };
+    auto all_aggregates = [&] (const std::vector<selection::prepared_selector>& prepared_selectors) {
         return std::ranges::all_of(
             prepared_selectors | std::views::transform(std::mem_fn(&selection::prepared_selector::expr)),
-            [] (const expr::expression& e) {
-                auto fn_expr = expr::as_if<expr::function_call>(&e);
-                if (!fn_expr) {
-                    return false;
-                }
-                auto func = std::get_if<shared_ptr<functions::function>>(&fn_expr->func);
-                if (!func) {
-                    return false;
-                }
-                return (*func)->is_aggregate();
-            }
+            is_aggregate
+        );
+    };
+    auto any_aggregate = [&] (const std::vector<selection::prepared_selector>& prepared_selectors) {
+        return std::ranges::any_of(
+            prepared_selectors | std::views::transform(std::mem_fn(&selection::prepared_selector::expr)),
+            is_aggregate
         );
     };
 
@@ -2188,15 +2285,44 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
 
     // Used to determine if an execution of this statement can be parallelized
     // using `mapreduce_service`.
-    auto can_be_mapreduced = [&] {
+    auto can_be_mapreduced_without_group_by = [&] {
         return all_aggregates(prepared_selectors)   // Note: before we levellized aggregation depth
             && ( // SUPPORTED PARALLELIZATION
                  // All potential intermediate coordinators must support mapreduceing
                 (db.features().parallelized_aggregation && selection->is_count())
-                || (db.features().uda_native_parallelized_aggregation && selection->is_reducible())
-            )
-            && !restrictions->need_filtering()  // No filtering
-            && group_by_cell_indices->empty()   // No GROUP BY
+                || (db.features().uda_native_parallelized_aggregation && selection->is_reducible(*group_by_cell_indices))
+            );
+    };
+    // Groups are merged in any order and sorted back into ring order on the
+    // coordinator, so limits and non-default orderings are left to the
+    // regular path. Sorting needs the partition key of each group, so the
+    // partition key columns may not be omitted from GROUP BY, even if they
+    // are restricted.
+    auto groups_by_partition_key = [&] {
+        return group_by_cell_indices->size() >= schema->partition_key_size()
+            && std::ranges::all_of(*group_by_cell_indices | std::views::take(schema->partition_key_size()), [&] (size_t idx) {
+                return selection->get_columns()[idx]->is_partition_key();
+            });
+    };
+    auto can_be_mapreduced_with_group_by = [&] {
+        return any_aggregate(prepared_selectors)
+            && db.features().parallelized_group_by
+            && groups_by_partition_key()
+            && selection->is_reducible(*group_by_cell_indices)
+            && !_parameters->is_distinct()
+            && !is_reversed_
+            && !ordering_comparator
+            && !_limit
+            && !_per_partition_limit;
+    };
+    auto can_be_mapreduced_with_filtering = [&] {
+        return db.features().parallelized_aggregation_filtering
+            && restrictions->get_where_clause()
+            && can_make_mapreduce_filter(*restrictions->get_where_clause());
+    };
+    auto can_be_mapreduced = [&] {
+        return (group_by_cell_indices->empty() ? can_be_mapreduced_without_group_by() : can_be_mapreduced_with_group_by())
+            && (!restrictions->need_filtering() || can_be_mapreduced_with_filtering())
             && db.get_config().enable_parallelized_aggregation()
             && !is_local_table()
             && !( // Do not parallelize the request if it's single partition read
@@ -16,6 +16,7 @@
 #include <seastar/core/metrics.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/with_scheduling_group.hh>
 
 #include "batchlog_manager.hh"
 #include "mutation/canonical_mutation.hh"
@@ -46,6 +47,8 @@ db::batchlog_manager::batchlog_manager(cql3::query_processor& qp, db::system_key
         , _replay_rate(config.replay_rate)
         , _delay(config.delay)
         , _replay_cleanup_after_replays(config.replay_cleanup_after_replays)
+        , _replay_concurrency(std::max(config.replay_concurrency, 1u))
+        , _replay_sched_group(config.replay_sched_group)
         , _gate("batchlog_manager")
         , _loop_done(batchlog_replay_loop())
 {
@@ -55,6 +58,12 @@ db::batchlog_manager::batchlog_manager(cql3::query_processor& qp, db::system_key
         sm::make_counter("total_write_replay_attempts", _stats.write_attempts,
                         sm::description("Counts write operations issued in a batchlog replay flow. "
                                         "The high value of this metric indicates that we have a long batch replay list.")),
+        sm::make_counter("total_replayed_batches", _stats.replayed_batches,
+                        sm::description("Counts batches replayed and removed from the batchlog.")),
+        sm::make_counter("total_failed_batch_replays", _stats.failed_batch_replays,
+                        sm::description("Counts batch replays which failed. The batches remain in the batchlog and are retried in the next replay.")),
+        sm::make_gauge("replay_batches_in_flight", _stats.batches_in_flight,
+                        sm::description("Holds the number of batches being replayed at the moment.")),
     });
 }
 
@@ -158,15 +167,112 @@ db_clock::duration db::batchlog_manager::get_batch_log_timeout() const {
     return _write_request_timeout * 2;
 }
 
-future<> db::batchlog_manager::replay_all_failed_batches(post_replay_cleanup cleanup) {
+future<> db::batchlog_manager::replay_batch(utils::UUID id, db_clock::time_point written_at, bytes data, utils::rate_limiter& limiter) {
     typedef db_clock::rep clock_type;
 
+    blogger.debug("Replaying batch {}", id);
+
+    auto fms = make_lw_shared<std::deque<canonical_mutation>>();
+    auto in = ser::as_input_stream(data);
+    while (in.size()) {
+        fms->emplace_back(ser::deserialize(in, std::type_identity<canonical_mutation>()));
+    }
+
+    auto size = data.size();
+
+    return map_reduce(*fms, [this, written_at] (canonical_mutation& fm) {
+        const auto& cf = _qp.proxy().local_db().find_column_family(fm.column_family_id());
+        return make_ready_future<canonical_mutation*>(written_at > cf.get_truncation_time() ? &fm : nullptr);
+    },
+    utils::chunked_vector<mutation>(),
+    [this] (utils::chunked_vector<mutation> mutations, canonical_mutation* fm) {
+        if (fm) {
+            schema_ptr s = _qp.db().find_schema(fm->column_family_id());
+            mutations.emplace_back(fm->to_mutation(s));
+        }
+        return mutations;
+    }).then([this, &limiter, written_at, size, fms] (utils::chunked_vector<mutation> mutations) {
+        if (mutations.empty()) {
+            return make_ready_future<>();
+        }
+        const auto ttl = [written_at]() -> clock_type {
+            /*
+             * Calculate ttl for the mutations' hints (and reduce ttl by the time the mutations spent in the batchlog).
+             * This ensures that deletes aren't "undone" by an old batch replay.
+             */
+            auto unadjusted_ttl = std::numeric_limits<gc_clock::rep>::max();
+            warn(unimplemented::cause::HINT);
+#if 0
+            for (auto& m : *mutations) {
+                unadjustedTTL = Math.min(unadjustedTTL, HintedHandOffManager.calculateHintTTL(mutation));
+            }
+#endif
+            return unadjusted_ttl - std::chrono::duration_cast<gc_clock::duration>(db_clock::now() - written_at).count();
+        }();
+
+        if (ttl <= 0) {
+            return make_ready_future<>();
+        }
+        // Origin does the send manually, however I can't see a super great reason to do so.
+        // Our normal write path does not add much redundancy to the dispatch, and rate is handled after send
+        // in both cases.
+        // FIXME: verify that the above is reasonably true.
+        return limiter.reserve(size).then([this, mutations = std::move(mutations)] {
+            _stats.write_attempts += mutations.size();
+            // #1222 - change cl level to ALL, emulating origins behaviour of sending/hinting
+            // to all natural end points.
+            // Note however that origin uses hints here, and actually allows for this
+            // send to partially or wholly fail in actually sending stuff. Since we don't
+            // have hints (yet), send with CL=ALL, and hope we can re-do this soon.
+            // See below, we use retry on write failure.
+            auto timeout = db::timeout_clock::now() + write_timeout;
+            return _qp.proxy().send_batchlog_replay_to_all_replicas(std::move(mutations), timeout);
+        });
+    }).then_wrapped([this, id](future<> batch_result) {
+        try {
+            batch_result.get();
+        } catch (data_dictionary::no_such_keyspace& ex) {
+            // should probably ignore and drop the batch
+        } catch (...) {
+            blogger.warn("Replay failed (will retry): {}", std::current_exception());
+            _stats.failed_batch_replays++;
+            // timeout, overload etc.
+            // Do _not_ remove the batch, assuning we got a node write error.
+            // Since we don't have hints (which origin is satisfied with),
+            // we have to resort to keeping this batch to next lap.
+            return make_ready_future<>();
+        }
+        // delete batch
+        auto schema = _qp.db().find_schema(system_keyspace::NAME, system_keyspace::BATCHLOG);
+        auto key = partition_key::from_singular(*schema, id);
+        mutation m(schema, key);
+        auto now = service::client_state(service::client_state::internal_tag()).get_timestamp();
+        m.partition().apply_delete(*schema, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
+        return _qp.proxy().mutate_locally(m, tracing::trace_state_ptr(), db::commitlog::force_sync::no).then([this] {
+            _stats.replayed_batches++;
+        });
+    });
+}
+
+future<> db::batchlog_manager::replay_all_failed_batches(post_replay_cleanup cleanup) {
     // rate limit is in bytes per second. Uses Double.MAX_VALUE if disabled (set to 0 in cassandra.yaml).
     // max rate is scaled by the number of nodes in the cluster (same as for HHOM - see CASSANDRA-5272).
     auto throttle = _replay_rate / _qp.proxy().get_token_metadata_ptr()->count_normal_token_owners();
     auto limiter = make_lw_shared<utils::rate_limiter>(throttle);
 
-    auto batch = [this, limiter](const cql3::untyped_result_set::row& row) -> future<stop_iteration> {
+    // Up to _replay_concurrency batches are replayed at once, in the
+    // background of the scan of the batchlog, so that the writes of a large
+    // backlog of batches overlap, rather than waiting for each other. Once
+    // the scan is done, the replays still in flight are waited for through
+    // the `replays` gate, before the post-replay cleanup.
+    //
+    // The batches aren't grouped by replica here: the storage proxy
+    // coalesces the concurrent writes of the replay to the same replica
+    // into a single message (see send_batchlog_replay_to_all_replicas()).
+    auto in_flight = make_lw_shared<semaphore>(_replay_concurrency);
+    auto replays = make_lw_shared<seastar::gate>();
+
+    auto batch = [this, limiter, in_flight, replays](const cql3::untyped_result_set::row& row) -> future<stop_iteration> {
         auto written_at = row.get_as<db_clock::time_point>("written_at");
         auto id = row.get_as<utils::UUID>("id");
         // enough time for the actual write + batchlog entry mutation delivery (two separate requests).
@@ -195,104 +301,38 @@ future<> db::batchlog_manager::replay_all_failed_batches(post_replay_cleanup cle
 
         auto data = row.get_blob_unfragmented("data");
 
-        blogger.debug("Replaying batch {}", id);
-
-        auto fms = make_lw_shared<std::deque<canonical_mutation>>();
-        auto in = ser::as_input_stream(data);
-        while (in.size()) {
-            fms->emplace_back(ser::deserialize(in, std::type_identity<canonical_mutation>()));
-        }
-
-        auto size = data.size();
-
-        return map_reduce(*fms, [this, written_at] (canonical_mutation& fm) {
-            const auto& cf = _qp.proxy().local_db().find_column_family(fm.column_family_id());
-            return make_ready_future<canonical_mutation*>(written_at > cf.get_truncation_time() ? &fm : nullptr);
-        },
-        utils::chunked_vector<mutation>(),
-        [this] (utils::chunked_vector<mutation> mutations, canonical_mutation* fm) {
-            if (fm) {
-                schema_ptr s = _qp.db().find_schema(fm->column_family_id());
-                mutations.emplace_back(fm->to_mutation(s));
-            }
-            return mutations;
-        }).then([this, limiter, written_at, size, fms] (utils::chunked_vector<mutation> mutations) {
-            if (mutations.empty()) {
-                return make_ready_future<>();
-            }
-            const auto ttl = [written_at]() -> clock_type {
-                /*
-                 * Calculate ttl for the mutations' hints (and reduce ttl by the time the mutations spent in the batchlog).
-                 * This ensures that deletes aren't "undone" by an old batch replay.
-                 */
-                auto unadjusted_ttl = std::numeric_limits<gc_clock::rep>::max();
-                warn(unimplemented::cause::HINT);
-#if 0
-                for (auto& m : *mutations) {
-                    unadjustedTTL = Math.min(unadjustedTTL, HintedHandOffManager.calculateHintTTL(mutation));
-                }
-#endif
-                return unadjusted_ttl - std::chrono::duration_cast<gc_clock::duration>(db_clock::now() - written_at).count();
-            }();
-
-            if (ttl <= 0) {
-                return make_ready_future<>();
-            }
-            // Origin does the send manually, however I can't see a super great reason to do so.
-            // Our normal write path does not add much redundancy to the dispatch, and rate is handled after send
-            // in both cases.
-            // FIXME: verify that the above is reasonably true.
-            return limiter->reserve(size).then([this, mutations = std::move(mutations)] {
-                _stats.write_attempts += mutations.size();
-                // #1222 - change cl level to ALL, emulating origins behaviour of sending/hinting
-                // to all natural end points.
-                // Note however that origin uses hints here, and actually allows for this
-                // send to partially or wholly fail in actually sending stuff. Since we don't
-                // have hints (yet), send with CL=ALL, and hope we can re-do this soon.
-                // See below, we use retry on write failure.
-                auto timeout = db::timeout_clock::now() + write_timeout;
-                return _qp.proxy().send_batchlog_replay_to_all_replicas(std::move(mutations), timeout);
+        return get_units(*in_flight, 1).then([this, limiter, replays, id, written_at, data = std::move(data)] (auto units) mutable {
+            _stats.batches_in_flight++;
+            // Waited on indirectly, through replays.
+            (void)with_gate(*replays, [this, limiter, id, written_at, data = std::move(data)] () mutable {
+                return replay_batch(id, written_at, std::move(data), *limiter);
+            }).handle_exception([id] (std::exception_ptr ep) {
+                blogger.warn("Replay of batch {} failed: {}", id, ep);
+            }).finally([this, limiter, units = std::move(units)] {
+                _stats.batches_in_flight--;
             });
-        }).then_wrapped([this, id](future<> batch_result) {
-            try {
-                batch_result.get();
-            } catch (data_dictionary::no_such_keyspace& ex) {
-                // should probably ignore and drop the batch
-            } catch (...) {
-                blogger.warn("Replay failed (will retry): {}", std::current_exception());
-                // timeout, overload etc.
-                // Do _not_ remove the batch, assuning we got a node write error.
-                // Since we don't have hints (which origin is satisfied with),
-                // we have to resort to keeping this batch to next lap.
-                return make_ready_future<>();
-            }
-            // delete batch
-            auto schema = _qp.db().find_schema(system_keyspace::NAME, system_keyspace::BATCHLOG);
-            auto key = partition_key::from_singular(*schema, id);
-            mutation m(schema, key);
-            auto now = service::client_state(service::client_state::internal_tag()).get_timestamp();
-            m.partition().apply_delete(*schema, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
-            return _qp.proxy().mutate_locally(m, tracing::trace_state_ptr(), db::commitlog::force_sync::no);
-        }).then([] { return make_ready_future<stop_iteration>(stop_iteration::no); });
+            return stop_iteration::no;
+        });
     };
 
-    co_await with_gate(_gate, [this, cleanup, batch = std::move(batch)] () mutable -> future<> {
+    co_await with_gate(_gate, [this, cleanup, batch = std::move(batch), replays] () mutable -> future<> {
         blogger.debug("Started replayAllFailedBatches (cpu {})", this_shard_id());
         co_await utils::get_local_injector().inject("add_delay_to_batch_replay", std::chrono::milliseconds(1000));
-        co_await _qp.query_internal(
-                format("SELECT id, data, written_at, version FROM {}.{} BYPASS CACHE", system_keyspace::NAME, system_keyspace::BATCHLOG),
-                db::consistency_level::ONE,
-                {},
-                page_size,
-                std::move(batch)).then([this, cleanup] {
-            if (cleanup == post_replay_cleanup::no) {
-                return make_ready_future<>();
-            }
+        co_await with_scheduling_group(_replay_sched_group, [this, batch = std::move(batch), replays] () mutable {
+            return _qp.query_internal(
+                    format("SELECT id, data, written_at, version FROM {}.{} BYPASS CACHE", system_keyspace::NAME, system_keyspace::BATCHLOG),
+                    db::consistency_level::ONE,
+                    {},
+                    page_size,
+                    std::move(batch)).finally([replays] {
+                return replays->close();
+            });
+        });
+        if (cleanup == post_replay_cleanup::yes) {
             // Replaying batches could have generated tombstones, flush to disk,
             // where they can be compacted away.
-            return replica::database::flush_table_on_all_shards(_qp.proxy().get_db(), system_keyspace::NAME, system_keyspace::BATCHLOG);
-        }).then([] {
-            blogger.debug("Finished replayAllFailedBatches");
-        });
+            co_await replica::database::flush_table_on_all_shards(_qp.proxy().get_db(), system_keyspace::NAME, system_keyspace::BATCHLOG);
+        }
+        blogger.debug("Finished replayAllFailedBatches");
     });
 }
@@ -15,8 +15,11 @@
 #include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/scheduling.hh>
 
 #include "db_clock.hh"
+#include "utils/UUID.hh"
+#include "bytes.hh"
 
 #include <chrono>
 #include <limits>
@@ -27,6 +30,12 @@ class query_processor;
 
 } // namespace cql3
 
+namespace utils {
+
+class rate_limiter;
+
+} // namespace utils
+
 namespace db {
 
 class system_keyspace;
@@ -36,6 +45,9 @@ struct batchlog_manager_config {
     uint64_t replay_rate = std::numeric_limits<uint64_t>::max();
     std::chrono::milliseconds delay = std::chrono::milliseconds(0);
     unsigned replay_cleanup_after_replays;
+    // The number of batches replayed at once.
+    unsigned replay_concurrency = 1;
+    seastar::scheduling_group replay_sched_group;
 };
 
 class batchlog_manager : public peering_sharded_service<batchlog_manager> {
@@ -51,6 +63,9 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
 
     struct stats {
         uint64_t write_attempts = 0;
+        uint64_t replayed_batches = 0;
+        uint64_t failed_batch_replays = 0;
+        uint64_t batches_in_flight = 0;
     } _stats;
 
     seastar::metrics::metric_groups _metrics;
@@ -61,6 +76,8 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
     uint64_t _replay_rate;
     std::chrono::milliseconds _delay;
     unsigned _replay_cleanup_after_replays = 100;
+    unsigned _replay_concurrency;
+    seastar::scheduling_group _replay_sched_group;
     semaphore _sem{1};
     seastar::named_gate _gate;
     unsigned _cpu = 0;
@@ -70,6 +87,7 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
     gc_clock::time_point _last_replay;
 
     future<> replay_all_failed_batches(post_replay_cleanup cleanup);
+    future<> replay_batch(utils::UUID id, db_clock::time_point written_at, bytes data, utils::rate_limiter& limiter);
 public:
     // Takes a QP, not a distributes. Because this object is supposed
     // to be per shard and does no dispatching beyond delegating the the
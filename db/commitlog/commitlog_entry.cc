@@ -13,6 +13,10 @@
 
 #include <seastar/core/simple-stream.hh>
 
+#include <lz4.h>
+
+#include "bytes_ostream.hh"
+
 template<typename Output>
 void commitlog_entry_writer::serialize(Output& out) const {
     [this, wr = ser::writer_of_commitlog_entry<Output>(out)] () mutable {
@@ -25,18 +29,59 @@ void commitlog_entry_writer::serialize(Output& out) const {
 }
 
 void commitlog_entry_writer::compute_size() {
+    _compressed_entry.clear();
+    if (_compressed) {
+        bytes_ostream plain;
+        serialize(plain);
+        auto in = plain.linearize();
+        _compressed_entry.resize(LZ4_compressBound(in.size()));
+        auto ret = LZ4_compress_default(reinterpret_cast<const char*>(in.data()), _compressed_entry.data(), in.size(), _compressed_entry.size());
+        if (ret > 0 && detail::compressed_entry_header_size + ret < in.size()) {
+            _compressed_entry.resize(ret);
+            _uncompressed_size = in.size();
+            _size = detail::compressed_entry_header_size + ret;
+            return;
+        }
+        _compressed_entry.clear();
+    }
     seastar::measuring_output_stream ms;
     serialize(ms);
     _size = ms.size();
 }
 
 void commitlog_entry_writer::write(ostream& out) const {
+    if (!_compressed_entry.empty()) {
+        ser::serialize(out, detail::compressed_entry_marker);
+        ser::serialize(out, _uncompressed_size);
+        out.write(_compressed_entry.data(), _compressed_entry.size());
+        return;
+    }
     serialize(out);
 }
 
+template<typename Input>
+static commitlog_entry read_compressed_entry(Input& in) {
+    auto uncompressed_size = ser::deserialize(in, std::type_identity<uint32_t>());
+    bytes compressed(bytes::initialized_later(), in.size());
+    in.read(reinterpret_cast<char*>(compressed.data()), compressed.size());
+    bytes plain(bytes::initialized_later(), uncompressed_size);
+    auto ret = LZ4_decompress_safe(reinterpret_cast<const char*>(compressed.data()), reinterpret_cast<char*>(plain.data()), compressed.size(), plain.size());
+    if (ret < 0 || size_t(ret) != plain.size()) {
+        throw std::runtime_error(fmt::format("Failed to decompress a commitlog entry of {} bytes", plain.size()));
+    }
+    auto plain_in = ser::as_input_stream(bytes_view(plain));
+    return ser::deserialize(plain_in, std::type_identity<commitlog_entry>());
+}
+
 commitlog_entry_reader::commitlog_entry_reader(const fragmented_temporary_buffer& buffer)
     : _ce([&] {
     auto in = seastar::fragmented_memory_input_stream(fragmented_temporary_buffer::view(buffer).begin(), buffer.size_bytes());
+    if (buffer.size_bytes() >= detail::compressed_entry_header_size) {
+        auto header = in;
+        if (ser::deserialize(header, std::type_identity<uint32_t>()) == detail::compressed_entry_marker) {
+            return read_compressed_entry(header);
+        }
+    }
     return ser::deserialize(in, std::type_identity<commitlog_entry>());
 }())
 {
@@ -83,6 +83,16 @@ class commitlog_entry {
     frozen_mutation&& mutation() && { return std::move(_mutation); }
 };
 
+// A compressed entry starts with a zero uint32, which can't start a plain
+// entry, as it's the size of its serialization frame, followed by the size
+// of the plain entry and by the plain entry, compressed with LZ4.
+namespace detail {
+
+    static constexpr uint32_t compressed_entry_marker = 0;
+    static constexpr size_t compressed_entry_header_size = 2 * sizeof(uint32_t);
+
+}
+
 class commitlog_entry_writer {
 public:
     using force_sync = db::commitlog_force_sync;
@@ -90,8 +100,12 @@ class commitlog_entry_writer {
     schema_ptr _schema;
     const frozen_mutation& _mutation;
     bool _with_schema = true;
+    bool _compressed = false;
     size_t _size = std::numeric_limits<size_t>::max();
     force_sync _sync;
+    // The compressed entry, if compression pays off.
+    std::vector<char> _compressed_entry;
+    uint32_t _uncompressed_size = 0;
 private:
     template<typename Output>
     void serialize(Output&) const;
@@ -101,6 +115,15 @@ class commitlog_entry_writer {
         : _schema(std::move(s)), _mutation(fm), _sync(sync)
     {}
 
+    // Compresses the entry, unless that doesn't make it smaller.
+    // Only readers which know compressed entries can read them, so this is
+    // for logs which aren't read by older versions, such as hints.
+    void set_compressed(bool value) {
+        if (std::exchange(_compressed, value) != value && _size != std::numeric_limits<size_t>::max()) {
+            compute_size();
+        }
+    }
+
     void set_with_schema(bool value) {
         if (std::exchange(_with_schema, value) != value || _size == std::numeric_limits<size_t>::max()) {
             compute_size();
@@ -587,6 +587,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "true: auto-adjust memtable shares for flush processes")
     , memtable_flush_static_shares(this, "memtable_flush_static_shares", liveness::LiveUpdate, value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the memtable shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity.")
+    , enable_partition_write_coalescing(this, "enable_partition_write_coalescing", liveness::LiveUpdate, value_status::Used, false,
+        "If set to true, writes to the same partition of a table which arrive on a shard within the same task quota are merged and applied to the memtable at once. Reduces memtable merge work for workloads writing frequently to a few hot partitions, at the cost of slightly delaying each write.")
     , compaction_static_shares(this, "compaction_static_shares", liveness::LiveUpdate, value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity.")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
@@ -925,12 +927,15 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     * @GroupDescription Counter cache helps to reduce counter locks' contention for hot counter cells. In case of RF = 1 a counter cache hit will cause Cassandra to skip the read before write entirely. With RF > 1 a counter cache hit will still help to reduce the duration of the lock hold, helping with hot counter cell updates, but will not allow skipping the read entirely. Only the local (clock, count) tuple of a counter cell is kept in memory, not the whole counter, so it's relatively cheap.
       Note: Reducing the size counter cache may result in not getting the hottest keys loaded on start-up.
     */
-    , counter_cache_size_in_mb(this, "counter_cache_size_in_mb", value_status::Unused, 0,
-        "When no value is specified a minimum of 2.5% of Heap or 50MB. If you perform counter deletes and rely on low gc_grace_seconds, you should disable the counter cache. To disable, set to 0")
+    , counter_cache_size_in_mb(this, "counter_cache_size_in_mb", liveness::LiveUpdate, value_status::Used, 0,
+        "The memory, per node, for caching the local shards of counters, which lets counter updates skip the read before write when this node is the counter leader. "
+        "If you perform counter deletes and rely on low gc_grace_seconds, you should disable the counter cache. To disable, set to 0")
     , counter_cache_save_period(this, "counter_cache_save_period", value_status::Unused, 7200,
         "Duration after which Cassandra should save the counter cache (keys only). Caches are saved to saved_caches_directory.")
     , counter_cache_keys_to_save(this, "counter_cache_keys_to_save", value_status::Unused, 0,
         "Number of keys from the counter cache to save. When disabled all keys are saved.")
+    , paxos_state_cache_size_in_mb(this, "paxos_state_cache_size_in_mb", liveness::LiveUpdate, value_status::Used, 0,
+        "The memory, per node, for caching the paxos state of recently used keys, which lets lightweight transactions skip reading it from the paxos state table. To disable, set to 0")
     /**
     * @Group Tombstone settings
     * @GroupDescription When executing a scan, within or across a partition, tombstones must be kept in memory to allow returning them to the coordinator. The coordinator uses them to ensure other replicas know about the deleted rows. Workloads that generate numerous tombstones may cause performance problems and exhaust the server heap. See Cassandra anti-patterns: Queues and queue-like datasets. Adjust these thresholds only if you understand the impact and want to scan more tombstones. Additionally, you can adjust these thresholds at runtime using the StorageServiceMBean.
@@ -960,12 +965,22 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The time that the coordinator waits for counter writes to complete.")
     , cas_contention_timeout_in_ms(this, "cas_contention_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 1000,
         "The time that the coordinator continues to retry a CAS (compare and set) operation that contends with other proposals for the same row.")
+    , paxos_lease_period_in_ms(this, "paxos_lease_period_in_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "The time for which the coordinator of a CAS (compare and set) operation keeps a lease on the next paxos round of the row: "
+        "once an operation completes, the coordinator prepares the next round of the row in the background, and an operation of the row "
+        "it coordinates within that time skips the prepare round, unless another coordinator prepared a round of the row in the meantime. "
+        "It saves a round trip for rows updated repeatedly through the same coordinator, at the cost of a prepare round per operation "
+        "for other rows. 0 disables the leases.")
     , truncate_request_timeout_in_ms(this, "truncate_request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 60000,
         "The time that the coordinator waits for truncates (remove all data from a table) to complete. The long default value allows for a snapshot to be taken before removing the data. If auto_snapshot is disabled (not recommended), you can reduce this time.")
     , write_request_timeout_in_ms(this, "write_request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 2000,
         "The time in milliseconds that the coordinator waits for write operations to complete.\n"
         "\n"
         "Related information: About hinted handoff writes")
+    , write_coalescing_window_in_us(this, "write_coalescing_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+        "The time in microseconds for which the coordinator holds writes to a replica, so that the writes sent to the same replica "
+        "within that time are sent in a single message. It saves CPU spent on messaging under a high rate of small writes, at the cost "
+        "of added latency. Writes which are traced or forwarded to another datacenter are sent right away. 0 disables coalescing.")
     , request_timeout_in_ms(this, "request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 10000,
         "The default timeout for other, miscellaneous operations.\n"
         "\n"
@@ -1081,6 +1096,20 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Enable or disable keepalive on client connections (CQL native, Redis and the maintenance socket).")
     , cache_hit_rate_read_balancing(this, "cache_hit_rate_read_balancing", value_status::Used, true,
         "This boolean controls whether the replicas for read query will be chosen based on cache hit ratio.")
+    , load_aware_read_balancing(this, "load_aware_read_balancing", liveness::LiveUpdate, value_status::Used, false,
+        "This boolean controls whether the replicas for read query, once chosen based on proximity and cache hit ratio, may be replaced by a random other replica "
+        "of the same datacenter, when that one is considerably less loaded, as judged by the recent latency of reads sent to the replicas and the number of reads outstanding on them.")
+    , adaptive_read_hedging(this, "adaptive_read_hedging", liveness::LiveUpdate, value_status::Used, false,
+        "For tables with a percentile speculative_retry, time the speculative read by the recent latency of reads of the table sent to the replica which is read from, "
+        "instead of the latency of reads of the table as a whole, and limit the rate of speculative reads to read_hedging_budget.")
+    , read_hedging_budget(this, "read_hedging_budget", liveness::LiveUpdate, value_status::Used, 0.05,
+        "With adaptive_read_hedging, the maximum number of speculative reads per read that may speculate, on average. "
+        "It keeps speculative reads from adding to the load of the replicas when many reads are slow.")
+    , read_repair_digest_tree_fanout(this, "read_repair_digest_tree_fanout", liveness::LiveUpdate, value_status::Used, 0,
+        "When the replicas of a partition which was read disagree, first compare digests of this many clustering ranges of the partition, "
+        "split further the ranges the replicas disagree on, and read and repair only those ranges, rather than the whole partition. "
+        "It saves transferring large partitions from all the replicas when only a few of their rows differ, at the cost of a few more round trips. "
+        "0 disables it.")
     /**
     * @Group Advanced fault detection settings
     * @GroupDescription Settings to handle poorly performing or failing nodes.
@@ -1105,10 +1134,20 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Related information: Failure detection and recovery")
     , max_hints_delivery_threads(this, "max_hints_delivery_threads", value_status::Invalid, 2,
         "Number of threads with which to deliver hints. In multiple data-center deployments, consider increasing this number because cross data-center handoff is generally slower.")
+    , hints_compression_enabled(this, "hints_compression_enabled", liveness::LiveUpdate, value_status::Used, false,
+        "Compress hints with LZ4 when storing them on disk. Hints stored compressed can't be replayed after a downgrade to a version which doesn't support hints compression.")
     , batchlog_replay_throttle_in_kb(this, "batchlog_replay_throttle_in_kb", value_status::Unused, 1024,
         "Total maximum throttle. Throttling is reduced proportionally to the number of nodes in the cluster.")
     , batchlog_replay_cleanup_after_replays(this, "batchlog_replay_cleanup_after_replays", liveness::LiveUpdate, value_status::Used, 60,
         "Clean up batchlog memtable after every N replays. Replays are issued on a timer, every 60 seconds. So if batchlog_replay_cleanup_after_replays is set to 60, the batchlog memtable is flushed every 60 * 60 seconds.")
+    , batchlog_replay_concurrency(this, "batchlog_replay_concurrency", value_status::Used, 32,
+        "The number of batches the batchlog replay writes at once. Raising it shortens the replay of a large batchlog backlog, at the cost of more concurrent background writes. "
+        "The writes of the replayed batches are coalesced per replica, over at least 1ms or write_coalescing_window_in_us, whichever is longer.")
+    , batchlog_replay_scheduling_group(this, "batchlog_replay_scheduling_group", value_status::Used, "maintenance",
+        "The scheduling group the batchlog replay runs in:\n"
+        "* maintenance  The group of streaming and repair, so that the replay doesn't compete with user requests.\n"
+        "* main         The main (default) scheduling group."
+        , {"maintenance", "main"})
     /**
     * @Group Request scheduler properties
     * @GroupDescription Settings to handle incoming client requests according to a defined policy. If you need to use these properties, your nodes are overloaded and dropping requests. It is recommended that you add more nodes and not try to prioritize requests.
@@ -1345,6 +1384,15 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Time period in seconds after which unused schema versions will be evicted from the local schema registry cache. Default is 1 second.")
     , max_concurrent_requests_per_shard(this, "max_concurrent_requests_per_shard", liveness::LiveUpdate, value_status::Used, std::numeric_limits<uint32_t>::max(),
         "Maximum number of concurrent requests a single shard can handle before it starts shedding extra load. By default, no requests will be shed.")
+    , max_pipelined_requests_per_connection(this, "max_pipelined_requests_per_connection", liveness::LiveUpdate, value_status::Used, 1024,
+        "Maximum number of requests of a single CQL connection that a shard processes concurrently. Once it is reached, the shard stops reading requests from the connection until some of them are answered, so that a client pipelining many requests over one connection can't starve the other connections of the shard.")
+    , adaptive_concurrency_limit(this, "adaptive_concurrency_limit", liveness::LiveUpdate, value_status::Used, false,
+        "Limit the number of concurrent CQL requests of each service level on a shard to a value which adapts to the observed latency of the requests, "
+        "and shed the requests in excess of it with an overloaded error. The limit grows while the latency stays close to its long-term baseline "
+        "and shrinks as soon as it rises above it, so that the latency of the admitted requests stays bounded under overload. "
+        "It never exceeds max_concurrent_requests_per_shard. Applies only to interactive workloads.")
+    , adaptive_concurrency_limit_min(this, "adaptive_concurrency_limit_min", liveness::LiveUpdate, value_status::Used, 16,
+        "The lowest value the adaptive limit of concurrent CQL requests of a service level can drop to (see adaptive_concurrency_limit).")
     , uninitialized_connections_semaphore_cpu_concurrency(this, "uninitialized_connections_semaphore_cpu_concurrency", liveness::LiveUpdate, value_status::Used, 8,
         "Maximum number of new concurrent connections from drivers that a single shard can be processing before it starts throttling incoming connections. This limit applies only to new connections excluding the ones blocked on network IO; connections that are ready to serve requests are not affected. By default the limit is 8.")
     , cdc_dont_rewrite_streams(this, "cdc_dont_rewrite_streams", value_status::Used, false,
@@ -1368,6 +1416,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "Make the system.config table UPDATEable.")
     , enable_parallelized_aggregation(this, "enable_parallelized_aggregation", liveness::LiveUpdate, value_status::Used, true,
             "Use on a new, parallel algorithm for performing aggregate queries.")
+    , parallelized_aggregation_max_groups(this, "parallelized_aggregation_max_groups", liveness::LiveUpdate, value_status::Used, 100000,
+            "Maximal number of groups of a GROUP BY aggregate query performed with the parallel algorithm. "
+            "Queries with more groups are executed by the coordinator alone.")
     , cql_duplicate_bind_variable_names_refer_to_same_variable(this, "cql_duplicate_bind_variable_names_refer_to_same_variable", liveness::LiveUpdate, value_status::Used, true,
             "A bind variable that appears twice in a CQL query refers to a single variable (if false, no name matching is performed).")
     , alternator_port(this, "alternator_port", value_status::Used, 0, "Alternator API port.")
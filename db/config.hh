@@ -216,6 +216,7 @@ class config final : public utils::config_file {
     named_value<double> background_writer_scheduling_quota;
     named_value<bool> auto_adjust_flush_quota;
     named_value<float> memtable_flush_static_shares;
+    named_value<bool> enable_partition_write_coalescing;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
     named_value<uint32_t> compaction_flush_all_tables_before_major_seconds;
@@ -311,6 +312,7 @@ class config final : public utils::config_file {
     named_value<uint32_t> counter_cache_size_in_mb;
     named_value<uint32_t> counter_cache_save_period;
     named_value<uint32_t> counter_cache_keys_to_save;
+    named_value<uint32_t> paxos_state_cache_size_in_mb;
     named_value<uint32_t> tombstone_warn_threshold;
     named_value<uint32_t> tombstone_failure_threshold;
     named_value<uint64_t> query_tombstone_page_limit;
@@ -320,8 +322,10 @@ class config final : public utils::config_file {
     named_value<uint32_t> read_request_timeout_in_ms;
     named_value<uint32_t> counter_write_request_timeout_in_ms;
     named_value<uint32_t> cas_contention_timeout_in_ms;
+    named_value<uint32_t> paxos_lease_period_in_ms;
     named_value<uint32_t> truncate_request_timeout_in_ms;
     named_value<uint32_t> write_request_timeout_in_ms;
+    named_value<uint32_t> write_coalescing_window_in_us;
     named_value<uint32_t> request_timeout_in_ms;
     named_value<uint32_t> request_timeout_on_shutdown_in_seconds;
     named_value<uint32_t> group0_raft_op_timeout_in_ms;
@@ -358,6 +362,10 @@ class config final : public utils::config_file {
     named_value<bool> start_rpc;
     named_value<bool> rpc_keepalive;
     named_value<bool> cache_hit_rate_read_balancing;
+    named_value<bool> load_aware_read_balancing;
+    named_value<bool> adaptive_read_hedging;
+    named_value<double> read_hedging_budget;
+    named_value<uint32_t> read_repair_digest_tree_fanout;
     named_value<double> dynamic_snitch_badness_threshold;
     named_value<uint32_t> dynamic_snitch_reset_interval_in_ms;
     named_value<uint32_t> dynamic_snitch_update_interval_in_ms;
@@ -366,8 +374,11 @@ class config final : public utils::config_file {
     named_value<uint32_t> hinted_handoff_throttle_in_kb;
     named_value<uint32_t> max_hint_window_in_ms;
     named_value<uint32_t> max_hints_delivery_threads;
+    named_value<bool> hints_compression_enabled;
     named_value<uint32_t> batchlog_replay_throttle_in_kb;
     named_value<uint32_t> batchlog_replay_cleanup_after_replays;
+    named_value<uint32_t> batchlog_replay_concurrency;
+    named_value<sstring> batchlog_replay_scheduling_group;
     named_value<sstring> request_scheduler;
     named_value<sstring> request_scheduler_id;
     named_value<string_map> request_scheduler_options;
@@ -471,12 +482,16 @@ class config final : public utils::config_file {
     named_value<unsigned> user_defined_function_contiguous_allocation_limit_bytes;
     named_value<uint32_t> schema_registry_grace_period;
     named_value<uint32_t> max_concurrent_requests_per_shard;
+    named_value<uint32_t> max_pipelined_requests_per_connection;
+    named_value<bool> adaptive_concurrency_limit;
+    named_value<uint32_t> adaptive_concurrency_limit_min;
     named_value<uint32_t> uninitialized_connections_semaphore_cpu_concurrency;
     named_value<bool> cdc_dont_rewrite_streams;
     named_value<tri_mode_restriction> strict_allow_filtering;
     named_value<tri_mode_restriction> strict_is_not_null_in_views;
     named_value<bool> enable_cql_config_updates;
     named_value<bool> enable_parallelized_aggregation;
+    named_value<uint64_t> parallelized_aggregation_max_groups;
     named_value<bool> cql_duplicate_bind_variable_names_refer_to_same_variable;
 
     named_value<uint16_t> alternator_port;
@@ -18,6 +18,7 @@
 #include <seastar/coroutine/exception.hh>
 
 // Scylla includes.
+#include "db/config.hh"
 #include "db/hints/internal/common.hh"
 #include "db/hints/internal/hint_logger.hh"
 #include "db/hints/internal/hint_storage.hh"
@@ -59,6 +60,7 @@ future<> hint_endpoint_manager::do_store_hint(schema_ptr s, lw_shared_ptr<const
 
         hints_store_ptr log_ptr = co_await get_or_load();
         commitlog_entry_writer cew(s, *fm, commitlog::force_sync::no);
+        cew.set_compressed(_shard_manager.local_db().get_config().hints_compression_enabled());
 
         rp_handle rh = co_await log_ptr->add_entry(s->id(), cew, db::timeout_clock::now() + HINT_FILE_WRITE_TIMEOUT);
 
@@ -20,6 +20,8 @@
 #include <seastar/core/sleep.hh>
 #include <seastar/core/format.hh>
 #include <seastar/core/seastar.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/coroutine/parallel_for_each.hh>
 
 // Scylla includes.
 #include "db/hints/internal/common.hh"
@@ -38,6 +40,7 @@
 #include "gc_clock.hh"
 
 // STD.
+#include <algorithm>
 #include <ranges>
 #include <span>
 #include <stdexcept>
@@ -272,76 +275,137 @@ future<> hint_sender::send_one_mutation(frozen_mutation_and_schema m) {
     });
 }
 
-future<> hint_sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
-        ctx_ptr->mark_hint_as_in_progress(rp);
+future<> hint_sender::send_pending_hints(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    auto hints = std::exchange(ctx_ptr->pending_hints, {});
+    const auto batch_size = std::exchange(ctx_ptr->pending_hints_size, 0);
+
+    try {
+        auto units = co_await _resource_manager.get_send_units_for(batch_size, hints.size());
+        for (const auto& hint : hints) {
+            ctx_ptr->mark_hint_as_in_progress(hint.rp);
+        }
 
         // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
         auto h = ctx_ptr->file_send_gate.hold();
-        (void)std::invoke([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] () mutable {
-            try {
-                auto m = this->get_mutation(ctx_ptr, buf);
-                gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
-
-                // The hint is too old - drop it.
-                //
-                // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
-                // (last_modification - manager::hints_timer_period) old.
-                if (const auto now = gc_clock::now().time_since_epoch(); now - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
-                    manager_logger.debug("send_hints(): the hint is too old, skipping it, "
-                        "secs since file last modification {}, gc_grace_sec {}, hints_flush_period {}",
-                        now - secs_since_file_mod, gc_grace_sec, manager::hints_flush_period);
-                    return make_ready_future<>();
-                }
+        (void)send_hint_batch(ctx_ptr, std::move(hints), secs_since_file_mod, fname).finally([units = std::move(units), h = std::move(h)] {});
+    } catch (...) {
+        manager_logger.trace("send_one_file(): Hmmm. Something bad had happened: {}", std::current_exception());
+        for (const auto& hint : hints) {
+            ctx_ptr->on_hint_send_failure(hint.rp);
+        }
+    }
+}
 
-                const auto mutation_size = m.fm.representation().size();
-                return this->send_one_mutation(std::move(m)).then([this, ctx_ptr, mutation_size] {
-                    ++this->shard_stats().sent_total;
-                    this->shard_stats().sent_hints_bytes_total += mutation_size;
-                }).handle_exception([this, ctx_ptr] (auto eptr) {
-                    manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), eptr);
-                    ++this->shard_stats().send_errors;
-                    return make_exception_future<>(std::move(eptr));
-                });
-
-            // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
-            } catch (replica::no_such_column_family& e) {
-                manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (replica::no_such_keyspace& e) {
-                manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (no_column_mapping& e) {
-                manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
-                ++this->shard_stats().discarded;
-            } catch (...) {
-                auto eptr = std::current_exception();
-                manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, eptr);
-                ++this->shard_stats().send_errors;
-                return make_exception_future<>(std::move(eptr));
-            }
-            return make_ready_future<>();
-        }).then_wrapped([this, units = std::move(units), rp, ctx_ptr, h = std::move(h)] (future<>&& f) {
-            // Information about the error was already printed somewhere higher.
-            // We just need to account in the ctx that sending of this hint has failed.
-            if (!f.failed()) {
+future<> hint_sender::send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<pending_hint> hints, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    // Hints of the same partition, merged into a single mutation.
+    struct hint_group {
+        frozen_mutation_and_schema m;
+        std::vector<db::replay_position> rps;
+    };
+    std::vector<hint_group> groups;
+
+    for (auto& hint : hints) {
+        const auto rp = hint.rp;
+        try {
+            auto m = get_mutation(ctx_ptr, hint.buf);
+            gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
+
+            // The hint is too old - drop it.
+            //
+            // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
+            // (last_modification - manager::hints_timer_period) old.
+            if (const auto now = gc_clock::now().time_since_epoch(); now - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
+                manager_logger.debug("send_hints(): the hint is too old, skipping it, "
+                    "secs since file last modification {}, gc_grace_sec {}, hints_flush_period {}",
+                    now - secs_since_file_mod, gc_grace_sec, manager::hints_flush_period);
                 ctx_ptr->on_hint_send_success(rp);
-                auto new_bound = ctx_ptr->get_replayed_bound();
-                // Segments from other shards are replayed first and are considered to be "before" replay position 0.
-                // Update the sent upper bound only if it is a local segment.
-                if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
-                    _sent_upper_bound_rp = new_bound;
-                    notify_replay_waiters();
-                }
+                continue;
+            }
+
+            auto it = std::ranges::find_if(groups, [&m] (const hint_group& g) {
+                return g.m.s->id() == m.s->id() && g.m.s->version() == m.s->version() && g.m.fm.key().equal(*m.s, m.fm.key());
+            });
+            if (it == groups.end()) {
+                groups.push_back(hint_group{std::move(m), {rp}});
             } else {
+                mutation merged = it->m.fm.unfreeze(it->m.s);
+                merged.apply(m.fm.unfreeze(m.s));
+                it->m.fm = freeze(merged);
+                it->rps.push_back(rp);
+                ++shard_stats().coalesced;
+            }
+
+        // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
+        } catch (replica::no_such_column_family& e) {
+            manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+            ++shard_stats().discarded;
+            ctx_ptr->on_hint_send_success(rp);
+        } catch (replica::no_such_keyspace& e) {
+            manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+            ++shard_stats().discarded;
+            ctx_ptr->on_hint_send_success(rp);
+        } catch (no_column_mapping& e) {
+            manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
+            ++shard_stats().discarded;
+            ctx_ptr->on_hint_send_success(rp);
+        } catch (...) {
+            manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, std::current_exception());
+            ++shard_stats().send_errors;
+            ctx_ptr->on_hint_send_failure(rp);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    update_sent_upper_bound(*ctx_ptr);
+
+    bool batch_failed = false;
+    co_await coroutine::parallel_for_each(groups, [this, ctx_ptr, &batch_failed] (hint_group& g) -> future<> {
+        const auto mutation_size = g.m.fm.representation().size();
+        bool failed = false;
+        try {
+            co_await send_one_mutation(std::move(g.m));
+            shard_stats().sent_total += g.rps.size();
+            shard_stats().sent_hints_bytes_total += mutation_size;
+        // The table was dropped after the hint had been read.
+        } catch (replica::no_such_column_family& e) {
+            manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+            shard_stats().discarded += g.rps.size();
+        } catch (replica::no_such_keyspace& e) {
+            manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+            shard_stats().discarded += g.rps.size();
+        } catch (...) {
+            manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), std::current_exception());
+            shard_stats().send_errors += g.rps.size();
+            failed = true;
+            batch_failed = true;
+        }
+
+        // Information about the error was already printed above.
+        // We just need to account in the ctx that sending of these hints has failed.
+        for (const auto& rp : g.rps) {
+            if (failed) {
                 ctx_ptr->on_hint_send_failure(rp);
+            } else {
+                ctx_ptr->on_hint_send_success(rp);
             }
-            f.ignore_ready_future();
-        });
-    }).handle_exception([ctx_ptr, rp] (auto eptr) {
-        manager_logger.trace("send_one_file(): Hmmm. Something bad had happened: {}", eptr);
-        ctx_ptr->on_hint_send_failure(rp);
+        }
+        update_sent_upper_bound(*ctx_ptr);
     });
+
+    if (batch_failed) {
+        _hints_per_send_batch = std::max<size_t>(_hints_per_send_batch / 2, 1);
+    } else if (!groups.empty()) {
+        _hints_per_send_batch = std::min(_hints_per_send_batch + initial_hints_per_send_batch, max_hints_per_send_batch);
+    }
+}
+
+void hint_sender::update_sent_upper_bound(const send_one_file_ctx& ctx) noexcept {
+    auto new_bound = ctx.get_replayed_bound();
+    // Segments from other shards are replayed first and are considered to be "before" replay position 0.
+    // Update the sent upper bound only if it is a local segment.
+    if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
+        _sent_upper_bound_rp = new_bound;
+        notify_replay_waiters();
+    }
 }
 
 void hint_sender::notify_replay_waiters() noexcept {
@@ -496,7 +560,11 @@ bool hint_sender::send_one_file(const sstring& fname) {
                     co_await sleep(std::chrono::milliseconds(100));
                     continue;
                 } else {
-                    co_await send_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
+                    ctx_ptr->pending_hints_size += buf.size_bytes();
+                    ctx_ptr->pending_hints.push_back(pending_hint{std::move(buf), rp});
+                    if (ctx_ptr->pending_hints.size() >= _hints_per_send_batch || ctx_ptr->pending_hints_size >= max_send_batch_size) {
+                        co_await send_pending_hints(ctx_ptr, secs_since_file_mod, fname);
+                    }
                     break;
                 }
             };
@@ -512,6 +580,16 @@ bool hint_sender::send_one_file(const sstring& fname) {
         ctx_ptr->segment_replay_failed = true;
     }
 
+    // Send the tail of the file which didn't fill a whole batch. If the replay of the segment
+    // already failed the hints are going to be read again in the next attempt.
+    if (!ctx_ptr->pending_hints.empty() && !canceled_draining() && (draining() || !ctx_ptr->segment_replay_failed)) {
+        if (can_send()) {
+            send_pending_hints(ctx_ptr, secs_since_file_mod, fname).get();
+        } else {
+            ctx_ptr->segment_replay_failed = true;
+        }
+    }
+
     // wait till all background hints sending is complete
     ctx_ptr->file_send_gate.close().get();
 
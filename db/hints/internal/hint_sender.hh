@@ -35,6 +35,7 @@
 #include <optional>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 namespace service {
 class storage_proxy;
@@ -75,6 +76,18 @@ class hint_sender {
         state::draining,
         state::canceled_draining>>;
 
+    // Hints read from a file are sent in batches of at most this many hints or bytes.
+    static constexpr size_t max_hints_per_send_batch = 128;
+    static constexpr size_t max_send_batch_size = 128 * 1024;
+    // The number of hints per batch starts here, grows by this much after each
+    // batch which was sent successfully, and is halved when sending a batch fails.
+    static constexpr size_t initial_hints_per_send_batch = 8;
+
+    struct pending_hint {
+        fragmented_temporary_buffer buf;
+        db::replay_position rp;
+    };
+
     struct send_one_file_ctx {
         send_one_file_ctx(std::unordered_map<table_schema_version, column_mapping>& last_schema_ver_to_column_mapping)
             : schema_ver_to_column_mapping(last_schema_ver_to_column_mapping)
@@ -85,6 +98,9 @@ class hint_sender {
         std::optional<db::replay_position> first_failed_rp;
         std::optional<db::replay_position> last_succeeded_rp;
         std::set<db::replay_position> in_progress_rps;
+        // Hints read from the file which were not handed over for sending yet.
+        std::vector<pending_hint> pending_hints;
+        size_t pending_hints_size = 0;
         bool segment_replay_failed = false;
 
         void mark_hint_as_in_progress(db::replay_position rp);
@@ -118,6 +134,10 @@ class hint_sender {
     seastar::shared_mutex& _file_update_mutex;
 
     std::multimap<db::replay_position, lw_shared_ptr<std::optional<promise<>>>> _replay_waiters;
+    // The number of hints sent in a batch, adapted to how well the destination
+    // copes with them: a node which is still recovering, and times out writes,
+    // gets smaller batches, so that a failure makes fewer hints to be resent.
+    size_t _hints_per_send_batch = initial_hints_per_send_batch;
 
 public:
     hint_sender(hint_endpoint_manager& parent, service::storage_proxy& local_storage_proxy, replica::database& local_db, const gms::gossiper& local_gossiper) noexcept;
@@ -202,19 +222,32 @@ class hint_sender {
 
     bool replay_allowed() const noexcept;
 
-    /// \brief Try to send one hint read from the file.
+    /// \brief Try to send the hints read from the file so far (ctx_ptr->pending_hints).
     ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of hints "in the air".
-    ///  - Discard the hints that are older than the grace seconds value of the corresponding table.
+    ///    A batch is accounted as a single hint of the batch's total size.
+    ///
+    /// If sending of a hint fails we are going to set the ctx_ptr->segment_replay_failed and ctx_ptr->first_failed_rp
+    /// will be updated to min(ctx_ptr->first_failed_rp, rp of the hint).
     ///
-    /// If sending fails we are going to set the state::segment_replay_failed in the _state and _first_failed_rp will be updated to min(_first_failed_rp, \ref rp).
+    /// \param ctx_ptr shared pointer to the file sending context
+    /// \param secs_since_file_mod last modification time stamp (in seconds since Epoch) of the current hints file
+    /// \param fname name of the hints file the hints were read from
+    /// \return future that resolves when next hints may be sent
+    future<> send_pending_hints(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+    /// \brief Send a batch of hints in the background of send_pending_hints().
+    ///  - Discard the hints that are older than the grace seconds value of the corresponding table.
+    ///  - Merge the hints of the same partition into a single mutation, so that each partition is sent once.
     ///
     /// \param ctx_ptr shared pointer to the file sending context
-    /// \param buf buffer representing the hint
-    /// \param rp replay position of this hint in the file (see commitlog for more details on "replay position")
+    /// \param hints the hints to send, all of them marked as in progress in \ref ctx_ptr
     /// \param secs_since_file_mod last modification time stamp (in seconds since Epoch) of the current hints file
-    /// \param fname name of the hints file this hint was read from
-    /// \return future that resolves when next hint may be sent
-    future<> send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+    /// \param fname name of the hints file the hints were read from
+    /// \return future that resolves when all hints of the batch were either sent or failed
+    future<> send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<pending_hint> hints, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+    /// \brief Advances _sent_upper_bound_rp to the bound replayed in the given file sending context.
+    void update_sent_upper_bound(const send_one_file_ctx& ctx) noexcept;
 
     /// \brief Send all hint from a single file and delete it after it has been successfully sent.
     /// Send all hints from the given file. If we failed to send the current segment we will pick up in the next
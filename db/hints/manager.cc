@@ -186,6 +186,9 @@ void manager::register_metrics(const sstring& group_name) {
         sm::make_counter("corrupted_files", _stats.corrupted_files,
                         sm::description("Number of hints files that were discarded during sending because the file was corrupted.")),
 
+        sm::make_counter("coalesced_total", _stats.coalesced,
+                        sm::description("Number of hints that were merged into another hint of the same partition before sending.")),
+
         sm::make_gauge("pending_drains",
                         sm::description("Number of tasks waiting in the queue for draining hints"),
                         [this] { return _drain_lock.waiters(); }),
@@ -179,7 +179,11 @@ class resource_manager {
     resource_manager(resource_manager&&) = delete;
     resource_manager& operator=(resource_manager&&) = delete;
 
-    future<semaphore_units<named_semaphore::exception_factory>> get_send_units_for(size_t buf_size);
+    /// \brief Reserves the budget for sending \p hints hints, of \p buf_size bytes in total.
+    ///
+    /// Each hint is charged at least its share of the per-shard concurrency limit,
+    /// so that sending a batch of hints counts as sending each of them.
+    future<semaphore_units<named_semaphore::exception_factory>> get_send_units_for(size_t buf_size, size_t hints = 1);
     size_t sending_queue_length() const;
 
     future<> start(shared_ptr<const gms::gossiper> gossiper_ptr);
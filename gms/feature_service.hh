@@ -106,6 +106,8 @@ class feature_service final : public peering_sharded_service<feature_service> {
     gms::feature keyspace_storage_options { *this, "KEYSPACE_STORAGE_OPTIONS"sv };
     gms::feature typed_errors_in_read_rpc { *this, "TYPED_ERRORS_IN_READ_RPC"sv };
     gms::feature uda_native_parallelized_aggregation { *this, "UDA_NATIVE_PARALLELIZED_AGGREGATION"sv };
+    gms::feature parallelized_group_by { *this, "PARALLELIZED_GROUP_BY"sv };
+    gms::feature parallelized_aggregation_filtering { *this, "PARALLELIZED_AGGREGATION_FILTERING"sv };
     gms::feature aggregate_storage_options { *this, "AGGREGATE_STORAGE_OPTIONS"sv };
     gms::feature collection_indexing { *this, "COLLECTION_INDEXING"sv };
     gms::feature large_collection_detection { *this, "LARGE_COLLECTION_DETECTION"sv };
@@ -169,6 +171,8 @@ class feature_service final : public peering_sharded_service<feature_service> {
     gms::feature topology_global_request_queue { *this, "TOPOLOGY_GLOBAL_REQUEST_QUEUE"sv };
     gms::feature lwt_with_tablets { *this, "LWT_WITH_TABLETS"sv };
     gms::feature repair_msg_split { *this, "REPAIR_MSG_SPLIT"sv };
+    gms::feature mutation_batch_verb { *this, "MUTATION_BATCH_VERB"sv };
+    gms::feature lwt_leases { *this, "LWT_LEASES"sv };
 public:
 
     const std::unordered_map<sstring, std::reference_wrapper<feature>>& registered_features() const;
@@ -25,6 +25,17 @@ struct mapreduce_request {
         db::functions::function_name name;
         std::vector<sstring> column_names;
     };
+    struct group_by_info {
+        std::vector<sstring> column_names;
+        uint64_t max_groups;
+    };
+    struct filter_restriction {
+        sstring column_name;
+        std::optional<bytes> subscript;
+        uint8_t op;
+        bytes_opt value;
+        sstring value_type;
+    };
     enum class reduction_type : uint8_t {
         count,
         aggregate
@@ -40,10 +51,14 @@ struct mapreduce_request {
 
     std::optional<std::vector<query::mapreduce_request::aggregation_info>> aggregation_infos [[version 5.1]];
     std::optional<shard_id> shard_id_hint [[version 2025.3]];
+    std::optional<query::mapreduce_request::group_by_info> group_by [[version 2025.4]];
+    std::optional<std::vector<query::mapreduce_request::filter_restriction>> filter [[version 2025.4]];
 };
 
 struct mapreduce_result {
     std::vector<bytes_opt> query_results;
+    std::optional<std::vector<std::vector<bytes_opt>>> grouped_query_results [[version 2025.4]];
+    bool group_limit_exceeded [[version 2025.4]] = false;
 };
 
 verb [[cancellable]] mapreduce_request(query::mapreduce_request req [[ref]], std::optional<tracing::trace_info> trace_info [[ref]]) -> query::mapreduce_result;
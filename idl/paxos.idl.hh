@@ -7,6 +7,8 @@
  */
 
 #include "idl/result.idl.hh"
+#include "idl/read_command.idl.hh"
+#include "idl/query.idl.hh"
 
 namespace service {
 namespace paxos {
@@ -22,5 +24,12 @@ class promise {
     std::optional<std::variant<query::result, query::result_digest>> get_data_or_digest();
 };
 
+struct accept_condition {
+    utils::UUID promised_ballot;
+    query::read_command cmd;
+    query::digest_algorithm digest_algorithm;
+    query::result_digest digest;
+};
+
 }
 }
@@ -2309,6 +2309,9 @@ sharded<locator::shared_token_metadata> token_metadata;
             bm_cfg.replay_rate = cfg->batchlog_replay_throttle_in_kb() * 1000;
             bm_cfg.delay = std::chrono::milliseconds(cfg->ring_delay_ms());
             bm_cfg.replay_cleanup_after_replays = cfg->batchlog_replay_cleanup_after_replays();
+            bm_cfg.replay_concurrency = cfg->batchlog_replay_concurrency();
+            bm_cfg.replay_sched_group = cfg->batchlog_replay_scheduling_group() == "main"
+                    ? default_scheduling_group() : dbcfg.streaming_scheduling_group;
 
             bm.start(std::ref(qp), std::ref(sys_ks), bm_cfg).get();
             auto stop_batchlog_manager = defer_verbose_shutdown("batchlog manager", [&bm] {
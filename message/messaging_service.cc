@@ -38,6 +38,8 @@
 #include "node_ops/node_ops_ctl.hh"
 #include "service/paxos/proposal.hh"
 #include "service/paxos/prepare_response.hh"
+#include "service/paxos/accept_condition.hh"
+#include "service/batched_mutation.hh"
 #include "query-request.hh"
 #include "mutation_query.hh"
 #include "repair/repair.hh"
@@ -716,6 +718,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
         return 1;
     case messaging_verb::CLIENT_ID:
     case messaging_verb::MUTATION:
+    case messaging_verb::MUTATION_BATCH:
     case messaging_verb::READ_DATA:
     case messaging_verb::READ_MUTATION_DATA:
     case messaging_verb::READ_DIGEST:
@@ -489,6 +489,36 @@ struct mapreduce_request {
         // Used by selector_factries to prepare reductions information
         std::vector<reduction_type> types;
         std::vector<aggregation_info> infos;
+        // Position of each selector in mapreduce_result::query_results, or in
+        // the rows of mapreduce_result::grouped_query_results for grouped
+        // selections. Columns retrieved only for filtering aren't part of the
+        // result sent to the client, aren't computed by the mapreduce_request
+        // and have no position.
+        std::vector<std::optional<size_t>> selector_positions;
+    };
+    // GROUP BY of the aggregation. The grouping columns include the whole
+    // partition key, and partial results are computed for disjoint partition
+    // ranges, so each group is computed by a single shard and partial results
+    // are merged by concatenating their groups.
+    struct group_by_info {
+        // Names of the grouping columns, in GROUP BY order.
+        std::vector<sstring> column_names;
+        // Maximal number of groups kept in memory by each node taking part in
+        // the query. Beyond that the result has group_limit_exceeded set and
+        // the query has to be executed without mapreduce_service.
+        uint64_t max_groups;
+    };
+    // A restriction which needs filtering, in prepared form:
+    // `column[subscript] op value`, evaluated with the options of the query.
+    struct filter_restriction {
+        sstring column_name;
+        // Serialized key of the restricted collection element, if subscripted.
+        std::optional<bytes> subscript;
+        // A cql3::expr::oper_t.
+        uint8_t op;
+        bytes_opt value;
+        // Name of the type of value, see abstract_type::name().
+        sstring value_type;
     };
 
     std::vector<reduction_type> reduction_types;
@@ -500,15 +530,25 @@ struct mapreduce_request {
     lowres_system_clock::time_point timeout;
     std::optional<std::vector<aggregation_info>> aggregation_infos;
     std::optional<shard_id> shard_id_hint;
+    std::optional<group_by_info> group_by;
+    // Restrictions which need filtering, evaluated by the shards computing
+    // the reductions. All of them have to be satisfied.
+    std::optional<std::vector<filter_restriction>> filter;
 };
 
 std::ostream& operator<<(std::ostream& out, const mapreduce_request& r);
 std::ostream& operator<<(std::ostream& out, const mapreduce_request::reduction_type& r);
 std::ostream& operator<<(std::ostream& out, const mapreduce_request::aggregation_info& a);
+std::ostream& operator<<(std::ostream& out, const mapreduce_request::group_by_info& g);
+std::ostream& operator<<(std::ostream& out, const mapreduce_request::filter_restriction& f);
 
 struct mapreduce_result {
     // vector storing query result for each selected column
     std::vector<bytes_opt> query_results;
+    // For grouped aggregations, rows holding the grouping columns followed by
+    // the results for each selected column, one per group.
+    std::optional<std::vector<std::vector<bytes_opt>>> grouped_query_results;
+    bool group_limit_exceeded = false;
 
     struct printer {
         const std::vector<::shared_ptr<db::functions::aggregate_function>> functions;
@@ -526,4 +566,6 @@ template <> struct fmt::formatter<query::read_command> : fmt::ostream_formatter
 template <> struct fmt::formatter<query::mapreduce_request> : fmt::ostream_formatter {};
 template <> struct fmt::formatter<query::mapreduce_request::reduction_type> : fmt::ostream_formatter {};
 template <> struct fmt::formatter<query::mapreduce_request::aggregation_info> : fmt::ostream_formatter {};
+template <> struct fmt::formatter<query::mapreduce_request::group_by_info> : fmt::ostream_formatter {};
+template <> struct fmt::formatter<query::mapreduce_request::filter_restriction> : fmt::ostream_formatter {};
 template <> struct fmt::formatter<query::mapreduce_result::printer> : fmt::ostream_formatter {};
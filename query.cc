@@ -89,6 +89,18 @@ std::ostream& operator<<(std::ostream& out, const mapreduce_request::aggregation
     return out;
 }
 
+std::ostream& operator<<(std::ostream& out, const mapreduce_request::group_by_info& g) {
+    fmt::print(out, "group_by_info{{column_names=[{}], max_groups={}}}",
+               fmt::join(g.column_names, ","), g.max_groups);
+    return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const mapreduce_request::filter_restriction& f) {
+    fmt::print(out, "filter_restriction{{column_name={}, subscript={}, op={}, value={}, value_type={}}}",
+               f.column_name, f.subscript, f.op, f.value, f.value_type);
+    return out;
+}
+
 std::ostream& operator<<(std::ostream& out, const mapreduce_request& r) {
     auto ms = std::chrono::time_point_cast<std::chrono::milliseconds>(r.timeout).time_since_epoch().count();
     fmt::print(out, "mapreduce_request{{reductions=[{}]",
@@ -100,6 +112,12 @@ std::ostream& operator<<(std::ostream& out, const mapreduce_request& r) {
     if (r.shard_id_hint) {
         fmt::print(out, ", shard_id_hint={}", r.shard_id_hint.value());
     }
+    if (r.group_by) {
+        fmt::print(out, ", group_by={}", r.group_by.value());
+    }
+    if (r.filter) {
+        fmt::print(out, ", filter=[{}]", fmt::join(r.filter.value(), ","));
+    }
     fmt::print(out, ", cmd={}, pr={}, cl={}, timeout(ms)={}}}",
                r.cmd, r.pr, r.cl, ms);
     return out;
@@ -395,6 +413,12 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
 }
 
 std::ostream& operator<<(std::ostream& out, const query::mapreduce_result::printer& p) {
+    if (p.res.group_limit_exceeded) {
+        return out << "[group limit exceeded]";
+    }
+    if (p.res.grouped_query_results) {
+        return out << "[" << p.res.grouped_query_results->size() << " groups]";
+    }
     if (p.functions.size() != p.res.query_results.size()) {
         return out << "[malformed mapreduce_result (" << p.res.query_results.size()
             << " results, " << p.functions.size() << " aggregates)]";
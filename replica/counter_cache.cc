@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include "replica/counter_cache.hh"
+
+#include "counters.hh"
+#include "dht/i_partitioner.hh"
+#include "mutation/mutation.hh"
+#include "schema/schema.hh"
+#include "utils/hash.hh"
+#include "utils/small_vector.hh"
+
+namespace replica {
+
+void counter_cache_tracker::set_capacity(size_t capacity) {
+    _capacity = capacity;
+    evict();
+}
+
+void counter_cache_tracker::insert(entry& e) {
+    _lru.push_back(e);
+    ++_stats.entries;
+    _stats.memory += e._size;
+}
+
+void counter_cache_tracker::touch(entry& e) {
+    e._lru_link.unlink();
+    _lru.push_back(e);
+}
+
+void counter_cache_tracker::remove(entry& e) noexcept {
+    if (e._lru_link.is_linked()) {
+        e._lru_link.unlink();
+        --_stats.entries;
+        _stats.memory -= e._size;
+    }
+}
+
+void counter_cache_tracker::evict() {
+    while (_stats.memory > _capacity && !_lru.empty()) {
+        auto& e = _lru.front();
+        e._cache->erase(e);
+        ++_stats.evictions;
+    }
+}
+
+size_t counter_cache::key_hash::operator()(key_view k) const {
+    auto h = utils::hash_combine(std::hash<dht::token>()(k.token), std::hash<column_id>()(k.id));
+    if (k.ck) {
+        h = utils::hash_combine(h, std::hash<managed_bytes_view>()(k.ck->representation()));
+    }
+    return h;
+}
+
+bool counter_cache::key_equal::operator()(key_view a, key_view b) const {
+    return a.token == b.token
+        && a.id == b.id
+        && bool(a.ck) == bool(b.ck)
+        && (!a.ck || a.ck->representation() == b.ck->representation())
+        && a.pk.representation() == b.pk.representation();
+}
+
+counter_cache::~counter_cache() {
+    for (auto& [k, e] : _entries) {
+        _tracker.remove(e);
+    }
+}
+
+counter_cache_tracker::entry* counter_cache::find(key_view k) {
+    auto it = _entries.find(k);
+    if (it == _entries.end()) {
+        ++_tracker._stats.misses;
+        return nullptr;
+    }
+    ++_tracker._stats.hits;
+    _tracker.touch(it->second);
+    return &it->second;
+}
+
+bool counter_cache::transform_counter_updates_to_shards(mutation& m, uint64_t clock_offset, locator::host_id local_id) {
+    auto& p = m.partition();
+    if (p.partition_tombstone() || !p.row_tombstones().empty()) {
+        return false;
+    }
+    const auto& s = *m.schema();
+    auto token = m.token();
+    const auto& pk = m.key();
+
+    // Look all the cells up first, so that m is left alone on a miss.
+    utils::small_vector<counter_cache_tracker::entry*, 8> found;
+    bool complete = true;
+    auto lookup = [&] (column_kind kind, const row& cells, const clustering_key* ck) {
+        cells.for_each_cell([&] (column_id id, const atomic_cell_or_collection& ac_o_c) {
+            if (!complete) {
+                return;
+            }
+            auto acv = ac_o_c.as_atomic_cell(s.column_at(kind, id));
+            auto* e = acv.is_live() ? find(key_view(token, pk, ck, id)) : nullptr;
+            if (!e) {
+                complete = false;
+                return;
+            }
+            found.push_back(e);
+        });
+    };
+    lookup(column_kind::static_column, p.static_row().get(), nullptr);
+    for (const auto& cr : p.clustered_rows()) {
+        if (!complete || cr.row().deleted_at()) {
+            return false;
+        }
+        lookup(column_kind::regular_column, cr.row().cells(), &cr.key());
+    }
+    if (!complete) {
+        return false;
+    }
+
+    auto id = counter_id(local_id.uuid());
+    auto next = found.begin();
+    auto transform = [&] (column_kind kind, auto& cells) {
+        cells.for_each_cell([&] (column_id column, atomic_cell_or_collection& ac_o_c) {
+            auto acv = ac_o_c.as_atomic_cell(s.column_at(kind, column));
+            auto& e = **next++;
+            auto cs = counter_shard(id, e._value, e._logical_clock);
+            cs.update(acv.counter_update_value(), clock_offset + 1);
+            ac_o_c = counter_cell_builder::from_single_shard(acv.timestamp(), cs);
+        });
+    };
+    transform(column_kind::static_column, p.static_row());
+    for (auto& cr : p.clustered_rows()) {
+        transform(column_kind::regular_column, cr.row().cells());
+    }
+    return true;
+}
+
+void counter_cache::update(const mutation& m, uint64_t generation, locator::host_id local_id) {
+    const auto& p = m.partition();
+    if (p.partition_tombstone() || !p.row_tombstones().empty()) {
+        invalidate();
+        return;
+    }
+    const auto& s = *m.schema();
+    auto token = m.token();
+    const auto& pk = m.key();
+    auto id = counter_id(local_id.uuid());
+    // If the cache was invalidated since the update started, the state it
+    // was based on may be stale.
+    bool stale = generation != _generation || !enabled();
+    bool deletes = false;
+
+    auto update_row = [&] (column_kind kind, const row& cells, const clustering_key* ck) {
+        cells.for_each_cell([&] (column_id column, const atomic_cell_or_collection& ac_o_c) {
+            auto k = key_view(token, pk, ck, column);
+            auto acv = ac_o_c.as_atomic_cell(s.column_at(kind, column));
+            if (!acv.is_live()) {
+                erase(k);
+                deletes = true;
+                return;
+            }
+            auto cs = counter_cell_view(acv).get_shard(id);
+            if (stale || !cs) {
+                erase(k);
+                return;
+            }
+            auto it = _entries.find(k);
+            if (it == _entries.end()) {
+                it = _entries.emplace(key{token, pk, ck ? std::optional(*ck) : std::nullopt, column}, counter_cache_tracker::entry()).first;
+                auto& e = it->second;
+                e._cache = this;
+                e._key = &it->first;
+                e._size = sizeof(*it) + 2 * sizeof(void*)
+                        + pk.representation().size() + (ck ? ck->representation().size() : 0);
+                _tracker.insert(e);
+            } else {
+                _tracker.touch(it->second);
+            }
+            it->second._value = cs->value();
+            it->second._logical_clock = cs->logical_clock();
+        });
+    };
+    update_row(column_kind::static_column, p.static_row().get(), nullptr);
+    for (const auto& cr : p.clustered_rows()) {
+        if (cr.row().deleted_at()) {
+            erase_row(s, token, pk, cr.key());
+            deletes = true;
+        }
+        update_row(column_kind::regular_column, cr.row().cells(), &cr.key());
+    }
+    if (deletes) {
+        ++_generation;
+    }
+    _tracker.evict();
+}
+
+void counter_cache::invalidate(const mutation& m) {
+    const auto& p = m.partition();
+    if (p.partition_tombstone() || !p.row_tombstones().empty()) {
+        invalidate();
+        return;
+    }
+    ++_generation;
+    auto token = m.token();
+    const auto& pk = m.key();
+    p.static_row().get().for_each_cell([&] (column_id column, const atomic_cell_or_collection&) {
+        erase(key_view(token, pk, nullptr, column));
+    });
+    for (const auto& cr : p.clustered_rows()) {
+        erase_row(*m.schema(), token, pk, cr.key());
+    }
+}
+
+void counter_cache::erase(key_view k) noexcept {
+    auto it = _entries.find(k);
+    if (it != _entries.end()) {
+        _tracker.remove(it->second);
+        _entries.erase(it);
+        ++_tracker._stats.invalidations;
+    }
+}
+
+void counter_cache::erase_row(const schema& s, dht::token token, const partition_key& pk, const clustering_key& ck) noexcept {
+    for (const auto& cdef : s.regular_columns()) {
+        erase(key_view(token, pk, &ck, cdef.id));
+    }
+}
+
+void counter_cache::erase(counter_cache_tracker::entry& e) noexcept {
+    _tracker.remove(e);
+    _entries.erase(_entries.find(key_view(*static_cast<const key*>(e._key))));
+}
+
+void counter_cache::invalidate(const dht::partition_range& range) noexcept {
+    // Invalidates whole tokens at the bounds of the range, which is
+    // harmless and doesn't need the schema to compare the keys.
+    auto start = range.start() ? range.start()->value().token() : dht::minimum_token();
+    auto end = range.end() ? range.end()->value().token() : dht::maximum_token();
+    ++_generation;
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->first.token >= start && it->first.token <= end) {
+            _tracker.remove(it->second);
+            it = _entries.erase(it);
+            ++_tracker._stats.invalidations;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void counter_cache::invalidate() {
+    ++_generation;
+    _tracker._stats.invalidations += _entries.size();
+    for (auto& [k, e] : _entries) {
+        _tracker.remove(e);
+    }
+    _entries.clear();
+}
+
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
+#include <boost/intrusive/list.hpp>
+
+#include "dht/i_partitioner_fwd.hh"
+#include "dht/token.hh"
+#include "keys/keys.hh"
+#include "locator/host_id.hh"
+#include "schema/schema_fwd.hh"
+
+class mutation;
+
+namespace replica {
+
+class counter_cache;
+
+// Keeps the least recently used order of the entries of the counter caches of
+// all tables on a shard, and evicts them when they use more memory than
+// counter_cache_size_in_mb allows.
+class counter_cache_tracker {
+public:
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+        uint64_t entries = 0;
+        uint64_t memory = 0;
+    };
+
+    class entry {
+        using lru_link_type = boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+        lru_link_type _lru_link;
+        counter_cache* _cache = nullptr;
+        const void* _key = nullptr;
+        size_t _size = 0;
+        int64_t _value = 0;
+        int64_t _logical_clock = 0;
+
+        friend class counter_cache_tracker;
+        friend class counter_cache;
+    };
+private:
+    using lru_type = boost::intrusive::list<entry,
+        boost::intrusive::member_hook<entry, entry::lru_link_type, &entry::_lru_link>,
+        boost::intrusive::constant_time_size<false>>;
+
+    lru_type _lru;
+    size_t _capacity;
+    stats _stats;
+public:
+    // The capacity is in bytes. A capacity of 0 disables the counter caches.
+    explicit counter_cache_tracker(size_t capacity) : _capacity(capacity) { }
+
+    size_t capacity() const noexcept { return _capacity; }
+    void set_capacity(size_t capacity);
+    bool enabled() const noexcept { return _capacity; }
+
+    const stats& get_stats() const noexcept { return _stats; }
+private:
+    void insert(entry& e);
+    void touch(entry& e);
+    void remove(entry& e) noexcept;
+    void evict();
+
+    friend class counter_cache;
+};
+
+// Caches the state of the local counter shards of the cells of a counter table,
+// that is the shards of the counters which are updated with this node as the
+// counter leader.
+//
+// No other node updates the local shards, so once a counter update was applied,
+// the state of the local shards of its cells is known without reading the
+// table. It's used to transform further counter updates of the same cells into
+// counter shards without the read-before-write.
+//
+// The state is invalidated whenever data which may contain the local shards
+// comes from elsewhere: on streaming and repair, or when the data of the table
+// is dropped, as by truncation or tablet cleanup.
+class counter_cache {
+    struct key {
+        dht::token token;
+        partition_key pk;
+        std::optional<clustering_key> ck;
+        column_id id;
+    };
+    // Allows looking entries up without copying the keys.
+    struct key_view {
+        dht::token token;
+        const partition_key& pk;
+        const clustering_key* ck;
+        column_id id;
+
+        key_view(const key& k) : token(k.token), pk(k.pk), ck(k.ck ? &*k.ck : nullptr), id(k.id) { }
+        key_view(dht::token t, const partition_key& pk, const clustering_key* ck, column_id id) : token(t), pk(pk), ck(ck), id(id) { }
+    };
+    struct key_hash {
+        using is_transparent = void;
+        size_t operator()(key_view k) const;
+    };
+    struct key_equal {
+        using is_transparent = void;
+        bool operator()(key_view a, key_view b) const;
+    };
+
+    counter_cache_tracker& _tracker;
+    std::unordered_map<key, counter_cache_tracker::entry, key_hash, key_equal> _entries;
+    // Incremented on every invalidation.
+    uint64_t _generation = 0;
+
+    friend class counter_cache_tracker;
+public:
+    explicit counter_cache(counter_cache_tracker& tracker) : _tracker(tracker) { }
+    ~counter_cache();
+
+    counter_cache(const counter_cache&) = delete;
+    counter_cache& operator=(const counter_cache&) = delete;
+
+    bool enabled() const noexcept { return _tracker.enabled(); }
+
+    // Must be read before the current state of the counters is obtained, and
+    // passed to update(), so that a state obtained before an invalidation
+    // isn't cached.
+    uint64_t generation() const noexcept { return _generation; }
+
+    // Transforms the counter update m from deltas to counter shards, like
+    // transform_counter_updates_to_shards(), using the cached state of the
+    // local shards of its cells.
+    //
+    // Returns false, without modifying m, unless the state of all the cells
+    // of m is cached, and m deletes nothing.
+    bool transform_counter_updates_to_shards(mutation& m, uint64_t clock_offset, locator::host_id local_id);
+
+    // Caches the state of the local shards of the cells of m, a counter update
+    // transformed into counter shards, after it was applied. Cells which m
+    // deletes are dropped from the cache; a partition or range tombstone
+    // drops the whole cache, as the cells it covers aren't known.
+    void update(const mutation& m, uint64_t generation, locator::host_id local_id);
+
+    // Drops the cells of m from the cache.
+    void invalidate(const mutation& m);
+    // Doesn't throw, so that it can be done atomically with adding an
+    // sstable to the table.
+    void invalidate(const dht::partition_range& range) noexcept;
+    void invalidate();
+
+    size_t entries() const noexcept { return _entries.size(); }
+private:
+    void erase(counter_cache_tracker::entry& e) noexcept;
+    void erase(key_view k) noexcept;
+    // Drops all the regular cells of the row, when the row is deleted.
+    void erase_row(const schema& s, dht::token token, const partition_key& pk, const clustering_key& ck) noexcept;
+    counter_cache_tracker::entry* find(key_view k);
+};
+
+}
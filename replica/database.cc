@@ -359,6 +359,11 @@ database::view_update_read_concurrency_sem() {
     return *sem;
 }
 
+// counter_cache_size_in_mb is the size for the whole node.
+static size_t counter_cache_capacity(uint32_t size_in_mb) {
+    return (size_t(size_in_mb) << 20) / smp::count;
+}
+
 database::database(const db::config& cfg, database_config dbcfg, service::migration_notifier& mn, gms::feature_service& feat, locator::shared_token_metadata& stm,
         compaction_manager& cm, sstables::storage_manager& sstm, lang::manager& langm, sstables::directory_semaphore& sst_dir_sem, sstable_compressor_factory& scf, const abort_source& abort, utils::cross_shard_barrier barrier)
     : _stats(make_lw_shared<db_stats>())
@@ -439,6 +444,10 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _stop_barrier(std::move(barrier))
     , _update_memtable_flush_static_shares_action([this, &cfg] { return _memtable_controller.update_static_shares(cfg.memtable_flush_static_shares()); })
     , _memtable_flush_static_shares_observer(cfg.memtable_flush_static_shares.observe(_update_memtable_flush_static_shares_action.make_observer()))
+    , _counter_cache_tracker(std::make_unique<counter_cache_tracker>(counter_cache_capacity(cfg.counter_cache_size_in_mb())))
+    , _counter_cache_size_observer(cfg.counter_cache_size_in_mb.observe([this] (uint32_t size_in_mb) {
+        _counter_cache_tracker->set_capacity(counter_cache_capacity(size_in_mb));
+    }))
 {
     SCYLLA_ASSERT(dbcfg.available_memory != 0); // Detect misconfigured unit tests, see #7544
 
@@ -667,6 +676,24 @@ database::setup_metrics() {
         sm::make_queue_length("counter_cell_lock_pending", _cl_stats->operations_waiting_for_lock,
                              sm::description("The number of counter updates waiting for a lock.")),
 
+        sm::make_counter("counter_cache_hits", [this] { return _counter_cache_tracker->get_stats().hits; },
+                       sm::description("The number of counter cells updated with this node as the leader, whose local shard was found in the counter cache.")),
+
+        sm::make_counter("counter_cache_misses", [this] { return _counter_cache_tracker->get_stats().misses; },
+                       sm::description("The number of counter cells updated with this node as the leader, whose local shard wasn't found in the counter cache.")),
+
+        sm::make_counter("counter_cache_evictions", [this] { return _counter_cache_tracker->get_stats().evictions; },
+                       sm::description("The number of entries evicted from the counter cache to keep it within counter_cache_size_in_mb.")),
+
+        sm::make_counter("counter_cache_invalidations", [this] { return _counter_cache_tracker->get_stats().invalidations; },
+                       sm::description("The number of entries removed from the counter cache because the local shards could have changed, as by streaming or repair.")),
+
+        sm::make_gauge("counter_cache_entries", [this] { return _counter_cache_tracker->get_stats().entries; },
+                       sm::description("The number of counter cells whose local shard is in the counter cache.")),
+
+        sm::make_gauge("counter_cache_bytes", [this] { return _counter_cache_tracker->get_stats().memory; },
+                       sm::description("The memory used by the counter cache, in bytes.")),
+
         sm::make_counter("large_partition_exceeding_threshold", [this] { return _large_data_handler->stats().partitions_bigger_than_threshold; },
             sm::description("Number of large partitions exceeding compaction_large_partition_warning_threshold_mb. "
                 "Large partitions have performance impact and should be avoided, check the documentation for details.")),
@@ -1439,8 +1466,10 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.tombstone_warn_threshold = db_config.tombstone_warn_threshold();
     cfg.view_update_concurrency_semaphore_limit = _config.view_update_concurrency_semaphore_limit;
     cfg.data_listeners = &db.data_listeners();
+    cfg.counter_cache_tracker = &db.get_counter_cache_tracker();
     cfg.enable_compacting_data_for_streaming_and_repair = db_config.enable_compacting_data_for_streaming_and_repair;
     cfg.enable_tombstone_gc_for_streaming_and_repair = db_config.enable_tombstone_gc_for_streaming_and_repair;
+    cfg.enable_partition_write_coalescing = db_config.enable_partition_write_coalescing;
 
     return cfg;
 }
@@ -1879,16 +1908,35 @@ future<mutation> database::do_apply_counter_update(column_family& cf, const froz
     // deltas to counter shards. To do that, we need to read the current
     // counter state for each modified cell...
 
-    tracing::trace(trace_state, "Reading counter values from the CF");
-    auto permit = get_reader_concurrency_semaphore().make_tracking_only_permit(cf.schema(), "counter-read-before-write", timeout, trace_state);
-    auto mopt = co_await counter_write_query(cf.schema(), cf.as_mutation_source(), std::move(permit), m.decorated_key(), slice, trace_state);
+    auto my_id = get_token_metadata().get_my_id();
+    // The cache is keyed by the column ids of the current schema.
+    auto* cache = m.schema() == cf.schema() ? cf.get_counter_cache() : nullptr;
+    auto cache_generation = cache ? cache->generation() : 0;
+    if (cache && cache->transform_counter_updates_to_shards(m, cf.failed_counter_applies_to_memtable(), my_id)) {
+        // The state of our shards of all the cells is cached, so there's
+        // no need to read it.
+        tracing::trace(trace_state, "Counter values found in the counter cache");
+    } else {
+        tracing::trace(trace_state, "Reading counter values from the CF");
+        auto permit = get_reader_concurrency_semaphore().make_tracking_only_permit(cf.schema(), "counter-read-before-write", timeout, trace_state);
+        auto mopt = co_await counter_write_query(cf.schema(), cf.as_mutation_source(), std::move(permit), m.decorated_key(), slice, trace_state);
 
-    // ...now, that we got existing state of all affected counter
-    // cells we can look for our shard in each of them, increment
-    // its clock and apply the delta.
-    transform_counter_updates_to_shards(m, mopt ? &*mopt : nullptr, cf.failed_counter_applies_to_memtable(), get_token_metadata().get_my_id());
+        // ...now, that we got existing state of all affected counter
+        // cells we can look for our shard in each of them, increment
+        // its clock and apply the delta.
+        transform_counter_updates_to_shards(m, mopt ? &*mopt : nullptr, cf.failed_counter_applies_to_memtable(), my_id);
+    }
     tracing::trace(trace_state, "Applying counter update");
-    co_await apply_with_commitlog(cf, m, timeout);
+    auto f = co_await coroutine::as_future(apply_with_commitlog(cf, m, timeout));
+    if (cache) {
+        if (f.failed()) {
+            // Whether the update was applied is unknown.
+            cache->invalidate(m);
+        } else {
+            cache->update(m, cache_generation, my_id);
+        }
+    }
+    co_await std::move(f);
 
     if (utils::get_local_injector().enter("apply_counter_update_delay_5s")) {
         co_await seastar::sleep(std::chrono::seconds(5));
@@ -71,6 +71,7 @@
 #include "compaction_group.hh"
 #include "service/qos/qos_configuration_change_subscriber.hh"
 #include "replica/tables_metadata_lock.hh"
+#include "replica/counter_cache.hh"
 
 class cell_locker;
 class cell_locker_stats;
@@ -391,6 +392,8 @@ struct table_stats {
     int64_t pending_sstable_deletions = 0;
     int64_t memtable_partition_insertions = 0;
     int64_t memtable_partition_hits = 0;
+    /** Number of writes merged into another write of the same partition before being applied to a memtable */
+    int64_t memtable_coalesced_writes = 0;
     int64_t memtable_range_tombstone_reads = 0;
     int64_t memtable_row_tombstone_reads = 0;
     int64_t tablet_count = 0;
@@ -459,10 +462,12 @@ class table : public enable_lw_shared_from_this<table>
         bool enable_node_aggregated_table_metrics = true;
         size_t view_update_concurrency_semaphore_limit;
         db::data_listeners* data_listeners = nullptr;
+        replica::counter_cache_tracker* counter_cache_tracker = nullptr;
         uint32_t tombstone_warn_threshold{0};
         unsigned x_log2_compaction_groups{0};
         utils::updateable_value<bool> enable_compacting_data_for_streaming_and_repair;
         utils::updateable_value<bool> enable_tombstone_gc_for_streaming_and_repair;
+        utils::updateable_value<bool> enable_partition_write_coalescing{false};
     };
 
     using snapshot_details = db::snapshot_ctl::table_snapshot_details;
@@ -485,6 +490,32 @@ class table : public enable_lw_shared_from_this<table>
     template<typename... Args>
     void do_apply(compaction_group& cg, db::rp_handle&&, Args&&... args);
 
+    // Writes to a single partition which arrived within the same task quota.
+    // They are merged and applied to the memtable at once (see config::enable_partition_write_coalescing).
+    struct pending_partition_write {
+        struct write {
+            const frozen_mutation* m; // nullptr once the write failed on its own
+            db::rp_handle h;
+            db::timeout_clock::time_point timeout;
+            promise<> applied;
+        };
+        schema_ptr s;
+        compaction_group& cg;
+        gate::holder cg_holder;
+        // The earliest deadline of the writes which didn't fail yet.
+        db::timeout_clock::time_point timeout;
+        std::vector<write> writes;
+    };
+    using pending_partition_writes = std::unordered_map<partition_key, lw_shared_ptr<pending_partition_write>, partition_key::hashing, partition_key::equality>;
+    pending_partition_writes _pending_partition_writes;
+    bool _pending_partition_writes_scheduled = false;
+
+    // Queues the write to be applied together with the other writes to its partition.
+    // Returns std::nullopt, leaving h untouched, if the write cannot be coalesced.
+    std::optional<future<>> try_coalesce_write(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle& h, db::timeout_clock::time_point timeout);
+    future<> apply_pending_partition_writes();
+    void do_apply_coalesced(pending_partition_write& w);
+
     lw_shared_ptr<memtable_list> make_memory_only_memtable_list();
     lw_shared_ptr<memtable_list> make_memtable_list(compaction_group& cg);
 
@@ -533,6 +564,8 @@ class table : public enable_lw_shared_from_this<table>
     std::vector<view_ptr> _views;
 
     std::unique_ptr<cell_locker> _counter_cell_locks; // Memory-intensive; allocate only when needed.
+    std::unique_ptr<counter_cache> _counter_cache; // Only for counter tables, like _counter_cell_locks.
+    uint64_t _data_generation = 0;
 
     // Labels used to identify writes and reads for this table in the rate_limiter structure.
     db::rate_limiter::label _rate_limiter_label_for_writes;
@@ -562,6 +595,14 @@ class table : public enable_lw_shared_from_this<table>
     lowres_clock::time_point _percentile_cache_timestamp;
     std::chrono::milliseconds _percentile_cache_value;
 
+    // Recent latency of reads of this table sent to each replica by the
+    // coordinator, for hedging reads (see adaptive_read_hedging).
+    struct replica_read_latency {
+        utils::estimated_histogram histogram;
+        lowres_clock::time_point last_decay;
+    };
+    std::unordered_map<locator::host_id, replica_read_latency> _replica_read_latencies;
+
     // Phaser used to synchronize with in-progress writes. This is useful for code that,
     // after some modification, needs to ensure that news writes will see it before
     // it can proceed, such as the view building code.
@@ -596,6 +637,14 @@ class table : public enable_lw_shared_from_this<table>
     }
     db_clock::time_point get_truncation_time() const;
 
+    // Changes whenever data comes into the table other than by writes, as by
+    // streaming, repair or loading sstables, or is dropped from it, as by
+    // truncation or cleanup. Lets caches of the contents of the table kept
+    // outside of it tell whether they may be stale.
+    uint64_t data_generation() const noexcept {
+        return _data_generation;
+    }
+
     void notify_bootstrap_or_replace_start();
 
     void notify_bootstrap_or_replace_end();
@@ -913,6 +962,17 @@ class table : public enable_lw_shared_from_this<table>
 
     future<std::vector<locked_cell>> lock_counter_cells(const mutation& m, db::timeout_clock::time_point timeout);
 
+    // The cache of the local counter shards, or nullptr if the table isn't
+    // a counter table or the counter cache is disabled.
+    counter_cache* get_counter_cache() noexcept {
+        return _counter_cache && _counter_cache->enabled() ? _counter_cache.get() : nullptr;
+    }
+    void invalidate_counter_cache() noexcept {
+        if (_counter_cache) {
+            _counter_cache->invalidate();
+        }
+    }
+
     logalloc::occupancy_stats occupancy() const;
 public:
     table(schema_ptr schema, config cfg, lw_shared_ptr<const storage_options> sopts, compaction_manager& cm, sstables::sstables_manager& sm, cell_locker_stats& cl_stats, cache_tracker& row_cache_tracker, locator::effective_replication_map_ptr erm);
@@ -1224,6 +1284,13 @@ class table : public enable_lw_shared_from_this<table>
     void add_coordinator_read_latency(utils::estimated_histogram::duration latency);
     std::chrono::milliseconds get_coordinator_read_latency_percentile(double percentile);
 
+    void add_replica_read_latency(locator::host_id ep, utils::estimated_histogram::duration latency);
+    // Returns the given percentile of the recent latency of reads of this
+    // table sent to the replica, or nullopt if too few of them were made.
+    std::optional<std::chrono::microseconds> get_replica_read_latency_percentile(locator::host_id ep, double percentile) const;
+    // Forgets the latency of reads sent to a replica which left the cluster.
+    void remove_replica_read_latency(locator::host_id ep);
+
     secondary_index::secondary_index_manager& get_index_manager() {
         return _index_manager;
     }
@@ -1640,6 +1707,9 @@ class database : public peering_sharded_service<database>, qos::qos_configuratio
     serialized_action _update_memtable_flush_static_shares_action;
     utils::observer<float> _memtable_flush_static_shares_observer;
 
+    std::unique_ptr<counter_cache_tracker> _counter_cache_tracker;
+    utils::observer<uint32_t> _counter_cache_size_observer;
+
     db_clock::time_point _all_tables_flushed_at;
 
 public:
@@ -2006,6 +2076,10 @@ class database : public peering_sharded_service<database>, qos::qos_configuratio
         return {max_memory_pending_view_updates() - _view_update_concurrency_sem.current(), max_memory_pending_view_updates()};
     }
 
+    counter_cache_tracker& get_counter_cache_tracker() const {
+        return *_counter_cache_tracker;
+    }
+
     db::data_listeners& data_listeners() const {
         return *_data_listeners;
     }
@@ -811,6 +811,26 @@ memtable::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_han
     update(std::move(h));
 }
 
+void
+memtable::apply(std::span<const frozen_mutation* const> ms, const schema_ptr& m_schema, std::span<db::rp_handle> hs) {
+    // Merge outside of LSA, the memtable allocating section may be retried.
+    mutation_partition mp(*m_schema);
+    mutation_application_stats app_stats;
+    for (auto* m : ms) {
+        mp.apply(*m_schema, m->partition(), *m_schema, app_stats);
+    }
+    with_allocator(allocator(), [&, this] {
+        _table_shared_data.allocating_section(*this, [&, this] {
+            auto& p = find_or_create_partition_slow(ms.front()->key());
+            _stats_collector.update(*m_schema, mp);
+            p.apply(region(), cleaner(), *_schema, mp, *m_schema, _table_stats.memtable_app_stats);
+        });
+    });
+    for (auto& h : hs) {
+        update(std::move(h));
+    }
+}
+
 logalloc::occupancy_stats memtable::occupancy() const noexcept {
     return logalloc::region::occupancy();
 }
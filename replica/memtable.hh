@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <span>
 #include <fmt/core.h>
 #include "replica/database_fwd.hh"
 #include "dht/decorated_key.hh"
@@ -238,6 +239,10 @@ class memtable final
     void apply(const mutation& m, db::rp_handle&& = {});
     // The mutation is upgraded to current schema.
     void apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle&& = {});
+    // Applies several mutations of the same partition, merging them first so that
+    // the memtable entry is only merged with once.
+    // The mutations are upgraded to current schema.
+    void apply(std::span<const frozen_mutation* const> ms, const schema_ptr& m_schema, std::span<db::rp_handle> hs);
     void evict_entry(memtable_entry& e, mutation_cleaner& cleaner) noexcept;
 
     static memtable& from_region(logalloc::region& r) noexcept {
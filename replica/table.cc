@@ -8,6 +8,7 @@
 
 #include <seastar/core/seastar.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/later.hh>
 #include <seastar/core/with_scheduling_group.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/coroutine/exception.hh>
@@ -1355,6 +1356,7 @@ future<>
 table::do_add_sstable_and_update_cache(compaction_group& cg, sstables::shared_sstable sst, sstables::offstrategy offstrategy,
                                        bool trigger_compaction) {
     auto permit = co_await seastar::get_units(_sstable_set_mutation_sem, 1);
+    auto range = dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true});
     co_return co_await get_row_cache().invalidate(row_cache::external_updater([&] () noexcept {
         // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
         // atomically load all opened sstables into column family.
@@ -1363,11 +1365,20 @@ table::do_add_sstable_and_update_cache(compaction_group& cg, sstables::shared_ss
         } else {
             add_maintenance_sstable(cg, sst);
         }
+        // The new sstable comes from streaming or repair, and may hold newer
+        // data than that cached outside of the table, like the local counter
+        // shards, or paxos state. This has to happen together with adding it:
+        // a read which started before that mustn't cache what it read, and
+        // one which comes after it mustn't find anything cached from before.
+        if (_counter_cache) {
+            _counter_cache->invalidate(range);
+        }
+        ++_data_generation;
         update_stats_for_new_sstable(sst);
         if (trigger_compaction) {
             try_trigger_compaction(cg);
         }
-    }), dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true}));
+    }), range);
 }
 
 future<>
@@ -1778,6 +1789,7 @@ void table::set_metrics() {
                 ms::make_counter("memtable_switch", ms::description("Number of times flush has resulted in the memtable being switched out"), _stats.memtable_switch_count)(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_partition_writes", [this] () { return _stats.memtable_partition_insertions + _stats.memtable_partition_hits; }, ms::description("Number of write operations performed on partitions in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_partition_hits", _stats.memtable_partition_hits, ms::description("Number of times a write operation was issued on an existing partition in memtables"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("memtable_coalesced_writes", _stats.memtable_coalesced_writes, ms::description("Number of write operations merged with another write to the same partition before being applied to memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_row_writes", _stats.memtable_app_stats.row_writes, ms::description("Number of row writes performed in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_row_hits", _stats.memtable_app_stats.row_hits, ms::description("Number of rows overwritten by write operations in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_rows_dropped_by_tombstones", _stats.memtable_app_stats.rows_dropped_by_tombstones, ms::description("Number of rows dropped in memtables by a tombstone write"))(cf)(ks).set_skip_when_empty(),
@@ -2676,6 +2688,7 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
                          keyspace_label(_schema->ks_name()),
                          column_family_label(_schema->cf_name())
                         )
+    , _pending_partition_writes(0, partition_key::hashing(*_schema), partition_key::equality(*_schema))
     , _compaction_manager(compaction_manager)
     , _compaction_strategy(make_compaction_strategy(_schema->compaction_strategy(), _schema->compaction_strategy_options()))
     , _sg_manager(make_storage_group_manager())
@@ -2689,6 +2702,7 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
     , _index_manager(this->as_data_dictionary())
     , _flush_barrier(format("[table {}.{}] flush_barrier", _schema->ks_name(), _schema->cf_name()))
     , _counter_cell_locks(_schema->is_counter() ? std::make_unique<cell_locker>(_schema, cl_stats) : nullptr)
+    , _counter_cache(_schema->is_counter() && _config.counter_cache_tracker ? std::make_unique<counter_cache>(*_config.counter_cache_tracker) : nullptr)
     , _async_gate(format("[table {}.{}] async_gate", _schema->ks_name(), _schema->cf_name()))
     , _pending_writes_phaser(format("[table {}.{}] pending_writes", _schema->ks_name(), _schema->cf_name()))
     , _pending_reads_phaser(format("[table {}.{}] pending_reads", _schema->ks_name(), _schema->cf_name()))
@@ -3344,6 +3358,8 @@ future<> table::clear() {
     co_await parallel_foreach_compaction_group(std::mem_fn(&compaction_group::clear_memtables));
 
     co_await _cache.invalidate(row_cache::external_updater([] { /* There is no underlying mutation source */ }));
+    invalidate_counter_cache();
+    ++_data_generation;
 }
 
 bool storage_group::compaction_disabled() const {
@@ -3413,6 +3429,8 @@ future<db::replay_position> table::discard_sstables(db_clock::time_point truncat
         refresh_compound_sstable_set();
         tlogger.debug("cleaning out row cache");
     }));
+    invalidate_counter_cache();
+    ++_data_generation;
     rebuild_statistics();
 
     std::vector<sstables::shared_sstable> del;
@@ -3463,6 +3481,8 @@ void table::set_schema(schema_ptr s) {
     if (_counter_cell_locks) {
         _counter_cell_locks->set_schema(s);
     }
+    // Column ids may have changed.
+    invalidate_counter_cache();
     _schema = std::move(s);
 
     for (auto&& v : _views) {
@@ -3691,6 +3711,12 @@ future<> table::apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_hand
         return (*_virtual_writer)(m);
     }
 
+    if (_config.enable_partition_write_coalescing() && !_async_gate.is_closed()) {
+        if (auto f = try_coalesce_write(m, m_schema, h, timeout)) {
+            return std::move(*f);
+        }
+    }
+
     auto& cg = compaction_group_for_key(m.key(), m_schema);
     auto holder = cg.async_gate().hold();
 
@@ -3701,6 +3727,124 @@ future<> table::apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_hand
 
 template void table::do_apply(compaction_group& cg, db::rp_handle&&, const frozen_mutation&, const schema_ptr&);
 
+std::optional<future<>> table::try_coalesce_write(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle& h, db::timeout_clock::time_point timeout) {
+    auto key = m.key();
+    auto it = _pending_partition_writes.find(key);
+    if (it == _pending_partition_writes.end()) {
+        auto& cg = compaction_group_for_key(key, m_schema);
+        auto w = make_lw_shared<pending_partition_write>(m_schema, cg, cg.async_gate().hold(), timeout);
+        it = _pending_partition_writes.emplace(std::move(key), std::move(w)).first;
+        if (!_pending_partition_writes_scheduled) {
+            _pending_partition_writes_scheduled = true;
+            // Let the writes queued in the current task quota join before applying them.
+            (void)yield().then([this] {
+                return apply_pending_partition_writes();
+            }).finally([holder = _async_gate.hold()] {});
+        }
+    } else if (it->second->s != m_schema) {
+        // Merging requires a common schema, which is rarely not the case.
+        return std::nullopt;
+    }
+
+    auto& w = *it->second;
+    w.timeout = std::min(w.timeout, timeout);
+    auto& write = w.writes.emplace_back(&m, std::move(h), timeout);
+    return write.applied.get_future();
+}
+
+future<> table::apply_pending_partition_writes() {
+    _pending_partition_writes_scheduled = false;
+    auto writes = std::exchange(_pending_partition_writes, pending_partition_writes(0, partition_key::hashing(*_schema), partition_key::equality(*_schema)));
+
+    co_await coroutine::parallel_for_each(writes, [this] (auto& key_and_write) -> future<> {
+        auto w = key_and_write.second;
+        // The writes wait for memory until the earliest of their deadlines.
+        // If it passes, the writes which expired fail, and the others keep
+        // waiting until their own deadlines.
+        while (true) {
+            auto f = co_await coroutine::as_future(dirty_memory_region_group().run_when_memory_available([this, w] {
+                do_apply_coalesced(*w);
+            }, w->timeout));
+            if (!f.failed()) {
+                co_return;
+            }
+            auto ex = f.get_exception();
+            const bool timed_out = bool(try_catch<seastar::timed_out_error>(ex));
+            const auto now = db::timeout_clock::now();
+            w->timeout = db::timeout_clock::time_point::max();
+            for (auto& write : w->writes) {
+                if (!write.m) {
+                    continue;
+                }
+                if (!timed_out || write.timeout <= now) {
+                    write.applied.set_exception(ex);
+                    write.m = nullptr;
+                } else {
+                    w->timeout = std::min(w->timeout, write.timeout);
+                }
+            }
+            if (w->timeout == db::timeout_clock::time_point::max()) {
+                co_return;
+            }
+        }
+    });
+}
+
+void table::do_apply_coalesced(pending_partition_write& w) {
+    if (w.writes.size() == 1) {
+        auto& write = w.writes.front();
+        if (!write.m) {
+            return;
+        }
+        do_apply(w.cg, std::move(write.h), *write.m, w.s);
+        write.applied.set_value();
+        return;
+    }
+
+    utils::latency_counter lc;
+    _stats.writes.set_latency(lc);
+    std::vector<const frozen_mutation*> ms;
+    std::vector<db::rp_handle> hs;
+    ms.reserve(w.writes.size());
+    hs.reserve(w.writes.size());
+    db::replay_position highest_rp;
+    for (auto& write : w.writes) {
+        if (!write.m) {
+            // It failed already, while waiting for memory.
+            continue;
+        }
+        db::replay_position rp = write.h;
+        try {
+            check_valid_rp(rp);
+        } catch (...) {
+            write.applied.set_exception(std::current_exception());
+            write.m = nullptr;
+            continue;
+        }
+        ms.push_back(write.m);
+        hs.push_back(std::move(write.h));
+        highest_rp = std::max(highest_rp, rp);
+    }
+    if (ms.empty()) {
+        return;
+    }
+
+    try {
+        w.cg.memtables()->active_memtable().apply(ms, w.s, hs);
+        _highest_rp = std::max(_highest_rp, highest_rp);
+    } catch (...) {
+        _failed_counter_applies_to_memtable++;
+        throw;
+    }
+    _stats.memtable_coalesced_writes += ms.size() - 1;
+    for (auto& write : w.writes) {
+        if (write.m) {
+            _stats.writes.mark(lc);
+            write.applied.set_value();
+        }
+    }
+}
+
 future<>
 write_memtable_to_sstable(mutation_reader reader,
                           memtable& mt, sstables::shared_sstable sst,
@@ -3882,6 +4026,31 @@ std::chrono::milliseconds table::get_coordinator_read_latency_percentile(double
     return _percentile_cache_value;
 }
 
+void table::add_replica_read_latency(locator::host_id ep, utils::estimated_histogram::duration latency) {
+    auto& l = _replica_read_latencies[ep];
+    auto now = lowres_clock::now();
+    if (now - l.last_decay > 1s) {
+        // Halve the weight of older reads every second, so that the
+        // histogram follows the recent latency of the replica.
+        l.histogram *= 0.5;
+        l.last_decay = now;
+    }
+    l.histogram.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+}
+
+std::optional<std::chrono::microseconds> table::get_replica_read_latency_percentile(locator::host_id ep, double percentile) const {
+    static constexpr int64_t min_samples = 20;
+    auto it = _replica_read_latencies.find(ep);
+    if (it == _replica_read_latencies.end() || it->second.histogram.count() < min_samples) {
+        return std::nullopt;
+    }
+    return std::chrono::microseconds(it->second.histogram.percentile(percentile));
+}
+
+void table::remove_replica_read_latency(locator::host_id ep) {
+    _replica_read_latencies.erase(ep);
+}
+
 void
 table::enable_auto_compaction() {
     // FIXME: unmute backlog. turn table backlog back on.
@@ -4266,6 +4435,10 @@ future<> compaction_group::cleanup() {
     // Since permit is still held, all actions below will be executed atomically:
     co_await _t._cache.invalidate(std::move(updater), p_range);
     _t._cache.refresh_snapshot();
+    if (_t._counter_cache) {
+        _t._counter_cache->invalidate(p_range);
+    }
+    ++_t._data_generation;
 
     co_await _t.delete_sstables_atomically(permit, _sstables_compacted_but_not_deleted);
     // Clearing sstables_compacted_but_not_deleted only on success allows a retry caused
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include <seastar/core/shared_ptr.hh>
+
+#include "mutation/frozen_mutation.hh"
+#include "db/per_partition_rate_limit_info.hh"
+#include "service/topology_state_machine.hh"
+
+namespace service {
+
+// A write sent to a replica in a MUTATION_BATCH message, together with other
+// writes sent to the same replica at about the same time.
+//
+// The replica applies and acknowledges each of the writes separately, by the
+// response_id of the write, as if it was sent in a MUTATION message of its own.
+struct batched_mutation {
+    seastar::lw_shared_ptr<const frozen_mutation> fm;
+    uint64_t response_id;
+    db::per_partition_rate_limit::info rate_limit_info;
+    fencing_token fence;
+    // How long before the timeout of the message the write times out.
+    std::chrono::milliseconds expires_before{0};
+};
+
+}
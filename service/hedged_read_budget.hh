@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <algorithm>
+
+namespace service {
+
+// Caps the rate of hedged (speculative) reads, so that hedging doesn't
+// amplify an overload, when many reads are slow.
+//
+// Each read which may be hedged earns a fraction of a token (see
+// read_hedging_budget), and each hedge spends a whole one. Tokens accumulate
+// up to a limit, which bounds the burst of hedges after a quiet period.
+class hedged_read_budget {
+    double _tokens = 0;
+    double _max_tokens;
+public:
+    explicit hedged_read_budget(double max_tokens) noexcept : _max_tokens(max_tokens) {}
+
+    void earn(double tokens) noexcept {
+        _tokens = std::min(_tokens + tokens, _max_tokens);
+    }
+
+    // Spends a token for a hedge. Returns false, without spending anything,
+    // if the budget is exhausted and the read shouldn't be hedged.
+    bool try_spend() noexcept {
+        if (_tokens < 1) {
+            return false;
+        }
+        _tokens -= 1;
+        return true;
+    }
+};
+
+}
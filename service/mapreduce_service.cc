@@ -47,6 +47,10 @@
 #include "cql3/functions/functions.hh"
 #include "cql3/functions/aggregate_fcts.hh"
 #include "cql3/expr/expr-utils.hh"
+#include "cql3/prepare_context.hh"
+#include "cql3/restrictions/statement_restrictions.hh"
+#include "db/marshal/type_parser.hh"
+#include "types/map.hh"
 
 namespace service {
 
@@ -59,10 +63,15 @@ class mapreduce_aggregates {
 private:
     std::vector<::shared_ptr<db::functions::aggregate_function>> _funcs;
     std::vector<db::functions::stateless_aggregate_function> _aggrs;
+    std::optional<query::mapreduce_request::group_by_info> _group_by;
 public:
     mapreduce_aggregates(const query::mapreduce_request& request);
     void merge(query::mapreduce_result& result, query::mapreduce_result&& other);
     void finalize(query::mapreduce_result& result);
+private:
+    void merge_groups(query::mapreduce_result& result, query::mapreduce_result&& other);
+    void finalize_groups(query::mapreduce_result& result);
+public:
 
     template<typename Func>
     auto with_thread_if_needed(Func&& func) const {
@@ -80,7 +89,9 @@ class mapreduce_aggregates {
     }
 };
 
-mapreduce_aggregates::mapreduce_aggregates(const query::mapreduce_request& request) {
+mapreduce_aggregates::mapreduce_aggregates(const query::mapreduce_request& request)
+    : _group_by(request.group_by)
+{
     _funcs = get_functions(request);
     std::vector<db::functions::stateless_aggregate_function> aggrs;
 
@@ -91,6 +102,10 @@ mapreduce_aggregates::mapreduce_aggregates(const query::mapreduce_request& reque
 }
 
 void mapreduce_aggregates::merge(query::mapreduce_result &result, query::mapreduce_result&& other) {
+    if (_group_by) {
+        merge_groups(result, std::move(other));
+        return;
+    }
     if (result.query_results.empty()) {
         result.query_results = std::move(other.query_results);
         return;
@@ -114,7 +129,64 @@ void mapreduce_aggregates::merge(query::mapreduce_result &result, query::mapredu
     }
 }
 
+// Partial results of grouped aggregations cover disjoint sets of groups (see
+// query::mapreduce_request::group_by_info), so their states don't need to be
+// reduced, only the number of groups to be checked.
+void mapreduce_aggregates::merge_groups(query::mapreduce_result& result, query::mapreduce_result&& other) {
+    if (result.group_limit_exceeded) {
+        return;
+    }
+    if (other.group_limit_exceeded) {
+        result = std::move(other);
+        return;
+    }
+    if (!other.grouped_query_results) {
+        return;
+    }
+    if (!result.grouped_query_results) {
+        result.grouped_query_results = std::move(other.grouped_query_results);
+    } else {
+        std::ranges::move(*other.grouped_query_results, std::back_inserter(*result.grouped_query_results));
+    }
+    if (result.grouped_query_results->size() > _group_by->max_groups) {
+        result = query::mapreduce_result{ .group_limit_exceeded = true };
+    }
+}
+
+void mapreduce_aggregates::finalize_groups(query::mapreduce_result& result) {
+    if (result.group_limit_exceeded) {
+        return;
+    }
+    if (!result.grouped_query_results) {
+        // No group was seen, e.g. because the query matched no partition.
+        result.grouped_query_results.emplace();
+        return;
+    }
+    const size_t first_state = _group_by->column_names.size();
+    for (auto& row : *result.grouped_query_results) {
+        if (row.size() != first_state + _aggrs.size()) {
+            on_internal_error(
+                flogger,
+                format("mapreduce_aggregates::finalize_groups(): operation cannot be completed due to invalid argument sizes. "
+                        "this.aggrs.size(): {} "
+                        "group_by.column_names.size(): {} "
+                        "row.size(): {} ",
+                        _aggrs.size(), first_state, row.size())
+            );
+        }
+        for (size_t i = 0; i < _aggrs.size(); i++) {
+            if (_aggrs[i].state_to_result_function) {
+                row[first_state + i] = _aggrs[i].state_to_result_function->execute(std::vector({std::move(row[first_state + i])}));
+            }
+        }
+    }
+}
+
 void mapreduce_aggregates::finalize(query::mapreduce_result &result) {
+    if (_group_by) {
+        finalize_groups(result);
+        return;
+    }
     if (result.query_results.empty()) {
         // An empty result means that we didn't send the aggregation request
         // to any node. I.e., it was a query that matched no partition, such
@@ -339,18 +411,27 @@ static shared_ptr<cql3::selection::selection> mock_selection(
 
     auto functions = get_functions(request);
 
+    auto name_as_expression = [] (const sstring& name) -> cql3::expr::expression {
+        constexpr bool keep_case = true;
+        return cql3::expr::unresolved_identifier {
+            make_shared<cql3::column_identifier_raw>(name, keep_case)
+        };
+    };
+
+    // Grouping columns are selected first, followed by the reductions.
+    if (request.group_by) {
+        for (const auto& name : request.group_by->column_names) {
+            auto prepared_expr = cql3::expr::prepare_expression(name_as_expression(name), db.as_data_dictionary(), "", schema.get(), nullptr);
+            auto column_identifier = make_shared<cql3::column_identifier>(name, true);
+            prepared_selectors.emplace_back(cql3::selection::prepared_selector{std::move(prepared_expr), column_identifier});
+        }
+    }
+
     auto mock_singular_selection = [&] (
         const ::shared_ptr<db::functions::aggregate_function>& aggr_function,
         const query::mapreduce_request::reduction_type& reduction,
         const std::optional<query::mapreduce_request::aggregation_info>& info
     ) {
-        auto name_as_expression = [] (const sstring& name) -> cql3::expr::expression {
-            constexpr bool keep_case = true;
-            return cql3::expr::unresolved_identifier {
-                make_shared<cql3::column_identifier_raw>(name, keep_case)
-            };
-        };
-
         if (reduction == query::mapreduce_request::reduction_type::count) {
             auto count_expr = cql3::expr::function_call{
                 .func = cql3::functions::aggregate_fcts::make_count_rows_function(),
@@ -380,6 +461,64 @@ static shared_ptr<cql3::selection::selection> mock_selection(
     return cql3::selection::selection::from_selectors(db.as_data_dictionary(), schema, schema->ks_name(), std::move(prepared_selectors));
 }
 
+// Rebuilds the restrictions sent by the coordinator, see query::mapreduce_request::filter_restriction.
+static cql3::expr::expression filter_to_where_clause(const std::vector<query::mapreduce_request::filter_restriction>& filter, const schema& schema) {
+    std::vector<cql3::expr::expression> restrictions;
+    restrictions.reserve(filter.size());
+    for (const auto& f : filter) {
+        auto cdef = schema.get_column_definition(to_bytes(f.column_name));
+        if (!cdef) {
+            throw std::runtime_error(format("mapreduce filter references unknown column {}", f.column_name));
+        }
+        cql3::expr::expression lhs = cql3::expr::column_value(cdef);
+        if (f.subscript) {
+            const auto& type = cdef->type->without_reversed();
+            auto key_type = type.is_map() ? static_cast<const map_type_impl&>(type).get_keys_type() : int32_type;
+            lhs = cql3::expr::subscript{
+                .val = std::move(lhs),
+                .sub = cql3::expr::constant(cql3::raw_value::make_value(*f.subscript), std::move(key_type)),
+            };
+        }
+        auto value = f.value ? cql3::raw_value::make_value(*f.value) : cql3::raw_value::make_null();
+        restrictions.emplace_back(cql3::expr::binary_operator(std::move(lhs), static_cast<cql3::expr::oper_t>(f.op),
+                cql3::expr::constant(std::move(value), db::marshal::type_parser::parse(f.value_type))));
+    }
+    return cql3::expr::conjunction{std::move(restrictions)};
+}
+
+// Prepares the restrictions of a request which needs filtering and adds the
+// columns needed to evaluate them to the selection. They are added after the
+// reductions, so they aren't part of the shard's result.
+static ::shared_ptr<const cql3::restrictions::statement_restrictions> prepare_filtering_restrictions(
+    const query::mapreduce_request& request,
+    schema_ptr schema,
+    replica::database& db,
+    cql3::selection::selection& selection
+) {
+    if (!request.filter) {
+        return nullptr;
+    }
+    auto where_clause = filter_to_where_clause(*request.filter, *schema);
+    cql3::prepare_context ctx;
+    auto restrictions = ::make_shared<cql3::restrictions::statement_restrictions>(cql3::restrictions::analyze_statement_restrictions(
+        db.as_data_dictionary(),
+        schema,
+        cql3::statements::statement_type::SELECT,
+        where_clause,
+        ctx,
+        selection.contains_only_static_columns(),
+        false, // for_view
+        true, // allow_filtering
+        cql3::restrictions::check_indexes::no
+    ));
+    for (auto&& cdef : restrictions->get_column_defs_for_filtering(db.as_data_dictionary())) {
+        if (!selection.has_column(*cdef)) {
+            selection.add_column_for_post_processing(*cdef);
+        }
+    }
+    return restrictions;
+}
+
 future<query::mapreduce_result> mapreduce_service::dispatch_to_shards(
     query::mapreduce_request req,
     std::optional<tracing::trace_info> tr_info
@@ -448,6 +587,7 @@ future<query::mapreduce_result> mapreduce_service::execute_on_this_shard(
     auto now = gc_clock::now();
 
     auto selection = mock_selection(req, schema, _db.local());
+    auto filtering_restrictions = prepare_filtering_restrictions(req, schema, _db.local(), *selection);
     auto query_state = make_lw_shared<service::query_state>(
         client_state::for_internal_calls(),
         tr_state,
@@ -462,12 +602,21 @@ future<query::mapreduce_result> mapreduce_service::execute_on_this_shard(
         cql3::query_options::specific_options::DEFAULT
     );
 
+    std::vector<size_t> group_by_cell_indices;
+    if (req.group_by) {
+        for (const auto& name : req.group_by->column_names) {
+            group_by_cell_indices.push_back(selection->index_of(*schema->get_column_definition(to_bytes(name))));
+        }
+    }
     auto rs_builder = cql3::selection::result_set_builder(
         *selection,
         now,
         nullptr,
-        std::vector<size_t>() // Represents empty GROUP BY indices.
+        std::move(group_by_cell_indices)
     );
+    // Set when the groups seen by this shard alone exceed the limit, in which
+    // case there is no point in reading further.
+    bool group_limit_exceeded = false;
 
     // We serve up to 256 ranges at a time to avoid allocating a huge vector for ranges
     static constexpr size_t max_ranges = 256;
@@ -496,11 +645,11 @@ future<query::mapreduce_result> mapreduce_service::execute_on_this_shard(
             *query_options,
             make_lw_shared<query::read_command>(req.cmd),
             std::move(ranges_owned_by_this_shard),
-            nullptr // No filtering restrictions
+            filtering_restrictions
         );
 
         // Execute query.
-        while (!pager->is_exhausted()) {
+        while (!pager->is_exhausted() && !group_limit_exceeded) {
             // It is necessary to check for a shutdown request before each
             // fetch_page operation. During the drain process, the messaging
             // service is shut down early (but not earlier than the
@@ -512,23 +661,41 @@ future<query::mapreduce_result> mapreduce_service::execute_on_this_shard(
             }
 
             co_await pager->fetch_page(rs_builder, DEFAULT_INTERNAL_PAGING_SIZE, now, timeout);
+            group_limit_exceeded = req.group_by && rs_builder.result_set_size() > req.group_by->max_groups;
         }
 
         ranges_owned_by_this_shard.clear();
-    } while (current_range);
+    } while (current_range && !group_limit_exceeded);
+
+    if (group_limit_exceeded) {
+        tracing::trace(tr_state, "On shard execution exceeded the limit of {} groups", req.group_by->max_groups);
+        flogger.debug("on shard execution exceeded the limit of {} groups", req.group_by->max_groups);
+        co_return query::mapreduce_result{ .group_limit_exceeded = true };
+    }
 
     co_return co_await rs_builder.with_thread_if_needed([&req, &rs_builder, reductions = req.reduction_types, tr_state = std::move(tr_state)] {
         auto rs = rs_builder.build();
         auto& rows = rs->rows();
+        // Drop the columns retrieved only for filtering.
+        const size_t columns = (req.group_by ? req.group_by->column_names.size() : 0) + reductions.size();
+        auto to_result_row = [columns] (const auto& row) {
+            return row | std::views::take(columns) | std::views::transform([] (const managed_bytes_opt& x) { return to_bytes_opt(x); }) | std::ranges::to<std::vector<bytes_opt>>();
+        };
+        if (req.group_by) {
+            query::mapreduce_result res = { .grouped_query_results = rows | std::views::transform(to_result_row) | std::ranges::to<std::vector<std::vector<bytes_opt>>>() };
+            tracing::trace(tr_state, "On shard execution result has {} groups", res.grouped_query_results->size());
+            flogger.debug("on shard execution result has {} groups", res.grouped_query_results->size());
+            return res;
+        }
         if (rows.size() != 1) {
             flogger.error("aggregation result row count != 1");
             throw std::runtime_error("aggregation result row count != 1");
         }
-        if (rows[0].size() != reductions.size()) {
+        if (rows[0].size() < reductions.size()) {
             flogger.error("aggregation result column count does not match requested column count");
             throw std::runtime_error("aggregation result column count does not match requested column count");
         }
-        query::mapreduce_result res = { .query_results = rows[0] | std::views::transform([] (const managed_bytes_opt& x) { return to_bytes_opt(x); }) | std::ranges::to<std::vector<bytes_opt>>() };
+        query::mapreduce_result res = { .query_results = to_result_row(rows[0]) };
 
         auto printer = seastar::value_of([&req, &res] {
             return query::mapreduce_result::printer {
@@ -556,6 +723,10 @@ future<> mapreduce_service::uninit_messaging_service() {
     return ser::mapreduce_request_rpc_verbs::unregister(&_messaging);
 }
 
+static bool is_empty(const query::mapreduce_result& result) {
+    return result.query_results.empty() && !result.grouped_query_results && !result.group_limit_exceeded;
+}
+
 future<> mapreduce_service::dispatch_range_and_reduce(const locator::effective_replication_map_ptr& erm, retrying_dispatcher& dispatcher, const query::mapreduce_request& req, query::mapreduce_request&& req_with_modified_pr, locator::host_id addr, query::mapreduce_result& shared_accumulator, tracing::trace_state_ptr tr_state) {
     tracing::trace(tr_state, "Sending mapreduce_request to {}", addr);
     flogger.debug("dispatching mapreduce_request={} to address={}", req_with_modified_pr, addr);
@@ -574,7 +745,7 @@ future<> mapreduce_service::dispatch_range_and_reduce(const locator::effective_r
     // Anytime this coroutine yields, other coroutines may want to write to `shared_accumulator`.
     // As merging can yield internally, merging directly to `shared_accumulator` would result in race condition.
     // We can safely write to `shared_accumulator` only when it is empty.
-    while (!shared_accumulator.query_results.empty()) {
+    while (!is_empty(shared_accumulator)) {
         // Move `shared_accumulator` content to local variable. Leave `shared_accumulator` empty - now other coroutines can safely write to it.
         query::mapreduce_result previous_results = std::exchange(shared_accumulator, {});
         // Merge two local variables - it can yield.
@@ -782,6 +953,60 @@ future<> mapreduce_service::dispatch_to_tablets(schema_ptr schema, replica::colu
     co_await algorithm.dispatch_work_and_wait_to_finish();
 }
 
+// Groups are gathered from all shards in no particular order. Sort them into the
+// order in which a regular query returns them: by partition, in ring order, then
+// by the grouping clustering columns.
+static future<> sort_groups(const schema& s, const query::mapreduce_request::group_by_info& group_by, std::vector<std::vector<bytes_opt>>& groups) {
+    const size_t pk_size = s.partition_key_size();
+    std::vector<data_type> clustering_types;
+    for (const auto& name : group_by.column_names | std::views::drop(pk_size)) {
+        clustering_types.push_back(s.get_column_definition(to_bytes(name))->type);
+    }
+
+    std::vector<std::pair<dht::decorated_key, size_t>> keys;
+    keys.reserve(groups.size());
+    for (size_t i = 0; i < groups.size(); i++) {
+        auto pk = partition_key::from_exploded(s, groups[i] | std::views::take(pk_size) | std::views::transform([&] (const bytes_opt& v) {
+            if (!v) {
+                on_internal_error(flogger, format("sort_groups(): group of {}.{} has a null partition key component", s.ks_name(), s.cf_name()));
+            }
+            return *v;
+        }) | std::ranges::to<std::vector<bytes>>());
+        keys.emplace_back(dht::decorate_key(s, std::move(pk)), i);
+        co_await coroutine::maybe_yield();
+    }
+    std::ranges::sort(keys, [&] (const auto& a, const auto& b) {
+        if (auto c = a.first.tri_compare(s, b.first); c != 0) {
+            return c < 0;
+        }
+        const auto& ga = groups[a.second];
+        const auto& gb = groups[b.second];
+        // A group made of a static row only has null clustering columns,
+        // and comes first in its partition.
+        for (size_t i = 0; i < clustering_types.size(); i++) {
+            const auto& va = ga[pk_size + i];
+            const auto& vb = gb[pk_size + i];
+            if (!va || !vb) {
+                if (bool(va) != bool(vb)) {
+                    return !va;
+                }
+                continue;
+            }
+            if (auto c = clustering_types[i]->compare(*va, *vb); c != 0) {
+                return c < 0;
+            }
+        }
+        return false;
+    });
+
+    std::vector<std::vector<bytes_opt>> sorted;
+    sorted.reserve(groups.size());
+    for (auto& [_, i] : keys) {
+        sorted.push_back(std::move(groups[i]));
+    }
+    groups = std::move(sorted);
+}
+
 future<query::mapreduce_result> mapreduce_service::dispatch(query::mapreduce_request req, tracing::trace_state_ptr tr_state) {
     schema_ptr schema = local_schema_registry().get(req.cmd.schema_version);
     replica::table& cf = _db.local().find_column_family(schema);
@@ -810,10 +1035,15 @@ future<query::mapreduce_result> mapreduce_service::dispatch(query::mapreduce_req
         return result;
     };
     if (requires_thread) {
-        co_return co_await seastar::async(std::move(merge_result));
+        result = co_await seastar::async(std::move(merge_result));
     } else {
-        co_return merge_result();
+        result = merge_result();
+    }
+
+    if (result.grouped_query_results) {
+        co_await sort_groups(*schema, *req.group_by, *result.grouped_query_results);
     }
+    co_return result;
 }
 
 void mapreduce_service::register_metrics() {
@@ -137,6 +137,18 @@ class query_pager {
         return _max;
     }
 
+    /**
+     * Applies the row limit of the query to each partition separately,
+     * instead of to all of them together. Used when the caller keeps only
+     * the first rows of all partitions in some order other than the token
+     * order, so every partition may have to contribute up to the limit.
+     * Must be called before the first page is fetched.
+     */
+    void apply_row_limit_per_partition() {
+        _per_partition_limit = std::min(_per_partition_limit, _max);
+        _max = query::max_rows;
+    }
+
     /**
      * Get the current state (snapshot) of the pager. The state can allow to restart the
      * paging on another host from where we are at this point.
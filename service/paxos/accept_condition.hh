@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include "query-request.hh"
+#include "query-result.hh"
+#include "utils/UUID.hh"
+
+namespace service::paxos {
+
+// Sent along with a proposal which was made on a lease (see lease), rather
+// than on a ballot prepared by the request which makes it.
+//
+// The replica accepts the proposal only if the ballot it promised last is
+// still promised_ballot, the ballot of the lease, and the value of the key,
+// read with cmd, still has the digest the proposal was computed from. As the
+// replica saw no other ballot in the meantime, accepting the proposal is then
+// as safe as if its ballot was prepared right before it.
+struct accept_condition {
+    utils::UUID promised_ballot;
+    query::read_command cmd;
+    query::digest_algorithm digest_algorithm;
+    query::result_digest digest;
+};
+
+}
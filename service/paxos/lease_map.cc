@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include "service/paxos/lease_map.hh"
+
+#include "utils/hash.hh"
+
+namespace service::paxos {
+
+size_t lease_map::key_hash::operator()(const key& k) const {
+    return utils::hash_combine(std::hash<table_id>()(k.table), std::hash<dht::decorated_key>()(k.dk));
+}
+
+bool lease_map::key_equal::operator()(const key& a, const key& b) const {
+    return a.table == b.table
+        && a.dk.token() == b.dk.token()
+        && a.dk.key().representation() == b.dk.key().representation();
+}
+
+void lease_map::insert(table_id table, const dht::decorated_key& dk, lease l) {
+    expire(db::timeout_clock::now());
+    auto it = _leases.try_emplace(key{table, dk}).first;
+    auto& e = it->second;
+    e.k = &it->first;
+    e.lease = std::move(l);
+    e.lru_link.unlink();
+    _lru.push_back(e);
+    while (_leases.size() > _max_leases) {
+        _leases.erase(_leases.find(*_lru.front().k));
+    }
+}
+
+std::optional<lease> lease_map::take(table_id table, const dht::decorated_key& dk, db::timeout_clock::time_point now) {
+    expire(now);
+    auto it = _leases.find(key{table, dk});
+    if (it == _leases.end()) {
+        return std::nullopt;
+    }
+    auto l = std::move(it->second.lease);
+    _leases.erase(it);
+    return l;
+}
+
+void lease_map::expire(db::timeout_clock::time_point now) {
+    // The leases are inserted in the order they expire in, unless the lease
+    // period was changed in the meantime, which at worst keeps some expired
+    // leases around for a while longer.
+    while (!_lru.empty() && _lru.front().lease.expires <= now) {
+        _leases.erase(_leases.find(*_lru.front().k));
+    }
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+
+#include <boost/intrusive/list.hpp>
+
+#include "db/consistency_level_type.hh"
+#include "db/timeout_clock.hh"
+#include "dht/decorated_key.hh"
+#include "query-request.hh"
+#include "query-result.hh"
+#include "schema/schema_fwd.hh"
+#include "utils/UUID.hh"
+
+namespace service::paxos {
+
+// A ballot the replicas of a key promised to a coordinator ahead of its next
+// paxos round of the key, along with the value of the key they returned with
+// the promise.
+//
+// The coordinator prepares the ballot in the background once a round of the
+// key completes, and the next request of the key it coordinates proposes its
+// value right away, without a prepare round of its own. The replicas accept
+// such a proposal only if they haven't promised another ballot since, and the
+// value of the key is still the one the proposal was computed from (see
+// accept_condition).
+struct lease {
+    utils::UUID ballot;
+    // The read command the value was read with.
+    lw_shared_ptr<query::read_command> cmd;
+    query::digest_algorithm digest_algorithm;
+    foreign_ptr<lw_shared_ptr<query::result>> data;
+    // The lease is valid only for requests with the same consistency level
+    // and the same replicas.
+    db::consistency_level cl_for_paxos;
+    int64_t topology_version;
+    db::timeout_clock::time_point expires;
+};
+
+// The leases held by the coordinator on this shard, by key.
+//
+// Leases are taken out of the map when used, and expire after a while, so
+// that the map holds only the leases of keys updated recently.
+class lease_map {
+    struct key {
+        table_id table;
+        dht::decorated_key dk;
+    };
+    struct key_hash {
+        size_t operator()(const key& k) const;
+    };
+    struct key_equal {
+        bool operator()(const key& a, const key& b) const;
+    };
+    struct entry {
+        using lru_link_type = boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+        lru_link_type lru_link;
+        const key* k = nullptr;
+        paxos::lease lease;
+    };
+    using lru_type = boost::intrusive::list<entry,
+        boost::intrusive::member_hook<entry, entry::lru_link_type, &entry::lru_link>,
+        boost::intrusive::constant_time_size<false>>;
+    using map_type = std::unordered_map<key, entry, key_hash, key_equal>;
+
+    map_type _leases;
+    // Ordered by the time the leases were inserted.
+    lru_type _lru;
+    size_t _max_leases;
+public:
+    explicit lease_map(size_t max_leases) : _max_leases(max_leases) { }
+
+    // Replaces the lease of the key, if any.
+    void insert(table_id table, const dht::decorated_key& dk, lease l);
+    // Removes the lease of the key from the map and returns it, unless it
+    // expired.
+    std::optional<lease> take(table_id table, const dht::decorated_key& dk, db::timeout_clock::time_point now);
+
+    size_t size() const noexcept { return _leases.size(); }
+private:
+    void expire(db::timeout_clock::time_point now);
+};
+
+}
@@ -9,7 +9,9 @@
  */
 #include <exception>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
 #include <seastar/coroutine/all.hh>
+#include <seastar/coroutine/as_future.hh>
 #include <seastar/coroutine/exception.hh>
 #include "service/storage_proxy.hh"
 #include "service/paxos/proposal.hh"
@@ -17,6 +19,7 @@
 #include "service/query_state.hh"
 #include "cql3/query_processor.hh"
 #include "cql3/untyped_result_set.hh"
+#include "db/config.hh"
 #include "db/system_keyspace.hh"
 #include "replica/database.hh"
 #include "schema/schema_builder.hh"
@@ -183,7 +186,7 @@ future<prepare_response> paxos_state::prepare(storage_proxy& sp, paxos_store& pa
 }
 
 future<bool> paxos_state::accept(storage_proxy& sp, paxos_store& paxos_store, tracing::trace_state_ptr tr_state, schema_ptr schema, dht::token token, const proposal& proposal,
-        clock_type::time_point timeout) {
+        const std::optional<accept_condition>& condition, clock_type::time_point timeout) {
     co_await utils::get_local_injector().inject("paxos_accept_proposal_timeout", timeout);
     utils::latency_counter lc;
     lc.start();
@@ -201,6 +204,37 @@ future<bool> paxos_state::accept(storage_proxy& sp, paxos_store& paxos_store, tr
     auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(proposal.ballot);
     paxos_state state = co_await paxos_store.load_paxos_state(proposal.update.key(), schema, gc_clock::time_point(now_in_sec), timeout);
 
+    if (condition) {
+        // The proposal was made on a lease. Its ballot wasn't prepared, so it can be accepted only
+        // if nothing happened to the key since the lease was promised.
+        if (condition->promised_ballot != state._promised_ballot) {
+            logger.debug("Rejecting proposal {} made on lease {} because the promise is now {}", proposal, condition->promised_ballot, state._promised_ballot);
+            tracing::trace(tr_state, "Rejecting proposal {} made on lease {} because the promise is now {}", proposal, condition->promised_ballot, state._promised_ballot);
+            co_return false;
+        }
+        bool unchanged = false;
+        // The coordinator reads with the schema of the proposal.
+        if (condition->cmd.schema_version == schema->version()) {
+            // Read as of now, so that cells which expired since the lease was
+            // granted change the digest.
+            auto cmd = condition->cmd;
+            cmd.timestamp = gc_clock::now();
+            try {
+                auto&& [result, hit_rate] = co_await sp.get_db().local().query(schema, cmd,
+                        {query::result_request::only_digest, condition->digest_algorithm},
+                        dht::partition_range_vector({dht::partition_range::make_singular({token, proposal.update.key()})}), tr_state, timeout);
+                unchanged = *result->digest() == condition->digest;
+            } catch (...) {
+                logger.debug("Failed to get digest: {}. Rejecting proposal {} made on lease.", std::current_exception(), proposal);
+            }
+        }
+        if (!unchanged) {
+            logger.debug("Rejecting proposal {} made on lease {} because the value changed", proposal, condition->promised_ballot);
+            tracing::trace(tr_state, "Rejecting proposal {} made on lease {} because the value changed", proposal, condition->promised_ballot);
+            co_return false;
+        }
+    }
+
     // Accept the proposal if we promised to accept it or the proposal is newer than the one we promised.
     // Otherwise the proposal was cutoff by another Paxos proposer and has to be rejected.
     if (proposal.ballot == state._promised_ballot || proposal.ballot.timestamp() > state._promised_ballot.timestamp()) {
@@ -311,15 +345,54 @@ static sstring paxos_state_table_name(std::string_view table_name) {
     return result;
 }
 
+static paxos_state_cache::key cache_key(const schema& s, partition_key_view key) {
+    return {s.id(), to_legacy(*key.get_compound_type(s), key.representation())};
+}
+
+// paxos_state_cache_size_in_mb is the size for the whole node.
+static size_t paxos_state_cache_capacity(uint32_t size_in_mb) {
+    return (size_t(size_in_mb) << 20) / smp::count;
+}
+
+static constexpr auto prune_batch_delay = std::chrono::milliseconds(10);
+static constexpr size_t max_prune_batch = 128;
+
 paxos_store::paxos_store(db::system_keyspace& sys_ks, gms::feature_service& features, replica::database& db, migration_manager& mm)
     : _sys_ks(sys_ks)
     , _features(features)
     , _db(db)
     , _mm(mm)
+    , _cache(paxos_state_cache_capacity(db.get_config().paxos_state_cache_size_in_mb()))
+    , _cache_size_observer(db.get_config().paxos_state_cache_size_in_mb.observe([this] (uint32_t size_in_mb) {
+        _cache.set_capacity(paxos_state_cache_capacity(size_in_mb));
+    }))
+    , _prune_timer([this] { flush_prunes(); })
 {
     if (this_shard_id() == 0) {
         _mm.get_notifier().register_listener(this);
     }
+
+    namespace sm = seastar::metrics;
+    _metrics.add_group("paxos", {
+        sm::make_counter("state_cache_hits", [this] { return _cache.get_stats().hits; },
+                sm::description("number of times the paxos state of a key was found in the paxos state cache")),
+        sm::make_counter("state_cache_misses", [this] { return _cache.get_stats().misses; },
+                sm::description("number of times the paxos state of a key was read from the paxos state table")),
+        sm::make_counter("state_cache_evictions", [this] { return _cache.get_stats().evictions; },
+                sm::description("number of keys evicted from the paxos state cache to keep it within paxos_state_cache_size_in_mb")),
+        sm::make_counter("state_cache_invalidations", [this] { return _cache.get_stats().invalidations; },
+                sm::description("number of keys dropped from the paxos state cache because their state could have changed")),
+        sm::make_gauge("state_cache_entries", [this] { return _cache.get_stats().entries; },
+                sm::description("number of keys in the paxos state cache")),
+        sm::make_gauge("state_cache_bytes", [this] { return _cache.get_stats().memory; },
+                sm::description("memory used by the paxos state cache, in bytes")),
+        sm::make_counter("prunes", _stats.prunes,
+                sm::description("number of prunes of the paxos state of a key requested")),
+        sm::make_counter("prune_batches", _stats.prune_batches,
+                sm::description("number of batches the prunes of the paxos state were applied in")),
+        sm::make_counter("superseded_prunes", _stats.superseded_prunes,
+                sm::description("number of prunes of the paxos state not applied, because a newer decision or prune of the same key made them redundant")),
+    });
 }
 
 paxos_store::~paxos_store() {
@@ -327,10 +400,12 @@ paxos_store::~paxos_store() {
 }
 
 future<> paxos_store::stop() {
-    auto stopped = this_shard_id() == 0 
-        ? _mm.get_notifier().unregister_listener(this) 
-        : make_ready_future<>();
-    return stopped.then([this] { _stopped = true; });
+    flush_prunes();
+    co_await _prune_gate.close();
+    if (this_shard_id() == 0) {
+        co_await _mm.get_notifier().unregister_listener(this);
+    }
+    _stopped = true;
 }
 
 schema_ptr paxos_store::create_paxos_state_schema(const schema& s) {
@@ -544,6 +619,25 @@ future<paxos_state> paxos_store::load_paxos_state(partition_key_view key, schema
     co_await utils::get_local_injector().inject("load_paxos_state-enter", utils::wait_for_message(60s));
 
     const auto state_schema = co_await get_paxos_state_schema(*s, timeout);
+    auto k = cache_key(*s, key);
+    // The state of a key which is being migrated between shards may be
+    // written on either of them, so it isn't cached.
+    const bool use_cache = _cache.enabled() && s->table().shard_for_writes(dht::get_token(*s, key)).size() == 1;
+    if (!use_cache) {
+        _cache.invalidate(k);
+    } else {
+        const auto version = cache_source_version(*state_schema);
+        if (const auto* st = _cache.find(k, version, gc_clock::now(), std::chrono::seconds(paxos_ttl_sec(*s)))) {
+            std::optional<service::paxos::proposal> most_recent;
+            if (st->commit_ballot) {
+                most_recent = service::paxos::proposal(*st->commit_ballot, st->commit ? *st->commit : freeze(mutation(s, key)));
+            }
+            co_return service::paxos::paxos_state(st->promised, st->accepted, std::move(most_recent));
+        }
+        _cache.start_load(k, version);
+    }
+    auto abort_load = defer([&] { _cache.abort_load(k); });
+
     // FIXME: we need execute_cql_with_now()
     (void)now;
     const auto results = co_await execute_cql_with_timeout(
@@ -552,9 +646,12 @@ future<paxos_state> paxos_store::load_paxos_state(partition_key_view key, schema
             paxos_state_cf_filter(*s, *state_schema)
         ),
         timeout,
-        to_legacy(*key.get_compound_type(*s), key.representation())
+        k.row_key
     );
     if (results.empty()) {
+        if (use_cache) {
+            _cache.finish_load(k, paxos_state_cache::cached_state{.promised = utils::UUID_gen::min_time_UUID()});
+        }
         co_return service::paxos::paxos_state();
     }
     auto& row = results.one();
@@ -568,50 +665,83 @@ future<paxos_state> paxos_store::load_paxos_state(partition_key_view key, schema
     }
 
     std::optional<service::paxos::proposal> most_recent;
+    std::optional<frozen_mutation> commit;
     if (row.has("most_recent_commit_at")) {
+        if (row.has("most_recent_commit")) {
+            commit = ser::deserialize_from_buffer<>(row.get_blob_unfragmented("most_recent_commit"), std::type_identity<frozen_mutation>(), 0);
+        }
         // the value can be missing if it was pruned, supply empty one since
         // it will not going to be used anyway
-        auto fm = row.has("most_recent_commit") ?
-                    ser::deserialize_from_buffer<>(row.get_blob_unfragmented("most_recent_commit"), std::type_identity<frozen_mutation>(), 0) :
-                    freeze(mutation(s, key));
         most_recent = service::paxos::proposal(row.get_as<utils::UUID>("most_recent_commit_at"),
-                std::move(fm));
+                commit ? *commit : freeze(mutation(s, key)));
+    }
+
+    if (use_cache) {
+        // A pruned decision was pruned at least as late as it was made.
+        auto pruned_at = most_recent && !commit ? utils::UUID_gen::micros_timestamp(most_recent->ballot) : api::missing_timestamp;
+        _cache.finish_load(k, paxos_state_cache::cached_state{
+            .promised = promised,
+            .accepted = accepted,
+            .commit_ballot = most_recent ? std::make_optional(most_recent->ballot) : std::nullopt,
+            .commit = std::move(commit),
+            .pruned_at = pruned_at,
+        });
     }
 
     co_return service::paxos::paxos_state(promised, std::move(accepted), std::move(most_recent));
 }
 
+paxos_state_cache::source_version paxos_store::cache_source_version(const schema& state_schema) const {
+    return {
+        .data_generation = _db.find_column_family(state_schema.id()).data_generation(),
+        .topology_version = _db.get_token_metadata().get_version(),
+    };
+}
+
 future<> paxos_store::save_paxos_promise(const schema& s, const partition_key& key, const utils::UUID& ballot, db::timeout_clock::time_point timeout) {
     const auto state_schema = co_await get_paxos_state_schema(s, timeout);
-    co_await execute_cql_with_timeout(
-            format("UPDATE \"{}\".\"{}\" USING TIMESTAMP ? AND TTL ? SET promise = ? WHERE row_key = ?{}",
-                state_schema->ks_name(), state_schema->cf_name(), 
-                paxos_state_cf_filter(s, *state_schema)
-            ),
-            timeout,
-            utils::UUID_gen::micros_timestamp(ballot),
-            paxos_ttl_sec(s),
-            ballot,
-            to_legacy(*key.get_compound_type(s), key.representation())
-        );
+    auto k = cache_key(s, key);
+    try {
+        co_await execute_cql_with_timeout(
+                format("UPDATE \"{}\".\"{}\" USING TIMESTAMP ? AND TTL ? SET promise = ? WHERE row_key = ?{}",
+                    state_schema->ks_name(), state_schema->cf_name(), 
+                    paxos_state_cf_filter(s, *state_schema)
+                ),
+                timeout,
+                utils::UUID_gen::micros_timestamp(ballot),
+                paxos_ttl_sec(s),
+                ballot,
+                k.row_key
+            );
+    } catch (...) {
+        _cache.invalidate(k);
+        throw;
+    }
+    _cache.on_promise(k, ballot);
 }
 
 future<> paxos_store::save_paxos_proposal(const schema& s, const proposal& proposal, db::timeout_clock::time_point timeout) {
     const auto state_schema = co_await get_paxos_state_schema(s, timeout);
-    partition_key_view key = proposal.update.key();
-    co_await execute_cql_with_timeout(
-            format("UPDATE \"{}\".\"{}\" USING TIMESTAMP ? AND TTL ? SET promise = ?, proposal_ballot = ?, proposal = ? WHERE row_key = ?{}", 
-                state_schema->ks_name(), state_schema->cf_name(), 
-                paxos_state_cf_filter(s, *state_schema)
-            ),
-            timeout,
-            utils::UUID_gen::micros_timestamp(proposal.ballot),
-            paxos_ttl_sec(s),
-            proposal.ballot,
-            proposal.ballot,
-            ser::serialize_to_buffer<bytes>(proposal.update),
-            to_legacy(*key.get_compound_type(s), key.representation())
-        );
+    auto k = cache_key(s, proposal.update.key());
+    try {
+        co_await execute_cql_with_timeout(
+                format("UPDATE \"{}\".\"{}\" USING TIMESTAMP ? AND TTL ? SET promise = ?, proposal_ballot = ?, proposal = ? WHERE row_key = ?{}", 
+                    state_schema->ks_name(), state_schema->cf_name(), 
+                    paxos_state_cf_filter(s, *state_schema)
+                ),
+                timeout,
+                utils::UUID_gen::micros_timestamp(proposal.ballot),
+                paxos_ttl_sec(s),
+                proposal.ballot,
+                proposal.ballot,
+                ser::serialize_to_buffer<bytes>(proposal.update),
+                k.row_key
+            );
+    } catch (...) {
+        _cache.invalidate(k);
+        throw;
+    }
+    _cache.on_proposal(k, proposal);
 }
 
 future<> paxos_store::save_paxos_decision(const schema& s, const proposal& decision, db::timeout_clock::time_point timeout) {
@@ -623,20 +753,34 @@ future<> paxos_store::save_paxos_decision(const schema& s, const proposal& decis
     // Erasing the last proposal is just an optimization and does not affect correctness:
     // sp::begin_and_repair_paxos will exclude an accepted proposal if it is older than the most
     // recent commit.
-    partition_key_view key = decision.update.key();
-    co_await execute_cql_with_timeout(
-            format("UPDATE \"{}\".\"{}\" USING TIMESTAMP ? AND TTL ? SET proposal_ballot = null, proposal = null, "
-                   "most_recent_commit_at = ?, most_recent_commit = ? WHERE row_key = ?{}",
-                state_schema->ks_name(), state_schema->cf_name(), 
-                paxos_state_cf_filter(s, *state_schema)
-            ),
-            timeout,
-            utils::UUID_gen::micros_timestamp(decision.ballot),
-            paxos_ttl_sec(s),
-            decision.ballot,
-            ser::serialize_to_buffer<bytes>(decision.update),
-            to_legacy(*key.get_compound_type(s), key.representation())
-        );
+    auto k = cache_key(s, decision.update.key());
+    try {
+        co_await execute_cql_with_timeout(
+                format("UPDATE \"{}\".\"{}\" USING TIMESTAMP ? AND TTL ? SET proposal_ballot = null, proposal = null, "
+                       "most_recent_commit_at = ?, most_recent_commit = ? WHERE row_key = ?{}",
+                    state_schema->ks_name(), state_schema->cf_name(), 
+                    paxos_state_cf_filter(s, *state_schema)
+                ),
+                timeout,
+                utils::UUID_gen::micros_timestamp(decision.ballot),
+                paxos_ttl_sec(s),
+                decision.ballot,
+                ser::serialize_to_buffer<bytes>(decision.update),
+                k.row_key
+            );
+    } catch (...) {
+        _cache.invalidate(k);
+        throw;
+    }
+    _cache.on_decision(k, decision);
+
+    // A pending prune of an older decision would delete nothing the new
+    // decision didn't overwrite.
+    if (auto it = _pending_prunes.find(k); it != _pending_prunes.end()
+            && utils::UUID_gen::micros_timestamp(it->second.ballot) < utils::UUID_gen::micros_timestamp(decision.ballot)) {
+        _pending_prunes.erase(it);
+        ++_stats.superseded_prunes;
+    }
 }
 
 future<> paxos_store::delete_paxos_decision(const schema& s, const partition_key& key, utils::UUID ballot, db::timeout_clock::time_point timeout) {
@@ -646,15 +790,73 @@ future<> paxos_store::delete_paxos_decision(const schema& s, const partition_key
     // In this case we can remove learned paxos value using ballot's timestamp which
     // guarantees that if there is more recent round it will not be affected.
 
-    co_await execute_cql_with_timeout(
-            format("DELETE most_recent_commit FROM \"{}\".\"{}\" USING TIMESTAMP ? WHERE row_key = ?{}",
-                state_schema->ks_name(), state_schema->cf_name(), 
-                paxos_state_cf_filter(s, *state_schema)
-            ),
-            timeout,
-            utils::UUID_gen::micros_timestamp(ballot),
-            to_legacy(*key.get_compound_type(s), key.representation())
-        );
+    ++_stats.prunes;
+    auto [it, inserted] = _pending_prunes.try_emplace(cache_key(s, key), pending_prune{state_schema, ballot});
+    if (!inserted) {
+        // Only the newest of the prunes of a key has any effect.
+        if (utils::UUID_gen::micros_timestamp(ballot) > utils::UUID_gen::micros_timestamp(it->second.ballot)) {
+            it->second = pending_prune{state_schema, ballot};
+        }
+        ++_stats.superseded_prunes;
+    }
+    _pending_prunes_timeout = std::max(_pending_prunes_timeout, timeout);
+    auto f = _pending_prunes_done.get_shared_future();
+    if (_pending_prunes.size() >= max_prune_batch) {
+        flush_prunes();
+    } else if (!_prune_timer.armed()) {
+        _prune_timer.arm(prune_batch_delay);
+    }
+    co_await std::move(f);
+}
+
+void paxos_store::flush_prunes() {
+    _prune_timer.cancel();
+    auto prunes = std::exchange(_pending_prunes, {});
+    auto done = std::exchange(_pending_prunes_done, {});
+    auto timeout = std::exchange(_pending_prunes_timeout, db::timeout_clock::time_point::min());
+    if (_prune_gate.is_closed()) {
+        done.set_exception(gate_closed_exception());
+        return;
+    }
+    // Waited for by stop().
+    (void)apply_prunes(std::move(prunes), std::move(done), timeout, _prune_gate.hold());
+}
+
+// Like DELETE most_recent_commit FROM <state table> USING TIMESTAMP <ballot> WHERE row_key = <key>.
+static mutation make_prune_mutation(const paxos_state_cache::key& k, const schema_ptr& state_schema, const utils::UUID& ballot) {
+    mutation m(state_schema, partition_key::from_single_value(*state_schema, k.row_key));
+    auto ck = state_schema->clustering_key_size()
+            ? clustering_key::from_single_value(*state_schema, uuid_type->decompose(k.table.uuid()))
+            : clustering_key::make_empty();
+    m.set_clustered_cell(ck, *state_schema->get_column_definition(to_bytes("most_recent_commit")),
+            atomic_cell::make_dead(utils::UUID_gen::micros_timestamp(ballot), gc_clock::now()));
+    return m;
+}
+
+future<> paxos_store::apply_prunes(pending_prunes_map prunes, shared_promise<> done,
+        db::timeout_clock::time_point timeout, seastar::gate::holder holder) {
+    if (prunes.empty()) {
+        done.set_value();
+        co_return;
+    }
+    ++_stats.prune_batches;
+    utils::chunked_vector<mutation> muts;
+    muts.reserve(prunes.size());
+    for (const auto& [k, p] : prunes) {
+        muts.push_back(make_prune_mutation(k, p.state_schema, p.ballot));
+    }
+    auto f = co_await coroutine::as_future(_mm.get_storage_proxy().mutate_locally(std::move(muts), tracing::trace_state_ptr(), timeout));
+    if (f.failed()) {
+        for (const auto& [k, p] : prunes) {
+            _cache.invalidate(k);
+        }
+        done.set_exception(f.get_exception());
+        co_return;
+    }
+    for (const auto& [k, p] : prunes) {
+        _cache.on_prune(k, p.ballot);
+    }
+    done.set_value();
 }
 
 } // end of namespace "service::paxos"
@@ -8,7 +8,14 @@
  */
 #pragma once
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/timer.hh>
 #include "service/paxos/proposal.hh"
+#include "service/paxos/accept_condition.hh"
+#include "service/paxos/paxos_state_cache.hh"
+#include "utils/observable.hh"
 #include "utils/log.hh"
 #include "utils/digest_algorithm.hh"
 #include "db/timeout_clock.hh"
@@ -92,8 +99,9 @@ class paxos_state {
     std::optional<proposal> _most_recent_commit;
 
 public:
+    using cas_lock_guard = guard;
 
-    static future<guard> get_cas_lock(const dht::token& key, clock_type::time_point timeout);
+    static future<cas_lock_guard> get_cas_lock(const dht::token& key, clock_type::time_point timeout);
 
     static logging::logger logger;
 
@@ -108,8 +116,9 @@ class paxos_state {
             const query::read_command& cmd, const partition_key& key, utils::UUID ballot,
             bool only_digest, query::digest_algorithm da, clock_type::time_point timeout);
     // Replica RPC endpoint for Paxos "accept" phase.
+    // A proposal made on a lease comes with a condition (see accept_condition).
     static future<bool> accept(storage_proxy& sp, paxos_store& paxos_store, tracing::trace_state_ptr tr_state, schema_ptr schema, dht::token token, const proposal& proposal,
-            clock_type::time_point timeout);
+            const std::optional<accept_condition>& condition, clock_type::time_point timeout);
     // Replica RPC endpoint for Paxos "learn".
     static future<> learn(storage_proxy& sp, paxos_store& paxos_store, schema_ptr schema, proposal decision, clock_type::time_point timeout, tracing::trace_state_ptr tr_state);
     // Replica RPC endpoint for pruning Paxos table
@@ -128,6 +137,30 @@ class paxos_store:
     migration_manager& _mm;
     bool _stopped = false;
 
+    paxos_state_cache _cache;
+    utils::observer<uint32_t> _cache_size_observer;
+
+    // Prunes are delayed for a while, so that they're applied in batches, and
+    // so that a prune made redundant by a newer decision of the same key
+    // isn't applied at all.
+    struct pending_prune {
+        schema_ptr state_schema;
+        utils::UUID ballot;
+    };
+    using pending_prunes_map = std::unordered_map<paxos_state_cache::key, pending_prune, paxos_state_cache::key_hash>;
+    pending_prunes_map _pending_prunes;
+    shared_promise<> _pending_prunes_done;
+    db::timeout_clock::time_point _pending_prunes_timeout = db::timeout_clock::time_point::min();
+    timer<lowres_clock> _prune_timer;
+    seastar::gate _prune_gate;
+
+    struct stats {
+        uint64_t prunes = 0;
+        uint64_t prune_batches = 0;
+        uint64_t superseded_prunes = 0;
+    } _stats;
+    seastar::metrics::metric_groups _metrics;
+
     template <typename... Args>
     future<cql3::untyped_result_set> execute_cql_with_timeout(sstring req, db::timeout_clock::time_point timeout, Args&&... args);
     future<schema_ptr> get_paxos_state_schema(const schema& s, db::timeout_clock::time_point timeout) const;
@@ -135,6 +168,9 @@ class paxos_store:
     static schema_ptr create_paxos_state_schema(const schema& s);
     schema_ptr try_get_paxos_state_schema(const schema& s) const;
     void check_raft_is_enabled(const schema& s) const;
+    paxos_state_cache::source_version cache_source_version(const schema& state_schema) const;
+    void flush_prunes();
+    future<> apply_prunes(pending_prunes_map prunes, shared_promise<> done, db::timeout_clock::time_point timeout, seastar::gate::holder holder);
 public:
     explicit paxos_store(db::system_keyspace& sys_ks, gms::feature_service& features, replica::database& db, migration_manager& mm);
     ~paxos_store();
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include "service/paxos/paxos_state_cache.hh"
+
+#include "utils/UUID_gen.hh"
+#include "utils/hash.hh"
+
+namespace service::paxos {
+
+// The cells of the paxos state tables are written with the timestamp of the
+// ballot they carry.
+static api::timestamp_type timestamp_of(const utils::UUID& ballot) {
+    return utils::UUID_gen::micros_timestamp(ballot);
+}
+
+// The apply_*() functions return false if the outcome of the write can't be
+// told, and the key has to be dropped.
+
+static bool apply_promise(paxos_state_cache::cached_state& st, const utils::UUID& ballot) {
+    auto ts = timestamp_of(ballot);
+    auto current = timestamp_of(st.promised);
+    if (ts > current) {
+        st.promised = ballot;
+    } else if (ts == current && ballot != st.promised) {
+        return false;
+    }
+    return true;
+}
+
+static bool apply_proposal(paxos_state_cache::cached_state& st, const proposal& p) {
+    if (!apply_promise(st, p.ballot)) {
+        return false;
+    }
+    auto ts = timestamp_of(p.ballot);
+    if (st.accepted) {
+        auto current = timestamp_of(st.accepted->ballot);
+        if (ts < current) {
+            return true;
+        }
+        if (ts == current && p.ballot != st.accepted->ballot) {
+            return false;
+        }
+    }
+    // Saving a decision deletes the accepted proposal with the timestamp of
+    // the decision.
+    if (st.commit_ballot && timestamp_of(*st.commit_ballot) >= ts) {
+        st.accepted.reset();
+    } else {
+        st.accepted = p;
+    }
+    return true;
+}
+
+static bool apply_decision(paxos_state_cache::cached_state& st, const proposal& decision) {
+    auto ts = timestamp_of(decision.ballot);
+    if (st.accepted && timestamp_of(st.accepted->ballot) <= ts) {
+        st.accepted.reset();
+    }
+    if (st.commit_ballot) {
+        auto current = timestamp_of(*st.commit_ballot);
+        if (ts < current) {
+            return true;
+        }
+        if (ts == current && decision.ballot != *st.commit_ballot) {
+            return false;
+        }
+    }
+    st.commit_ballot = decision.ballot;
+    if (st.pruned_at >= ts) {
+        st.commit.reset();
+    } else {
+        st.commit = decision.update;
+    }
+    return true;
+}
+
+static bool apply_prune(paxos_state_cache::cached_state& st, const utils::UUID& ballot) {
+    auto ts = timestamp_of(ballot);
+    st.pruned_at = std::max(st.pruned_at, ts);
+    if (st.commit_ballot && timestamp_of(*st.commit_ballot) <= ts) {
+        st.commit.reset();
+    }
+    return true;
+}
+
+static bool expired(const paxos_state_cache::cached_state& st, gc_clock::time_point now, gc_clock::duration ttl) {
+    if (ttl == gc_clock::duration::zero()) {
+        return false;
+    }
+    // Expiry is computed from the time of the ballot, which is no later than
+    // the time the cell was written, so the state expires from the cache no
+    // later than from the table.
+    auto expired_ballot = [&] (const utils::UUID& ballot) {
+        return gc_clock::time_point(utils::UUID_gen::unix_timestamp_in_sec(ballot)) + ttl <= now;
+    };
+    return (st.promised != utils::UUID_gen::min_time_UUID() && expired_ballot(st.promised))
+        || (st.accepted && expired_ballot(st.accepted->ballot))
+        || (st.commit_ballot && expired_ballot(*st.commit_ballot));
+}
+
+size_t paxos_state_cache::key_hash::operator()(const key& k) const {
+    return utils::hash_combine(std::hash<table_id>()(k.table), std::hash<bytes_view>()(k.row_key));
+}
+
+void paxos_state_cache::set_capacity(size_t capacity) {
+    _capacity = capacity;
+    evict();
+}
+
+const paxos_state_cache::cached_state* paxos_state_cache::find(const key& k, const source_version& version, gc_clock::time_point now, gc_clock::duration ttl) {
+    auto it = _entries.find(k);
+    if (it == _entries.end() || !it->second.state) {
+        ++_stats.misses;
+        return nullptr;
+    }
+    auto& e = it->second;
+    if (e.version != version || expired(*e.state, now, ttl)) {
+        erase(it);
+        ++_stats.invalidations;
+        ++_stats.misses;
+        return nullptr;
+    }
+    ++_stats.hits;
+    e.lru_link.unlink();
+    _lru.push_back(e);
+    return &*e.state;
+}
+
+void paxos_state_cache::start_load(const key& k, const source_version& version) {
+    if (!enabled()) {
+        return;
+    }
+    if (auto it = _entries.find(k); it != _entries.end()) {
+        erase(it);
+    }
+    auto it = _entries.try_emplace(k).first;
+    it->second.k = &it->first;
+    it->second.version = version;
+}
+
+void paxos_state_cache::finish_load(const key& k, cached_state state) {
+    auto it = _entries.find(k);
+    if (it == _entries.end() || it->second.state) {
+        return;
+    }
+    auto& e = it->second;
+    if (e.written || !enabled()) {
+        erase(it);
+        return;
+    }
+    e.state = std::move(state);
+    update_size(e);
+    evict();
+}
+
+void paxos_state_cache::abort_load(const key& k) {
+    auto it = _entries.find(k);
+    if (it != _entries.end() && !it->second.state) {
+        erase(it);
+    }
+}
+
+paxos_state_cache::cached_state* paxos_state_cache::for_write(const key& k) {
+    auto it = _entries.find(k);
+    if (it == _entries.end()) {
+        return nullptr;
+    }
+    if (!it->second.state) {
+        it->second.written = true;
+        return nullptr;
+    }
+    return &*it->second.state;
+}
+
+void paxos_state_cache::on_promise(const key& k, const utils::UUID& ballot) {
+    if (auto st = for_write(k); st && !apply_promise(*st, ballot)) {
+        invalidate(k);
+    }
+}
+
+void paxos_state_cache::on_proposal(const key& k, const proposal& p) {
+    if (auto st = for_write(k)) {
+        if (!apply_proposal(*st, p)) {
+            invalidate(k);
+            return;
+        }
+        update_size(_entries.find(k)->second);
+        evict();
+    }
+}
+
+void paxos_state_cache::on_decision(const key& k, const proposal& decision) {
+    if (auto st = for_write(k)) {
+        if (!apply_decision(*st, decision)) {
+            invalidate(k);
+            return;
+        }
+        update_size(_entries.find(k)->second);
+        evict();
+    }
+}
+
+void paxos_state_cache::on_prune(const key& k, const utils::UUID& ballot) {
+    if (auto st = for_write(k)) {
+        apply_prune(*st, ballot);
+        update_size(_entries.find(k)->second);
+    }
+}
+
+void paxos_state_cache::invalidate(const key& k) {
+    auto it = _entries.find(k);
+    if (it == _entries.end()) {
+        return;
+    }
+    if (!it->second.state) {
+        it->second.written = true;
+        return;
+    }
+    erase(it);
+    ++_stats.invalidations;
+}
+
+void paxos_state_cache::erase(map_type::iterator it) noexcept {
+    auto& e = it->second;
+    if (e.lru_link.is_linked()) {
+        e.lru_link.unlink();
+        --_stats.entries;
+        _stats.memory -= e.size;
+    }
+    _entries.erase(it);
+}
+
+void paxos_state_cache::update_size(entry& e) noexcept {
+    auto size = sizeof(map_type::value_type) + 2 * sizeof(void*) + e.k->row_key.size();
+    if (e.state->accepted) {
+        size += e.state->accepted->update.representation().size();
+    }
+    if (e.state->commit) {
+        size += e.state->commit->representation().size();
+    }
+    if (e.lru_link.is_linked()) {
+        _stats.memory -= e.size;
+    } else {
+        _lru.push_back(e);
+        ++_stats.entries;
+    }
+    e.size = size;
+    _stats.memory += size;
+}
+
+void paxos_state_cache::evict() {
+    while (_stats.memory > _capacity && !_lru.empty()) {
+        auto& e = _lru.front();
+        erase(_entries.find(*e.k));
+        ++_stats.evictions;
+    }
+}
+
+}
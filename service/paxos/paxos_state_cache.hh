@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+
+#include <boost/intrusive/list.hpp>
+
+#include "bytes.hh"
+#include "gc_clock.hh"
+#include "schema/schema_fwd.hh"
+#include "service/paxos/proposal.hh"
+#include "timestamp.hh"
+#include "utils/UUID.hh"
+
+namespace service::paxos {
+
+// Caches the paxos state of recently used keys, as stored in the paxos state
+// tables, so that a paxos round on a replica doesn't have to read it.
+//
+// Every write to a paxos state table is applied to the cached state of its key,
+// if any, following the rules by which the cells of the table are reconciled:
+// all the cells are written with the timestamp of the ballot they carry, so
+// the newer ballot wins, and a deletion wins over a write with the same
+// timestamp. When the outcome can't be told, as for different ballots with the
+// same timestamp, the key is dropped from the cache.
+//
+// A pruned decision may be returned for a key whose decision was pruned before
+// it was learned. This is harmless: learning a decision again is idempotent,
+// and the pruned decision itself is never used.
+class paxos_state_cache {
+public:
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+        uint64_t entries = 0;
+        uint64_t memory = 0;
+    };
+
+    struct key {
+        table_id table;
+        // The row_key of the paxos state table.
+        bytes row_key;
+
+        bool operator==(const key&) const = default;
+    };
+
+    struct key_hash {
+        size_t operator()(const key& k) const;
+    };
+
+    // Identifies the contents of the paxos state table a state is loaded from.
+    // The state remains valid as long as they are changed by writes only: a
+    // new data generation of the table means data was streamed into it or
+    // dropped from it, and a new topology version may mean the key moved
+    // between shards.
+    struct source_version {
+        uint64_t data_generation;
+        int64_t topology_version;
+
+        bool operator==(const source_version&) const = default;
+    };
+
+    // The state of a key, like the paxos_state loaded from the table.
+    struct cached_state {
+        utils::UUID promised;
+        std::optional<proposal> accepted;
+        std::optional<utils::UUID> commit_ballot;
+        // Disengaged if the decision was pruned.
+        std::optional<frozen_mutation> commit;
+        // The timestamp of the newest prune of the key known.
+        api::timestamp_type pruned_at = api::missing_timestamp;
+    };
+private:
+    struct entry {
+        using lru_link_type = boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+        lru_link_type lru_link;
+        const key* k = nullptr;
+        // Disengaged while the state is being loaded.
+        std::optional<cached_state> state;
+        // Set if the key was written while its state was being loaded, which
+        // may then miss the write.
+        bool written = false;
+        source_version version;
+        size_t size = 0;
+    };
+
+    using lru_type = boost::intrusive::list<entry,
+        boost::intrusive::member_hook<entry, entry::lru_link_type, &entry::lru_link>,
+        boost::intrusive::constant_time_size<false>>;
+    using map_type = std::unordered_map<key, entry, key_hash>;
+
+    map_type _entries;
+    lru_type _lru;
+    size_t _capacity;
+    stats _stats;
+public:
+    // The capacity is in bytes. A capacity of 0 disables the cache.
+    explicit paxos_state_cache(size_t capacity) : _capacity(capacity) { }
+
+    void set_capacity(size_t capacity);
+    bool enabled() const noexcept { return _capacity; }
+
+    // Returns the cached state of the key, if any, and if it's still valid:
+    // it was loaded from the same version of the table, and none of its
+    // cells expired.
+    const cached_state* find(const key& k, const source_version& version, gc_clock::time_point now, gc_clock::duration ttl);
+
+    // The state of a key is loaded from the table between start_load() and
+    // finish_load(), under the paxos table lock of the key. The state is
+    // cached unless the key was written in the meantime.
+    void start_load(const key& k, const source_version& version);
+    void finish_load(const key& k, cached_state state);
+    void abort_load(const key& k);
+
+    // Apply successful writes to the paxos state table.
+    void on_promise(const key& k, const utils::UUID& ballot);
+    void on_proposal(const key& k, const proposal& p);
+    void on_decision(const key& k, const proposal& decision);
+    void on_prune(const key& k, const utils::UUID& ballot);
+
+    // Drops the key, for example when a write to it failed, and it isn't known
+    // whether it was applied.
+    void invalidate(const key& k);
+
+    const stats& get_stats() const noexcept { return _stats; }
+private:
+    // Returns the cached state of the key to be written, or nullptr.
+    cached_state* for_write(const key& k);
+    void erase(map_type::iterator it) noexcept;
+    void update_size(entry& e) noexcept;
+    void evict();
+};
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include "service/replica_load_tracker.hh"
+
+#include <seastar/core/metrics.hh>
+
+namespace service {
+
+// Weight of a new sample in the moving average of the latency.
+static constexpr double latency_weight = 0.1;
+// A replica is diverted from only if it's this many times more loaded than
+// the alternative, so that noise doesn't defeat the cache-aware choice.
+static constexpr double divert_factor = 2;
+// Load information older than that is considered stale.
+static constexpr auto stale_after = std::chrono::seconds(1);
+
+replica_load_tracker::replica_load& replica_load_tracker::get(locator::host_id ep) {
+    auto [it, inserted] = _replicas.try_emplace(ep);
+    if (inserted) {
+        namespace sm = seastar::metrics;
+        auto& r = it->second;
+        auto replica_label = sm::label("replica")(fmt::to_string(ep));
+        r.metrics.add_group("storage_proxy_coordinator", {
+            sm::make_counter("replica_read_selections", r.selected,
+                    sm::description("number of reads sent to the replica"), {replica_label}),
+            sm::make_counter("replica_read_diversions", r.diverted,
+                    sm::description("number of reads sent to the replica instead of a more loaded one"), {replica_label}),
+            sm::make_gauge("replica_read_latency", [&r] { return r.latency; },
+                    sm::description("moving average of the latency of reads sent to the replica, in microseconds"), {replica_label}),
+        });
+    }
+    return it->second;
+}
+
+void replica_load_tracker::on_request_sent(locator::host_id ep) {
+    auto& r = get(ep);
+    ++r.outstanding;
+    ++r.selected;
+}
+
+void replica_load_tracker::on_request_done(locator::host_id ep, clock::duration latency) {
+    auto it = _replicas.find(ep);
+    if (it == _replicas.end()) {
+        // The replica was removed while the read was in flight.
+        return;
+    }
+    auto& r = it->second;
+    --r.outstanding;
+    double sample = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    r.latency = r.latency ? r.latency + (sample - r.latency) * latency_weight : sample;
+    r.last_update = clock::now();
+}
+
+bool replica_load_tracker::prefer_alternative(locator::host_id chosen, locator::host_id alternative) {
+    auto& c = get(chosen);
+    auto& a = get(alternative);
+    if (!c.latency) {
+        return false;
+    }
+    if (!a.latency) {
+        // It never responded yet: try it, unless a read is already on its way.
+        return !a.outstanding;
+    }
+    if (clock::now() - a.last_update > stale_after) {
+        // Mark it updated so that it isn't flooded with reads until the
+        // first of them completes.
+        a.last_update = clock::now();
+        return true;
+    }
+    return c.latency * (c.outstanding + 1) > divert_factor * a.latency * (a.outstanding + 1);
+}
+
+void replica_load_tracker::on_diverted(locator::host_id ep) {
+    ++get(ep).diverted;
+}
+
+void replica_load_tracker::remove(locator::host_id ep) {
+    _replicas.erase(ep);
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <unordered_map>
+
+#include <seastar/core/metrics_registration.hh>
+
+#include "locator/host_id.hh"
+#include "utils/latency.hh"
+
+namespace service {
+
+// Tracks the load of the replicas which the coordinator on this shard sends
+// reads to: a moving average of the latency of their responses, and the
+// number of reads sent to them which weren't answered yet.
+//
+// It's used to pick the less loaded of two candidate replicas for a read
+// ("power of two choices"), so that a replica which is temporarily slow,
+// e.g. due to a compaction storm, gets fewer reads until it recovers.
+class replica_load_tracker {
+public:
+    using clock = utils::latency_counter::clock;
+private:
+    struct replica_load {
+        // Moving average of the latency, in microseconds.
+        double latency = 0;
+        clock::time_point last_update;
+        uint32_t outstanding = 0;
+        // Reads sent to the replica.
+        uint64_t selected = 0;
+        // Reads sent to the replica instead of the one chosen by proximity
+        // and cache hit rate, because it was less loaded.
+        uint64_t diverted = 0;
+        seastar::metrics::metric_groups metrics;
+    };
+    std::unordered_map<locator::host_id, replica_load> _replicas;
+
+    replica_load& get(locator::host_id ep);
+public:
+    void on_request_sent(locator::host_id ep);
+    // Called when a response to a read arrives, or the read fails.
+    void on_request_done(locator::host_id ep, clock::duration latency);
+
+    // Tells whether a read should rather be sent to `alternative` than to
+    // `chosen`, because `chosen` looks considerably more loaded.
+    //
+    // A replica whose load wasn't updated for a while is considered to be
+    // unloaded, so that it's tried again and its load is brought up to date.
+    bool prefer_alternative(locator::host_id chosen, locator::host_id alternative);
+
+    // Called when a read is sent to `ep` instead of a more loaded replica.
+    void on_diverted(locator::host_id ep);
+
+    // Forgets a replica which left the cluster, together with its metrics.
+    // Responses from it which arrive later are ignored.
+    void remove(locator::host_id ep);
+};
+
+}
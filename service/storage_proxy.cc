@@ -11,6 +11,7 @@
 #include <random>
 #include <algorithm>
 #include <ranges>
+#include <span>
 
 #include <fmt/ranges.h>
 #include <seastar/core/sleep.hh>
@@ -29,6 +30,8 @@
 #include "mutation/frozen_mutation.hh"
 #include "mutation/async_utils.hh"
 #include "query_result_merger.hh"
+#include "query-result-reader.hh"
+#include "keys/clustering_interval_set.hh"
 #include <seastar/core/do_with.hh>
 #include "message/messaging_service.hh"
 #include "gms/gossiper.hh"
@@ -62,6 +65,7 @@
 #include "service/client_state.hh"
 #include "service/paxos/proposal.hh"
 #include "service/topology_mutation.hh"
+#include "service/batched_mutation.hh"
 #include "locator/token_metadata.hh"
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
@@ -258,16 +262,40 @@ class storage_proxy::remote {
 
     bool _stopped{false};
 
+    // Writes waiting to be sent to replicas in MUTATION_BATCH messages, per
+    // scheduling group and replica. See send_mutation_coalesced().
+    struct pending_mutation_batch {
+        utils::chunked_vector<batched_mutation> mutations;
+        // The timeout of each of the mutations.
+        std::vector<storage_proxy::clock_type::time_point> timeouts;
+        std::vector<promise<>> sent;
+        size_t size = 0;
+        storage_proxy::clock_type::time_point timeout = storage_proxy::clock_type::time_point::min();
+    };
+    std::unordered_map<scheduling_group, std::unordered_map<locator::host_id, pending_mutation_batch>> _pending_mutation_batches;
+    timer<> _mutation_batch_timer;
+    seastar::named_gate _mutation_batch_gate;
+
+    // A batch is sent before the coalescing window elapses if it grows
+    // over either of these.
+    static constexpr size_t max_mutation_batch_count = 128;
+    static constexpr size_t max_mutation_batch_size = 128 * 1024;
+    // The minimal window over which writes of replayed batches are coalesced.
+    static constexpr std::chrono::microseconds batchlog_replay_coalescing_window{1000};
+
 public:
     remote(storage_proxy& sp, netw::messaging_service& ms, gms::gossiper& g, migration_manager& mm, sharded<db::system_keyspace>& sys_ks,
                 sharded<paxos::paxos_store>& paxos_store, raft_group0_client& group0_client, topology_state_machine& tsm)
         : _sp(sp), _ms(ms), _gossiper(g), _mm(mm), _sys_ks(sys_ks), _paxos_store(paxos_store), _group0_client(group0_client), _topology_state_machine(tsm)
         , _truncate_gate("storage_proxy::remote::truncate_gate")
+        , _mutation_batch_timer(std::bind_front(&remote::flush_mutation_batches, this))
+        , _mutation_batch_gate("storage_proxy::remote::mutation_batch_gate")
         , _connection_dropped(std::bind_front(&remote::connection_dropped, this))
         , _condrop_registration(_ms.when_connection_drops(_connection_dropped))
     {
         ser::storage_proxy_rpc_verbs::register_counter_mutation(&_ms, std::bind_front(&remote::handle_counter_mutation, this));
         ser::storage_proxy_rpc_verbs::register_mutation(&_ms, std::bind_front(&remote::receive_mutation_handler, this, _sp._write_smp_service_group));
+        ser::storage_proxy_rpc_verbs::register_mutation_batch(&_ms, std::bind_front(&remote::receive_mutation_batch_handler, this));
         ser::storage_proxy_rpc_verbs::register_hint_mutation(&_ms, std::bind_front(&remote::receive_hint_mutation_handler, this));
         ser::storage_proxy_rpc_verbs::register_paxos_learn(&_ms, std::bind_front(&remote::handle_paxos_learn, this));
         ser::storage_proxy_rpc_verbs::register_mutation_done(&_ms, std::bind_front(&remote::handle_mutation_done, this));
@@ -291,6 +319,9 @@ class storage_proxy::remote {
     future<> stop() {
         _group0_as.request_abort();
         co_await _truncate_gate.close();
+        _mutation_batch_timer.cancel();
+        flush_mutation_batches();
+        co_await _mutation_batch_gate.close();
         co_await ser::storage_proxy_rpc_verbs::unregister(&_ms);
         _stopped = true;
     }
@@ -341,6 +372,125 @@ class storage_proxy::remote {
                 response_id, trace_info, rate_limit_info, fence, forward, reply_to);
     }
 
+    // Sends a write to a replica, which replies to this shard.
+    //
+    // If write coalescing is enabled, the write is held for up to
+    // write_coalescing_window_in_us and sent together with other writes to
+    // the same replica. Writes which are traced or have to be forwarded by
+    // the replica are always sent on their own.
+    future<> send_write(
+            locator::host_id addr, storage_proxy::clock_type::time_point timeout, const tracing::trace_state_ptr& tr_state,
+            const lw_shared_ptr<const frozen_mutation>& m, const host_id_vector_replica_set& forward,
+            storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info,
+            fencing_token fence) {
+        auto window = std::chrono::microseconds(_sp._db.local().get_config().write_coalescing_window_in_us());
+        if (window.count() && forward.empty() && !tr_state && _sp.features().mutation_batch_verb) {
+            return send_mutation_coalesced(addr, window, timeout, m, response_id, rate_limit_info, fence);
+        }
+        return send_mutation(addr, timeout, tracing::make_trace_info(tr_state),
+                *m, forward, _sp.my_address(), _sp.get_token_metadata_ptr()->get_my_id(), this_shard_id(),
+                response_id, rate_limit_info, fence);
+    }
+
+    // Queues a write to be sent to a replica in a MUTATION_BATCH message,
+    // together with other writes queued within the window. The returned
+    // future resolves once the message is sent.
+    //
+    // The consistency level and the timeout of each write are still handled
+    // by its own response handler, which the replica answers separately.
+    future<> send_mutation_coalesced(
+            locator::host_id addr, std::chrono::microseconds window, storage_proxy::clock_type::time_point timeout,
+            lw_shared_ptr<const frozen_mutation> m, storage_proxy::response_id_type response_id,
+            db::per_partition_rate_limit::info rate_limit_info, fencing_token fence) {
+        auto& batches = _pending_mutation_batches[current_scheduling_group()];
+        auto it = batches.try_emplace(addr).first;
+        auto& batch = it->second;
+        batch.size += m->representation().size();
+        batch.timeout = std::max(batch.timeout, timeout);
+        batch.mutations.push_back(batched_mutation{std::move(m), response_id, rate_limit_info, fence});
+        batch.timeouts.push_back(timeout);
+        auto f = batch.sent.emplace_back().get_future();
+        ++_sp.get_stats().coalesced_mutations;
+
+        if (batch.mutations.size() >= max_mutation_batch_count || batch.size >= max_mutation_batch_size) {
+            auto full = std::move(batch);
+            batches.erase(it);
+            // Waited on by stop(), through the gate.
+            (void)seastar::with_gate(_mutation_batch_gate, [this, addr, full = std::move(full)] () mutable {
+                return send_mutation_batch(addr, std::move(full));
+            });
+        } else {
+            // Writes queued with different windows (see send_batchlog_replay_write())
+            // share the timer, so it fires when the shortest of them elapses.
+            auto deadline = seastar::steady_clock_type::now() + window;
+            if (!_mutation_batch_timer.armed() || _mutation_batch_timer.get_timeout() > deadline) {
+                _mutation_batch_timer.rearm(deadline);
+            }
+        }
+        return f;
+    }
+
+    // Sends a write of a replayed batch to a replica.
+    //
+    // The batchlog replay writes many batches at once, in the background, so
+    // its writes are always coalesced per replica, even if write coalescing
+    // is disabled for the other writes. They aren't sensitive to latency, so
+    // they are held for at least batchlog_replay_coalescing_window.
+    future<> send_batchlog_replay_write(
+            locator::host_id addr, storage_proxy::clock_type::time_point timeout, const tracing::trace_state_ptr& tr_state,
+            const lw_shared_ptr<const frozen_mutation>& m, const host_id_vector_replica_set& forward,
+            storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info,
+            fencing_token fence) {
+        if (forward.empty() && !tr_state && _sp.features().mutation_batch_verb) {
+            auto window = std::max(std::chrono::microseconds(_sp._db.local().get_config().write_coalescing_window_in_us()),
+                    batchlog_replay_coalescing_window);
+            return send_mutation_coalesced(addr, window, timeout, m, response_id, rate_limit_info, fence);
+        }
+        return send_write(addr, timeout, tr_state, m, forward, response_id, rate_limit_info, fence);
+    }
+
+    // Resolves once the message is sent, never fails.
+    future<> send_mutation_batch(locator::host_id addr, pending_mutation_batch batch) {
+        ++_sp.get_stats().mutation_batches;
+        // The timeout of the message is that of the write which expires last.
+        // The timeout of each write is sent relative to it, as clocks of the
+        // nodes differ, so that the replica doesn't apply expired writes.
+        for (size_t i = 0; i < batch.mutations.size(); i++) {
+            batch.mutations[i].expires_before = std::chrono::ceil<std::chrono::milliseconds>(batch.timeout - batch.timeouts[i]);
+        }
+        auto f = ser::storage_proxy_rpc_verbs::send_mutation_batch(&_ms, addr, batch.timeout,
+                std::move(batch.mutations), this_shard_id());
+        // Also waited on through the futures returned by send_mutation_coalesced().
+        return f.then_wrapped([sent = std::move(batch.sent)] (future<> f) mutable {
+            auto ex = f.failed() ? f.get_exception() : nullptr;
+            for (auto& p : sent) {
+                if (ex) {
+                    p.set_exception(ex);
+                } else {
+                    p.set_value();
+                }
+            }
+        });
+    }
+
+    void flush_mutation_batches() {
+        for (auto& [sg, batches] : std::exchange(_pending_mutation_batches, {})) {
+            // Send in the scheduling group of the writes, so that the batch
+            // goes over the connection of their tenant.
+            // Waited on by stop(), through the gate.
+            (void)seastar::with_gate(_mutation_batch_gate, [this, sg, batches = std::move(batches)] () mutable {
+                return with_scheduling_group(sg, [this, batches = std::move(batches)] () mutable {
+                    std::vector<future<>> sends;
+                    sends.reserve(batches.size());
+                    for (auto& [addr, batch] : batches) {
+                        sends.push_back(send_mutation_batch(addr, std::move(batch)));
+                    }
+                    return when_all_succeed(sends.begin(), sends.end()).discard_result();
+                });
+            });
+        }
+    }
+
     future<> send_hint_mutation(
             locator::host_id addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
             const frozen_mutation& m, const host_id_vector_replica_set& forward, gms::inet_address reply_to_ip, locator::host_id reply_to, unsigned shard,
@@ -448,9 +598,9 @@ class storage_proxy::remote {
 
     future<bool> send_paxos_accept(
             locator::host_id addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
-            const service::paxos::proposal& proposal) {
+            const service::paxos::proposal& proposal, const std::optional<service::paxos::accept_condition>& condition) {
         tracing::trace(tr_state, "accept_proposal: send accept {} to {}", proposal, addr);
-        return ser::storage_proxy_rpc_verbs::send_paxos_accept(&_ms, std::move(addr), timeout, proposal, tracing::make_trace_info(tr_state));
+        return ser::storage_proxy_rpc_verbs::send_paxos_accept(&_ms, std::move(addr), timeout, proposal, tracing::make_trace_info(tr_state), condition);
     }
 
     future<> send_paxos_learn(
@@ -710,6 +860,36 @@ class storage_proxy::remote {
                 });
     }
 
+    future<rpc::no_wait_type> receive_mutation_batch_handler(
+            const rpc::client_info& cinfo, rpc::opt_time_point t,
+            utils::chunked_vector<batched_mutation> mutations, unsigned shard) {
+        auto src_addr = cinfo.retrieve_auxiliary<locator::host_id>("host_id");
+        auto src_ip = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        // Coalesced writes aren't traced, and the coordinator is the one
+        // waiting for the responses.
+        const std::optional<tracing::trace_info> trace_info;
+        co_await parallel_for_each(mutations, [&] (batched_mutation& bm) {
+            auto schema_version = bm.fm->schema_version();
+            auto rate_limit_info = bm.rate_limit_info;
+            // Each write keeps its own timeout. An expired one is rejected
+            // and reported to the coordinator like any failed write.
+            auto timeout = t ? rpc::opt_time_point(*t - bm.expires_before) : t;
+            return handle_write(src_addr, timeout, schema_version, std::move(bm.fm), {}, src_ip, host_id_vector_replica_set{}, src_addr, shard, bm.response_id,
+                    trace_info,
+                    bm.fence,
+                    /* apply_fn */ [smp_grp = _sp._write_smp_service_group, rate_limit_info, src_addr] (shared_ptr<storage_proxy>& p, tracing::trace_state_ptr tr_state, schema_ptr s,
+                            const lw_shared_ptr<const frozen_mutation>& m, clock_type::time_point timeout, fencing_token fence) {
+                        return p->apply_fence(p->mutate_locally(std::move(s), *m, std::move(tr_state), db::commitlog::force_sync::no, timeout, smp_grp, rate_limit_info), fence, src_addr);
+                    },
+                    /* forward_fn */ [this, rate_limit_info] (shared_ptr<storage_proxy>& p, locator::host_id addr, clock_type::time_point timeout, const lw_shared_ptr<const frozen_mutation>& m,
+                            gms::inet_address ip, locator::host_id reply_to, unsigned shard, response_id_type response_id,
+                            const std::optional<tracing::trace_info>& trace_info, fencing_token fence) {
+                        return send_mutation(addr, timeout, trace_info, *m, {}, ip, reply_to, shard, response_id, rate_limit_info, fence);
+                    }).discard_result();
+        });
+        co_return netw::messaging_service::no_wait();
+    }
+
     future<rpc::no_wait_type> receive_hint_mutation_handler(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             frozen_mutation in, inet_address_vector_replica_set forward, gms::inet_address reply_to,
@@ -1001,9 +1181,14 @@ class storage_proxy::remote {
 
     future<bool> handle_paxos_accept(
             const rpc::client_info& cinfo, rpc::opt_time_point timeout,
-            paxos::proposal proposal, std::optional<tracing::trace_info> trace_info) {
+            paxos::proposal proposal, std::optional<tracing::trace_info> trace_info,
+            rpc::optional<std::optional<paxos::accept_condition>> condition_opt) {
         auto src_addr = cinfo.retrieve_auxiliary<locator::host_id>("host_id");
         auto src_shard = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto condition = condition_opt ? std::move(*condition_opt) : std::nullopt;
+        if (condition && !condition->cmd.max_result_size) {
+            condition->cmd.max_result_size.emplace(cinfo.retrieve_auxiliary<uint64_t>("max_result_size"));
+        }
 
         tracing::trace_state_ptr tr_state;
         if (trace_info) {
@@ -1022,8 +1207,8 @@ class storage_proxy::remote {
         bool local = shard == this_shard_id();
         _sp.get_stats().replica_cross_shard_ops += !local;
         co_return co_await _sp.container().invoke_on(shard, _sp._write_smp_service_group, coroutine::lambda([gs = global_schema_ptr(schema), gt = tracing::global_trace_state_ptr(tr_state),
-                                   proposal = std::move(proposal), timeout, token, this] (storage_proxy& sp) {
-            return paxos::paxos_state::accept(sp, paxos_store(), gt, gs, token, proposal, *timeout);
+                                   proposal = std::move(proposal), condition = std::move(condition), timeout, token, this] (storage_proxy& sp) {
+            return paxos::paxos_state::accept(sp, paxos_store(), gt, gs, token, proposal, condition, *timeout);
         }));
     }
 
@@ -1315,9 +1500,7 @@ class per_destination_mutation : public mutation_holder {
         auto m = _mutations[ep];
         if (m) {
             tracing::trace(tr_state, "Sending a mutation to /{}", ep);
-            return sp.remote().send_mutation(ep, timeout, tracing::make_trace_info(tr_state),
-                    *m, forward, sp.my_address(), sp.get_token_metadata_ptr()->get_my_id(), this_shard_id(),
-                    response_id, rate_limit_info, fence);
+            return sp.remote().send_write(ep, timeout, tr_state, m, forward, response_id, rate_limit_info, fence);
         }
         sp.got_response(response_id, ep, std::nullopt);
         return make_ready_future<>();
@@ -1364,9 +1547,7 @@ class shared_mutation : public mutation_holder {
             tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info,
             fencing_token fence) override {
         tracing::trace(tr_state, "Sending a mutation to /{}", ep);
-        return sp.remote().send_mutation(ep, timeout, tracing::make_trace_info(tr_state),
-                *_mutation, forward, sp.my_address(), sp.get_token_metadata_ptr()->get_my_id(), this_shard_id(),
-                response_id, rate_limit_info, fence);
+        return sp.remote().send_write(ep, timeout, tr_state, _mutation, forward, response_id, rate_limit_info, fence);
     }
     virtual bool is_shared() override {
         return true;
@@ -1399,6 +1580,20 @@ class hint_mutation : public shared_mutation {
     }
 };
 
+// shared mutation of a batch replayed from the batchlog, coalesced with the
+// other writes of the replay to the same replica
+class batchlog_replay_write : public shared_mutation {
+public:
+    using shared_mutation::shared_mutation;
+    virtual future<> apply_remotely(storage_proxy& sp, locator::host_id ep, const host_id_vector_replica_set& forward,
+            storage_proxy::response_id_type response_id, storage_proxy::clock_type::time_point timeout,
+            tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info,
+            fencing_token fence) override {
+        tracing::trace(tr_state, "Sending a replayed batch mutation to /{}", ep);
+        return sp.remote().send_batchlog_replay_write(ep, timeout, tr_state, _mutation, forward, response_id, rate_limit_info, fence);
+    }
+};
+
 // A Paxos (AKA Compare And Swap, CAS) protocol involves multiple roundtrips between the coordinator
 // and endpoint participants. Some endpoints may be unavailable or slow, and this does not stop the
 // protocol progress. paxos_response_handler stores the shared state of the storage proxy associated
@@ -1443,6 +1638,10 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
 
     // max pruning operations to run in parallel
     static constexpr uint16_t pruning_limit = 1000;
+    // max lease preparations to run in parallel
+    static constexpr uint16_t lease_preparing_limit = 1000;
+
+    future<> do_prepare_lease(utils::UUID decision_ballot);
 
 public:
     tracing::trace_state_ptr tr_state;
@@ -1467,9 +1666,17 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
     // Steps of the Paxos protocol
     future<ballot_and_data> begin_and_repair_paxos(client_state& cs, unsigned& contentions, bool is_write);
     future<paxos::prepare_summary> prepare_ballot(utils::UUID ballot);
-    future<bool> accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted = true);
+    future<bool> accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted = true,
+            std::optional<paxos::accept_condition> condition = std::nullopt);
     future<> learn_decision(lw_shared_ptr<paxos::proposal> proposal, bool allow_hints = false);
     void prune(utils::UUID ballot);
+    // Takes the lease of the key out of the lease map, if this coordinator holds
+    // one which the request can propose on.
+    std::optional<paxos::lease> take_lease();
+    // Prepares the round following the decision in the background, holding
+    // the cas lock of the key until done, and keeps the promise as a lease of
+    // the key if the replicas agree on its value.
+    void prepare_lease(utils::UUID decision_ballot, paxos::paxos_state::cas_lock_guard lock);
     uint64_t id() const {
         return _id;
     }
@@ -2086,6 +2293,7 @@ paxos_response_handler::begin_and_repair_paxos(client_state& cs, unsigned& conte
         paxos::paxos_state::logger.debug("CAS[{}] Preparing {}", _id, ballot);
         tracing::trace(tr_state, "Preparing {}", ballot);
 
+        ++_proxy->get_stats().cas_round_trips;
         paxos::prepare_summary summary = co_await prepare_ballot(ballot);
 
         if (!summary.promised) {
@@ -2114,10 +2322,12 @@ paxos_response_handler::begin_and_repair_paxos(client_state& cs, unsigned& conte
 
             auto refreshed_in_progress = make_lw_shared<paxos::proposal>(ballot, std::move(in_progress->update));
 
+            ++_proxy->get_stats().cas_round_trips;
             bool is_accepted = co_await accept_proposal(refreshed_in_progress, false);
 
             if (is_accepted) {
                 try {
+                    ++_proxy->get_stats().cas_round_trips;
                     co_await learn_decision(std::move(refreshed_in_progress), false);
                     continue;
                 } catch (mutation_write_timeout_exception& e) {
@@ -2160,6 +2370,7 @@ paxos_response_handler::begin_and_repair_paxos(client_state& cs, unsigned& conte
             // didn't), we could just wait for all the missing most recent commits to
             // acknowledge this decision and then move on with proposing our value.
             try {
+                ++_proxy->get_stats().cas_round_trips;
                 co_await std::move(f);
             } catch(...) {
                 paxos::paxos_state::logger.debug("CAS[{}] Failure during commit repair {}", _id, std::current_exception());
@@ -2328,7 +2539,8 @@ future<paxos::prepare_summary> paxos_response_handler::prepare_ballot(utils::UUI
 }
 
 // This function implements accept stage of the Paxos protocol.
-future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted) {
+future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::proposal> proposal, bool timeout_if_partially_accepted,
+        std::optional<paxos::accept_condition> condition) {
     struct {
         // the promise can be set before all replies are received at which point
         // the optional will be disengaged so further replies are ignored
@@ -2359,10 +2571,10 @@ future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::propos
     auto f = request_tracker.p->get_future();
 
     // We may continue collecting propose responses in the background after the reply is ready
-    (void)do_with(std::move(request_tracker), shared_from_this(), [this, timeout_if_partially_accepted, proposal = std::move(proposal)]
-                           (auto& request_tracker, shared_ptr<paxos_response_handler>& prh) -> future<> {
+    (void)do_with(std::move(request_tracker), shared_from_this(), [this, timeout_if_partially_accepted, proposal = std::move(proposal), condition = std::move(condition)]
+                           (auto& request_tracker, shared_ptr<paxos_response_handler>& prh) mutable -> future<> {
         paxos::paxos_state::logger.trace("CAS[{}] accept_proposal: sending commit {} to {}", _id, *proposal, _live_endpoints);
-        auto handle_one_msg = [this, &request_tracker, timeout_if_partially_accepted, proposal = std::move(proposal)] (locator::host_id peer) mutable -> future<> {
+        auto handle_one_msg = [this, &request_tracker, timeout_if_partially_accepted, proposal = std::move(proposal), condition = std::move(condition)] (locator::host_id peer) mutable -> future<> {
             bool is_timeout = false;
             std::optional<bool> accepted;
             const auto& topo = get_effective_replication_map()->get_topology();
@@ -2370,9 +2582,9 @@ future<bool> paxos_response_handler::accept_proposal(lw_shared_ptr<paxos::propos
             try {
                 if (topo.is_me(peer)) {
                     tracing::trace(tr_state, "accept_proposal: accept {} locally", *proposal);
-                    accepted = co_await paxos::paxos_state::accept(*_proxy, _proxy->remote().paxos_store(), tr_state, _schema, proposal->update.decorated_key(*_schema).token(), *proposal, _timeout);
+                    accepted = co_await paxos::paxos_state::accept(*_proxy, _proxy->remote().paxos_store(), tr_state, _schema, proposal->update.decorated_key(*_schema).token(), *proposal, condition, _timeout);
                 } else {
-                    accepted = co_await _proxy->remote().send_paxos_accept(peer, _timeout, tr_state, *proposal);
+                    accepted = co_await _proxy->remote().send_paxos_accept(peer, _timeout, tr_state, *proposal, condition);
                 }
             } catch(...) {
                 if (request_tracker.p) {
@@ -2566,6 +2778,109 @@ bool paxos_response_handler::learned(locator::host_id ep) {
     return false;
 }
 
+// Whether the two commands read the same data of a partition, so that the
+// result of one can stand for the result of the other.
+static bool is_same_read(const schema& s, const query::read_command& a, const query::read_command& b) {
+    const auto& sa = a.slice;
+    const auto& sb = b.slice;
+    if (sa.get_specific_ranges() || sb.get_specific_ranges()) {
+        return false;
+    }
+    return a.cf_id == b.cf_id
+        && a.schema_version == b.schema_version
+        && a.get_row_limit() == b.get_row_limit()
+        && a.partition_limit == b.partition_limit
+        && a.max_result_size == b.max_result_size
+        && a.tombstone_limit == b.tombstone_limit
+        && sa.options.mask() == sb.options.mask()
+        && sa.static_columns == sb.static_columns
+        && sa.regular_columns == sb.regular_columns
+        && sa.partition_row_limit() == sb.partition_row_limit()
+        && std::ranges::equal(sa.default_row_ranges(), sb.default_row_ranges(), [&s] (const query::clustering_range& x, const query::clustering_range& y) {
+            return x.equal(y, clustering_key_prefix::prefix_equal_tri_compare(s));
+        });
+}
+
+std::optional<paxos::lease> paxos_response_handler::take_lease() {
+    auto lease = _proxy->_paxos_leases.take(_schema->id(), _key, storage_proxy::clock_type::now());
+    if (!lease) {
+        return std::nullopt;
+    }
+    // The lease was granted by the replicas of another request, which is
+    // valid for this one only if it has the same participants and the data
+    // it was granted with is what this request reads.
+    if (lease->cl_for_paxos != _cl_for_paxos
+            || lease->topology_version != get_effective_replication_map()->get_token_metadata().get_version()
+            || lease->cmd->schema_version != _schema->version()
+            || !is_same_read(*_schema, *lease->cmd, *_cmd)) {
+        paxos::paxos_state::logger.debug("CAS[{}] Dropping lease {} granted for another request", _id, lease->ballot);
+        return std::nullopt;
+    }
+    return lease;
+}
+
+void paxos_response_handler::prepare_lease(utils::UUID decision_ballot, paxos::paxos_state::cas_lock_guard lock) {
+    if (_proxy->get_stats().cas_now_preparing_lease >= lease_preparing_limit) {
+        return;
+    }
+    _proxy->get_stats().cas_now_preparing_lease++;
+    // running in the background, but the amount of the bg job is limited by lease_preparing_limit,
+    // and waited for by holding shared pointer to storage_proxy, as for prune()
+    (void)do_prepare_lease(decision_ballot).then_wrapped([h = shared_from_this(), lock = std::move(lock)] (future<> f) {
+        h->_proxy->get_stats().cas_now_preparing_lease--;
+        if (f.failed()) {
+            paxos::paxos_state::logger.debug("CAS[{}] Failed to prepare lease: {}", h->_id, f.get_exception());
+        }
+    });
+}
+
+future<> paxos_response_handler::do_prepare_lease(utils::UUID decision_ballot) {
+    // Only the replicas which learned the decision can be relied on to return
+    // the value of the key with the decision applied.
+    if (_learned < _required_participants) {
+        co_return;
+    }
+    auto cmd = make_lw_shared<query::read_command>(*_cmd);
+    cmd->timestamp = gc_clock::now();
+    _cmd = cmd;
+    auto da = digest_algorithm(*_proxy);
+    // The ballot must be newer than the decision, for the replicas which
+    // haven't pruned it yet to agree that the round of the decision is over.
+    auto ballot_micros = std::max(api::new_timestamp(), utils::UUID_gen::micros_timestamp(decision_ballot) + 1);
+    utils::UUID ballot = utils::UUID_gen::get_random_time_UUID_from_micros(std::chrono::microseconds{ballot_micros});
+
+    paxos::paxos_state::logger.debug("CAS[{}] Preparing lease {}", _id, ballot);
+    tracing::trace(tr_state, "Preparing lease {}", ballot);
+
+    paxos::prepare_summary summary = co_await prepare_ballot(ballot);
+
+    // The lease is good only if no round was started since the decision, the
+    // replicas have nothing to repair, and they agree on the value of the key.
+    auto is_decision = [&] (const std::optional<paxos::proposal>& p) {
+        return !p || p->ballot == decision_ballot;
+    };
+    auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(ballot);
+    if (!summary.promised
+            || !is_decision(summary.most_recent_proposal)
+            || !is_decision(summary.most_recent_commit)
+            || !summary.replicas_missing_most_recent_commit(_schema, now_in_sec).empty()
+            || !summary.data || !summary.data->digest()) {
+        paxos::paxos_state::logger.debug("CAS[{}] Not taking lease {}", _id, ballot);
+        co_return;
+    }
+    auto period = std::chrono::milliseconds(_proxy->_db.local().get_config().paxos_lease_period_in_ms());
+    _proxy->_paxos_leases.insert(_schema->id(), _key, paxos::lease{
+        .ballot = ballot,
+        .cmd = std::move(cmd),
+        .digest_algorithm = da,
+        .data = std::move(summary.data),
+        .cl_for_paxos = _cl_for_paxos,
+        .topology_version = get_effective_replication_map()->get_token_metadata().get_version(),
+        .expires = storage_proxy::clock_type::now() + period,
+    });
+    ++_proxy->get_stats().cas_leases_granted;
+}
+
 query::max_result_size storage_proxy::get_max_result_size(const query::partition_slice& slice) const {
     if (_features.separate_page_size_and_safety_limit) {
         return _db.local().get_query_max_result_size();
@@ -2881,6 +3196,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of background read repairs"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("partial_read_repairs", read_repair_repaired_partially,
+                       sm::description("number of foreground read repairs which repaired only the clustering ranges the replicas disagreed on"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_total_operations("read_timeouts", [this]{return read_timeouts.count(); },
                        sm::description("number of read request failed due to a timeout"),
                        {storage_proxy_stats::current_scheduling_group_label(), basic_level}).set_skip_when_empty(),
@@ -2913,6 +3232,18 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of speculative data read requests that were sent"),
                        {storage_proxy_stats::current_scheduling_group_label(), basic_level}).set_skip_when_empty(),
 
+        sm::make_total_operations("speculative_reads_throttled", speculative_reads_throttled,
+                       sm::description("number of speculative read requests that were not sent, because the budget of hedged reads was exhausted (see read_hedging_budget)"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("coalesced_mutations", coalesced_mutations,
+                       sm::description("number of mutations sent to replicas together with other mutations, in a single message (see write_coalescing_window_in_us)"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("mutation_batches", mutation_batches,
+                       sm::description("number of messages carrying coalesced mutations sent to replicas"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_summary("cas_read_latency_summary", sm::description("CAS read latency summary"), [this] {return to_metrics_summary(cas_read.summary());})(storage_proxy_stats::current_scheduling_group_label())(basic_level)(cas_label).set_skip_when_empty(),
         sm::make_summary("cas_write_latency_summary", sm::description("CAS write latency summary"), [this] {return to_metrics_summary(cas_write.summary());})(storage_proxy_stats::current_scheduling_group_label())(basic_level)(cas_label).set_skip_when_empty(),
 
@@ -2981,6 +3312,22 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of total paxos operations executed (reads and writes)"),
                        {storage_proxy_stats::current_scheduling_group_label(), basic_level, cas_label}).set_skip_when_empty(),
 
+        sm::make_total_operations("cas_round_trips", cas_round_trips,
+                       sm::description("number of paxos rounds paxos operations waited for"),
+                       {storage_proxy_stats::current_scheduling_group_label(), basic_level, cas_label}).set_skip_when_empty(),
+
+        sm::make_total_operations("cas_lease_hits", cas_lease_hits,
+                       sm::description("number of paxos operations which skipped the prepare round by proposing on a lease"),
+                       {storage_proxy_stats::current_scheduling_group_label(), basic_level, cas_label}).set_skip_when_empty(),
+
+        sm::make_total_operations("cas_lease_misses", cas_lease_misses,
+                       sm::description("number of paxos operations whose proposal made on a lease was rejected"),
+                       {storage_proxy_stats::current_scheduling_group_label(), basic_level, cas_label}).set_skip_when_empty(),
+
+        sm::make_total_operations("cas_leases_granted", cas_leases_granted,
+                       sm::description("number of leases granted to this coordinator by the replicas"),
+                       {storage_proxy_stats::current_scheduling_group_label(), basic_level, cas_label}).set_skip_when_empty(),
+
         sm::make_gauge("cas_foreground", cas_foreground,
                         sm::description("how many paxos operations that did not yet produce a result are running"),
                         {storage_proxy_stats::current_scheduling_group_label(), basic_level, cas_label}).set_skip_when_empty(),
@@ -3505,7 +3852,7 @@ storage_proxy::create_write_response_handler(const hint_wrapper& h, db::consiste
 
 result<storage_proxy::response_id_type>
 storage_proxy::create_write_response_handler(const batchlog_replay_mutation& m, db::consistency_level cl, db::write_type type, tracing::trace_state_ptr tr_state, service_permit permit, db::allow_per_partition_rate_limit allow_limit, coordinator_mutate_options options) {
-    return create_write_response_handler_helper(m.mut.schema(), m.mut.token(), std::make_unique<shared_mutation>(m.mut), cl, type, tr_state,
+    return create_write_response_handler_helper(m.mut.schema(), m.mut.token(), std::make_unique<batchlog_replay_write>(m.mut), cl, type, tr_state,
             std::move(permit), allow_limit, is_cancellable::yes, std::move(options));
 }
 
@@ -5326,24 +5673,30 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         }
     }
     future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> make_digest_request(locator::host_id ep, clock_type::time_point timeout) {
+        return make_digest_request(_cmd, ep, timeout, _rate_limit_info);
+    }
+    future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> make_digest_request(lw_shared_ptr<query::read_command> cmd, locator::host_id ep,
+            clock_type::time_point timeout, db::per_partition_rate_limit::info rate_limit_info) {
         ++_proxy->get_stats().digest_read_attempts.get_ep_stat(get_topology(), ep);
         auto fence = storage_proxy::get_fence(*_effective_replication_map_ptr);
         if (_proxy->is_me(*_effective_replication_map_ptr, ep)) {
             tracing::trace(_trace_state, "read_digest: querying locally");
-            return _proxy->apply_fence(_proxy->query_result_local_digest(_effective_replication_map_ptr, _schema, _cmd, _partition_range, _trace_state,
-                        timeout, digest_algorithm(*_proxy), adjust_rate_limit_for_local_operation(_rate_limit_info)), fence, _proxy->my_address());
+            return _proxy->apply_fence(_proxy->query_result_local_digest(_effective_replication_map_ptr, _schema, cmd, _partition_range, _trace_state,
+                        timeout, digest_algorithm(*_proxy), adjust_rate_limit_for_local_operation(rate_limit_info)), fence, _proxy->my_address());
         } else {
             tracing::trace(_trace_state, "read_digest: sending a message to /{}", ep);
-            const bool format_reverse_required = _cmd->slice.is_reversed() && !_native_reversed_queries_enabled;
-            auto cmd = format_reverse_required ? reversed(::make_lw_shared(*_cmd)) : _cmd;
-            return _proxy->remote().send_read_digest(ep, timeout, _trace_state, *cmd, _partition_range, digest_algorithm(*_proxy), _rate_limit_info, fence);
+            const bool format_reverse_required = cmd->slice.is_reversed() && !_native_reversed_queries_enabled;
+            cmd = format_reverse_required ? reversed(::make_lw_shared(*cmd)) : cmd;
+            return _proxy->remote().send_read_digest(ep, timeout, _trace_state, *cmd, _partition_range, digest_algorithm(*_proxy), rate_limit_info, fence);
         }
     }
     void make_mutation_data_requests(lw_shared_ptr<query::read_command> cmd, data_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const locator::host_id& ep : std::ranges::subrange(begin, end)) {
+            _proxy->_replica_load.on_request_sent(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
+                _proxy->_replica_load.on_request_done(ep, latency_clock::now() - start);
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
@@ -5368,8 +5721,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         auto start = latency_clock::now();
         for (const locator::host_id& ep : std::ranges::subrange(begin, end)) {
+            _proxy->_replica_load.on_request_sent(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
+                _proxy->_replica_load.on_request_done(ep, latency_clock::now() - start);
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
@@ -5378,7 +5733,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     resolver->add_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().data_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(latency_clock::now() - start, ep);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -5395,8 +5750,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const locator::host_id& ep : std::ranges::subrange(begin, end)) {
+            _proxy->_replica_load.on_request_sent(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> f) {
+                _proxy->_replica_load.on_request_done(ep, latency_clock::now() - start);
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
@@ -5405,7 +5762,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     resolver->add_digest(ep, std::get<0>(v), std::get<1>(v), std::get<3>(std::move(v)));
                     ++_proxy->get_stats().digest_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(latency_clock::now() - start, ep);
                     return;
                   } else {
                     ex = f.get_exception();
@@ -5436,6 +5793,25 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         return _cmd->partition_limit;
     }
     virtual void adjust_targets_for_reconciliation() {}
+    // Fails the read with the error the read repair write failed with, if
+    // any, and returns whether it did.
+    bool fail_on_repair_error(future<::result<>>&& f) {
+        bool failed = true;
+        // All errors are handled, it's OK to discard the result.
+        (void)utils::result_try([&] () -> ::result<> {
+            auto res = f.get();
+            failed = !res;
+            return res;
+        },  utils::result_catch<mutation_write_timeout_exception>([&] (const auto&) -> ::result<> {
+            // convert write error to read error
+            _result_promise.set_value(read_timeout_exception(_schema->ks_name(), _schema->cf_name(), _cl, _block_for - 1, _block_for, true));
+            return bo::success();
+        }), utils::result_catch_dots([&] (auto&& handle) -> ::result<> {
+            handle.forward_to_promise(_result_promise);
+            return bo::success();
+        }));
+        return failed;
+    }
     void reconcile(db::consistency_level cl, storage_proxy::clock_type::time_point timeout, lw_shared_ptr<query::read_command> cmd) {
         adjust_targets_for_reconciliation();
         data_resolver_ptr data_resolver = ::make_shared<data_read_resolver>(_schema, cl, _targets.size(), timeout);
@@ -5502,21 +5878,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     // trigger repair multiple times and to prevent quorum read to return an old value, even after a quorum
                     // another read had returned a newer value (but the newer value had not yet been sent to the other replicas)
                     // Waited on indirectly.
-                    (void)_proxy->schedule_repair(_effective_replication_map_ptr, std::move(diffs), _cl, _trace_state, _permit).then(utils::result_wrap([this, result = std::move(result)] () mutable {
-                        _result_promise.set_value(std::move(result));
-                        return make_ready_future<::result<>>(bo::success());
-                    })).then_wrapped([this, exec] (future<::result<>>&& f) {
-                        // All errors are handled, it's OK to discard the result.
-                        (void)utils::result_try([&] {
-                            return f.get();
-                        },  utils::result_catch<mutation_write_timeout_exception>([&] (const auto&) -> ::result<> {
-                            // convert write error to read error
-                            _result_promise.set_value(read_timeout_exception(_schema->ks_name(), _schema->cf_name(), _cl, _block_for - 1, _block_for, true));
-                            return bo::success();
-                        }), utils::result_catch_dots([&] (auto&& handle) -> ::result<> {
-                            handle.forward_to_promise(_result_promise);
-                            return bo::success();
-                        }));
+                    (void)_proxy->schedule_repair(_effective_replication_map_ptr, std::move(diffs), _cl, _trace_state, _permit).then_wrapped([this, exec, result = std::move(result)] (future<::result<>>&& f) mutable {
+                        if (!fail_on_repair_error(std::move(f))) {
+                            _result_promise.set_value(std::move(result));
+                        }
                         on_read_resolved();
                     });
                 } else {
@@ -5573,6 +5938,213 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         reconcile(cl, timeout, _cmd);
     }
 
+    // Partial read repair (see read_repair_digest_tree_fanout).
+    //
+    // When the replicas of a single large partition disagree, they usually
+    // disagree on only a few of its rows. So rather than reading the whole
+    // partition from all of them, compare the digests of a few clustering
+    // ranges of the partition, split further the ranges the replicas
+    // disagree on, as if descending a merkle tree built on demand, and read
+    // and repair only the ranges they still disagree on at the bottom. The
+    // ranges are split on the rows the data replica returned.
+    static constexpr unsigned max_digest_tree_depth = 3;
+
+    struct digest_tree_node {
+        position_range range;
+        // The rows of the data replica in the range, [begin, end).
+        size_t begin;
+        size_t end;
+    };
+
+    // Returns the clustering keys of the rows of the partition in the result
+    // of the data replica, if the partition can be repaired partially.
+    utils::chunked_vector<clustering_key> keys_for_partial_repair(const query::result& data, unsigned fanout) const {
+        if (fanout < 2
+                || !_partition_range.is_singular()
+                || !_partition_range.start()->value().has_key()
+                || !_schema->clustering_key_size()
+                || _cmd->slice.is_reversed()
+                || _cmd->slice.get_specific_ranges()
+                || !_cmd->slice.options.contains<query::partition_slice::option::send_clustering_key>()
+                || data.is_short_read()) {
+            return {};
+        }
+        struct key_collector : public query::result_visitor {
+            utils::chunked_vector<clustering_key>& keys;
+            void accept_new_row(const clustering_key& key, const query::result_row_view&, const query::result_row_view&) {
+                keys.push_back(key);
+            }
+            void accept_new_row(const query::result_row_view&, const query::result_row_view&) {}
+        };
+        utils::chunked_vector<clustering_key> keys;
+        query::result_view::consume(data, _cmd->slice, key_collector{{}, keys});
+        // The result may miss rows of the partition if it hit the limits.
+        if (keys.size() < 2 * fanout || keys.size() >= std::min(_cmd->get_row_limit(), _cmd->slice.partition_row_limit())) {
+            return {};
+        }
+        return keys;
+    }
+
+    std::vector<digest_tree_node> split_digest_tree_node(const digest_tree_node& node, const utils::chunked_vector<clustering_key>& keys, unsigned fanout) const {
+        std::vector<digest_tree_node> children;
+        children.reserve(fanout);
+        auto start = node.range.start();
+        auto begin = node.begin;
+        for (unsigned i = 1; i <= fanout; ++i) {
+            auto end = node.begin + (node.end - node.begin) * i / fanout;
+            auto end_pos = i == fanout ? node.range.end() : position_in_partition::before_key(keys[end]);
+            children.push_back({position_range(std::move(start), end_pos), begin, end});
+            start = std::move(end_pos);
+            begin = end;
+        }
+        return children;
+    }
+
+    // The part of the ranges which is within range.
+    clustering_interval_set clip(const clustering_interval_set& ranges, const position_range& range) const {
+        position_in_partition::less_compare less(*_schema);
+        clustering_interval_set clipped;
+        for (position_range r : ranges) {
+            position_in_partition start = std::max(r.start(), range.start(), less);
+            position_in_partition end = std::min(r.end(), range.end(), less);
+            if (less(start, end)) {
+                clipped.add(*_schema, position_range(std::move(start), std::move(end)));
+            }
+        }
+        return clipped;
+    }
+
+    // Returns the ranges of the partition the replicas disagree on, or
+    // nullopt if they disagree on all of them or agree on all of them.
+    future<std::optional<clustering_interval_set>> find_divergent_ranges(clock_type::time_point timeout, const utils::chunked_vector<clustering_key>& keys, unsigned fanout) {
+        const auto& pk = *_partition_range.start()->value().key();
+        const clustering_interval_set ranges(*_schema, _cmd->slice.default_row_ranges());
+        auto level = split_digest_tree_node({position_range::all_clustered_rows(), 0, keys.size()}, keys, fanout);
+        clustering_interval_set divergent;
+        bool any_divergent = false;
+        for (unsigned depth = 1; !level.empty(); ++depth) {
+            std::vector<future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>>> requests;
+            requests.reserve(level.size() * _targets.size());
+            for (const auto& node : level) {
+                auto cmd = make_lw_shared<query::read_command>(*_cmd);
+                cmd->slice.set_range(*_schema, pk, clip(ranges, node.range).to_clustering_row_ranges());
+                for (const auto& ep : _targets) {
+                    requests.push_back(make_digest_request(cmd, ep, timeout, {}));
+                }
+            }
+            auto replies = co_await when_all_succeed(requests.begin(), requests.end());
+            std::vector<digest_tree_node> next_level;
+            size_t divergent_nodes = 0;
+            for (size_t i = 0; i < level.size(); ++i) {
+                auto node_replies = std::span(replies).subspan(i * _targets.size(), _targets.size());
+                auto& digest = std::get<0>(node_replies.front());
+                if (std::ranges::all_of(node_replies, [&] (const auto& r) { return std::get<0>(r) == digest; })) {
+                    continue;
+                }
+                ++divergent_nodes;
+                const auto& node = level[i];
+                if (depth < max_digest_tree_depth && node.end - node.begin > fanout) {
+                    std::ranges::move(split_digest_tree_node(node, keys, fanout), std::back_inserter(next_level));
+                } else {
+                    divergent.add(*_schema, clip(ranges, node.range));
+                    any_divergent = true;
+                }
+            }
+            if (depth == 1 && divergent_nodes == level.size()) {
+                co_return std::nullopt;
+            }
+            level = std::move(next_level);
+        }
+        if (!any_divergent) {
+            co_return std::nullopt;
+        }
+        co_return divergent;
+    }
+
+    future<::result<>> repair_ranges(clock_type::time_point timeout, const clustering_interval_set& divergent) {
+        auto cmd = make_lw_shared<query::read_command>(*_cmd);
+        cmd->slice.set_range(*_schema, *_partition_range.start()->value().key(), divergent.to_clustering_row_ranges());
+        if (_proxy->features().empty_replica_mutation_pages) {
+            cmd->slice.options.set<query::partition_slice::option::allow_mutation_read_page_without_live_row>();
+        }
+        auto data_resolver = ::make_shared<data_read_resolver>(_schema, _cl, _targets.size(), timeout);
+        make_mutation_data_requests(cmd, data_resolver, _targets.begin(), _targets.end(), timeout);
+        auto res = co_await data_resolver->done();
+        if (!res) {
+            co_return std::move(res).as_failure();
+        }
+        auto rr_opt = co_await data_resolver->resolve(*cmd, cmd->get_row_limit(), cmd->slice.partition_row_limit(), cmd->partition_limit);
+        if (!rr_opt) {
+            // Some replica cut its reply short, the read which follows the
+            // repair falls back to repairing the whole partition.
+            co_return bo::success();
+        }
+        co_return co_await _proxy->schedule_repair(_effective_replication_map_ptr, data_resolver->get_diffs_for_repair(), _cl, _trace_state, _permit);
+    }
+
+    future<> repair_partially(clock_type::time_point timeout, utils::chunked_vector<clustering_key> keys, unsigned fanout) {
+        auto exec = shared_from_this();
+        adjust_targets_for_reconciliation();
+        std::optional<clustering_interval_set> divergent;
+        try {
+            divergent = co_await find_divergent_ranges(timeout, keys, fanout);
+        } catch (...) {
+            slogger.debug("Failed to compare digests of clustering ranges: {}", std::current_exception());
+        }
+        if (!divergent) {
+            tracing::trace(_trace_state, "Could not narrow down the divergent clustering ranges, repairing the whole partition");
+            reconcile(_cl, timeout);
+            co_return;
+        }
+        tracing::trace(_trace_state, "Repairing divergent clustering ranges {}", *divergent);
+        _proxy->get_stats().read_repair_repaired_partially++;
+        try {
+            auto f = co_await coroutine::as_future(repair_ranges(timeout, *divergent));
+            if (fail_on_repair_error(std::move(f))) {
+                on_read_resolved();
+                co_return;
+            }
+            // Only the data replica returned the rows of the partition, and
+            // it may have been the one missing some of them, so read the
+            // partition again now that the replicas should agree on it.
+            _used_targets.clear();
+            auto digest_resolver = make_digest_resolver(timeout);
+            abstract_read_executor::make_requests(digest_resolver, timeout);
+            auto res = co_await digest_resolver->has_cl();
+            if (!res) {
+                _result_promise.set_value(std::move(res).as_failure());
+                on_read_resolved();
+                co_return;
+            }
+            auto&& [result, digests_match] = res.value();
+            if (!digests_match) {
+                tracing::trace(_trace_state, "Digest mismatch after repairing the divergent clustering ranges, repairing the whole partition");
+                reconcile(_cl, timeout);
+                co_return;
+            }
+            set_min_last_position(*digest_resolver, *result);
+            _result_promise.set_value(std::move(result));
+        } catch (...) {
+            _result_promise.set_exception(std::current_exception());
+        }
+        on_read_resolved();
+    }
+
+    digest_resolver_ptr make_digest_resolver(storage_proxy::clock_type::time_point timeout) {
+        return ::make_shared<digest_read_resolver>(_proxy, _effective_replication_map_ptr, _schema, _cl, _block_for,
+                db::is_datacenter_local(_cl) ? _effective_replication_map_ptr->get_topology().count_local_endpoints(_targets): _targets.size(), timeout);
+    }
+
+    void set_min_last_position(const digest_read_resolver& digest_resolver, query::result& result) {
+        if (_proxy->features().empty_replica_pages && digest_resolver.response_count() > 1) {
+            auto& mp = digest_resolver.min_position();
+            auto& lp = result.last_position();
+            if (!mp || bool(lp) < bool(mp) || full_position::cmp(*_schema, *mp, *lp) < 0) {
+                result.set_last_position(mp);
+            }
+        }
+    }
+
 public:
     future<result<foreign_ptr<lw_shared_ptr<query::result>>>> execute(storage_proxy::clock_type::time_point timeout) {
         if (_targets.empty()) {
@@ -5580,8 +6152,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
             // Return an empty result in this case
             return make_ready_future<result<foreign_ptr<lw_shared_ptr<query::result>>>>(make_foreign(make_lw_shared(query::result())));
         }
-        digest_resolver_ptr digest_resolver = ::make_shared<digest_read_resolver>(_proxy, _effective_replication_map_ptr, _schema, _cl, _block_for,
-                db::is_datacenter_local(_cl) ? _effective_replication_map_ptr->get_topology().count_local_endpoints(_targets): _targets.size(), timeout);
+        digest_resolver_ptr digest_resolver = make_digest_resolver(timeout);
         auto exec = shared_from_this();
 
         make_requests(digest_resolver, timeout);
@@ -5600,13 +6171,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                 auto&& [result, digests_match] = res.value();
 
                 if (digests_match) {
-                    if (exec->_proxy->features().empty_replica_pages && digest_resolver->response_count() > 1) {
-                        auto& mp = digest_resolver->min_position();
-                        auto& lp = result->last_position();
-                        if (!mp || bool(lp) < bool(mp) || full_position::cmp(*exec->_schema, *mp, *lp) < 0) {
-                            result->set_last_position(mp);
-                        }
-                    }
+                    exec->set_min_last_position(*digest_resolver, *result);
                     exec->_result_promise.set_value(std::move(result));
                     if (exec->_block_for < exec->_targets.size()) { // if there are more targets then needed for cl, check digest in background
                         background_repair_check = true;
@@ -5632,8 +6197,15 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                             exec->_targets.erase(i, exec->_targets.end());
                         }
                     }
-                    tracing::trace(exec->_trace_state, "digest mismatch, starting read repair");
-                    exec->reconcile(exec->_cl, timeout);
+                    auto fanout = exec->_proxy->_db.local().get_config().read_repair_digest_tree_fanout();
+                    if (auto keys = exec->keys_for_partial_repair(*result, fanout); !keys.empty()) {
+                        tracing::trace(exec->_trace_state, "digest mismatch, starting partial read repair");
+                        // Waited on indirectly.
+                        (void)exec->repair_partially(timeout, std::move(keys), fanout);
+                    } else {
+                        tracing::trace(exec->_trace_state, "digest mismatch, starting read repair");
+                        exec->reconcile(exec->_cl, timeout);
+                    }
                     exec->_proxy->get_stats().read_repair_repaired_blocking++;
                 }
                 return bo::success();
@@ -5679,6 +6251,12 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void register_request_latency(latency_clock::duration d) {
         _max_request_latency = std::max(_max_request_latency, d);
     }
+    void register_request_latency(latency_clock::duration d, locator::host_id ep) {
+        register_request_latency(d);
+        if (_proxy->get_db().local().get_config().adaptive_read_hedging()) {
+            _cf->add_replica_read_latency(ep, d);
+        }
+    }
 
     static constexpr latency_clock::duration NO_LATENCY{-1};
     latency_clock::duration _max_request_latency{NO_LATENCY};
@@ -5726,8 +6304,24 @@ class speculating_read_executor : public abstract_read_executor {
                                               ", required at least 2 replicas",
                                               _targets.size()));
         }
-        _speculate_timer.set_callback([this, resolver, timeout] {
+        auto& cfg = _proxy->get_db().local().get_config();
+        auto& sr = _schema->speculative_retry();
+        // Fixed delays (CUSTOM) are left as configured by the user.
+        const bool adaptive = cfg.adaptive_read_hedging() && sr.get_type() == speculative_retry::type::PERCENTILE;
+        if (adaptive) {
+            _proxy->_hedged_read_budget.earn(cfg.read_hedging_budget());
+        }
+        _speculate_timer.set_callback([this, resolver, timeout, adaptive] {
             if (!resolver->is_completed()) { // at the time the callback runs request may be completed already
+                if (adaptive) {
+                    // Don't let hedging amplify an overload, when many reads
+                    // are slow.
+                    if (!_proxy->_hedged_read_budget.try_spend()) {
+                        _proxy->get_stats().speculative_reads_throttled++;
+                        tracing::trace(_trace_state, "Not launching speculative retry, hedged reads budget exhausted");
+                        return;
+                    }
+                }
                 resolver->add_wait_targets(1); // we send one more request so wait for it too
                 // FIXME: consider disabling for CL=*ONE
                 auto send_request = [&] (bool has_data) {
@@ -5744,10 +6338,9 @@ class speculating_read_executor : public abstract_read_executor {
                 send_request(resolver->has_data());
             }
         });
-        auto& sr = _schema->speculative_retry();
         auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
-            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
-            std::chrono::milliseconds(unsigned(sr.get_value()));
+            std::min(speculation_delay_percentile(sr.get_value(), adaptive), std::chrono::duration_cast<storage_proxy::clock_type::duration>(std::chrono::milliseconds(cfg.read_request_timeout_in_ms()/2))) :
+            std::chrono::duration_cast<storage_proxy::clock_type::duration>(std::chrono::milliseconds(unsigned(sr.get_value())));
         _speculate_timer.arm(t);
 
         // if CL + RR result in covering all replicas, getReadExecutor forces AlwaysSpeculating.  So we know
@@ -5774,6 +6367,19 @@ class speculating_read_executor : public abstract_read_executor {
     virtual void adjust_targets_for_reconciliation() override {
         _targets = used_targets();
     }
+private:
+    // The delay after which to speculate: the percentile of the latency of
+    // reads of the table, or, with adaptive hedging, of reads of the table
+    // sent to the replica which the data is read from, if enough of them were
+    // made recently.
+    storage_proxy::clock_type::duration speculation_delay_percentile(double percentile, bool adaptive) {
+        if (adaptive) {
+            if (auto t = _cf->get_replica_read_latency_percentile(_targets.front(), percentile)) {
+                return std::chrono::ceil<storage_proxy::clock_type::duration>(*t);
+            }
+        }
+        return _cf->get_coordinator_read_latency_percentile(percentile);
+    }
 };
 
 result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw_shared_ptr<query::read_command> cmd,
@@ -5802,6 +6408,9 @@ result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw
     host_id_vector_replica_set target_replicas = filter_replicas_for_read(cl, *erm, all_replicas, preferred_endpoints, repair_decision,
             retry_type == speculative_retry::type::NONE ? nullptr : &extra_replica,
             _db.local().get_config().cache_hit_rate_read_balancing() ? &*cf : nullptr);
+    if (repair_decision == db::read_repair_decision::NONE && _db.local().get_config().load_aware_read_balancing()) {
+        divert_reads_from_loaded_replicas(*erm, target_replicas, all_replicas, preferred_endpoints, &extra_replica);
+    }
 
     slogger.trace("creating read executor for token {} with all: {} targets: {} rp decision: {}", token, all_replicas, target_replicas, repair_decision);
     tracing::trace(trace_state, "Creating read executor for token {} with all: {} targets: {} repair decision: {}", token, all_replicas, target_replicas, repair_decision);
@@ -6610,11 +7219,35 @@ future<bool> storage_proxy::cas(schema_ptr schema, cas_shard cas_shard, shared_p
 
         co_await utils::get_local_injector().inject("cas_timeout_after_lock", write_timeout + std::chrono::milliseconds(100));
 
+        // If the replicas promised this coordinator the round following the
+        // previous one of the key, propose on that promise right away.
+        auto lease = handler->take_lease();
+        utils::UUID decision_ballot;
+
         while (true) {
-            // Finish the previous PAXOS round, if any, and, as a side effect, compute
-            // a ballot (round identifier) which is a) unique b) has good chances of being
-            // recent enough.
-            auto [ballot, qr] = co_await handler->begin_and_repair_paxos(query_options.cstate, contentions, write);
+            utils::UUID ballot;
+            foreign_ptr<lw_shared_ptr<query::result>> qr;
+            std::optional<paxos::accept_condition> condition;
+            if (lease) {
+                // The ballot is newer than the lease, so that the replicas accept it
+                // without preparing it, and not older than the timestamps the client
+                // was assigned before (#7801).
+                auto ballot_micros = query_options.cstate.get_timestamp_for_paxos(utils::UUID_gen::micros_timestamp(lease->ballot) + 1);
+                ballot = utils::UUID_gen::get_random_time_UUID_from_micros(std::chrono::microseconds{ballot_micros});
+                qr = std::move(lease->data);
+                condition = paxos::accept_condition{lease->ballot, *lease->cmd, lease->digest_algorithm, *qr->digest()};
+                lease.reset();
+                paxos::paxos_state::logger.debug("CAS[{}] Proposing {} on lease {}", handler->id(), ballot, condition->promised_ballot);
+                tracing::trace(handler->tr_state, "Proposing {} on lease {}", ballot, condition->promised_ballot);
+            } else {
+                // Finish the previous PAXOS round, if any, and, as a side effect, compute
+                // a ballot (round identifier) which is a) unique b) has good chances of being
+                // recent enough.
+                auto ballot_and_data = co_await handler->begin_and_repair_paxos(query_options.cstate, contentions, write);
+                ballot = ballot_and_data.ballot;
+                qr = std::move(ballot_and_data.data);
+            }
+            const bool on_lease = bool(condition);
             // Read the current values and check they validate the conditions.
             if (qr) {
                 paxos::paxos_state::logger.debug("CAS[{}]: Using prefetched values for CAS precondition",
@@ -6627,6 +7260,7 @@ future<bool> storage_proxy::cas(schema_ptr schema, cas_shard cas_shard, shared_p
                 ++get_stats().cas_failed_read_round_optimization;
 
                 auto pr = partition_ranges; // cannot move original because it can be reused during retry
+                ++get_stats().cas_round_trips;
                 auto cqr = co_await query(schema, cmd, std::move(pr), cl, query_options);
                 qr = std::move(cqr.query_result);
             }
@@ -6655,12 +7289,14 @@ future<bool> storage_proxy::cas(schema_ptr schema, cas_shard cas_shard, shared_p
 
             auto proposal = make_lw_shared<paxos::proposal>(ballot, freeze(*mutation));
 
-            bool is_accepted = co_await handler->accept_proposal(proposal);
+            ++get_stats().cas_round_trips;
+            bool is_accepted = co_await handler->accept_proposal(proposal, true, std::move(condition));
             if (is_accepted) {
                 // The majority (aka a QUORUM) has promised the coordinator to
                 // accept the action associated with the computed ballot.
                 // Apply the mutation.
                 try {
+                  ++get_stats().cas_round_trips;
                   co_await handler->learn_decision(std::move(proposal));
                 } catch (unavailable_exception& e) {
                     // if learning stage encountered unavailablity error lets re-map it to a write error
@@ -6672,7 +7308,18 @@ future<bool> storage_proxy::cas(schema_ptr schema, cas_shard cas_shard, shared_p
                 }
                 paxos::paxos_state::logger.debug("CAS[{}] successful", handler->id());
                 tracing::trace(handler->tr_state, "CAS successful");
+                if (on_lease) {
+                    ++get_stats().cas_lease_hits;
+                }
+                decision_ballot = ballot;
                 break;
+            } else if (on_lease) {
+                // Another coordinator prepared a round of the key or the key was
+                // written since the lease was granted, so the proposal has to be
+                // made on a prepared ballot after all.
+                paxos::paxos_state::logger.debug("CAS[{}] PAXOS proposal made on lease not accepted", handler->id());
+                tracing::trace(handler->tr_state, "PAXOS proposal made on lease not accepted");
+                ++get_stats().cas_lease_misses;
             } else {
                 paxos::paxos_state::logger.debug("CAS[{}] PAXOS proposal not accepted (preempted by a higher ballot)",
                         handler->id());
@@ -6681,6 +7328,10 @@ future<bool> storage_proxy::cas(schema_ptr schema, cas_shard cas_shard, shared_p
                 co_await sleep_approx_50ms();
             }
         }
+
+        if (local_db().get_config().paxos_lease_period_in_ms() > 0 && _features.lwt_leases) {
+            handler->prepare_lease(decision_ballot, std::move(l));
+        }
     } catch (read_failure_exception& ex) {
         write ? throw read_failure_to_write(schema, ex) : throw;
     } catch (read_timeout_exception& ex) {
@@ -6742,6 +7393,40 @@ void storage_proxy::sort_endpoints_by_proximity(const locator::effective_replica
     }
 }
 
+// Power of two choices: each target of a read (other than this node and the
+// replicas preferred by the client) is compared with a random other
+// candidate from the same DC, and replaced with it if it is considerably
+// more loaded. Since the targets were chosen by proximity and cache hit
+// rate, that choice stands unless a replica is in trouble.
+void storage_proxy::divert_reads_from_loaded_replicas(const locator::effective_replication_map& erm, host_id_vector_replica_set& targets,
+        const host_id_vector_replica_set& all_replicas, const host_id_vector_replica_set& preferred_endpoints, std::optional<locator::host_id>* extra) {
+    const auto& topology = erm.get_topology();
+    auto is_target = [&] (locator::host_id ep) {
+        return std::ranges::find(targets, ep) != targets.end();
+    };
+    for (auto& target : targets) {
+        if (is_me(erm, target) || std::ranges::find(preferred_endpoints, target) != preferred_endpoints.end()) {
+            continue;
+        }
+        const auto& dc = topology.get_datacenter(target);
+        auto candidates = all_replicas | std::views::filter([&] (locator::host_id ep) {
+            return !is_target(ep) && topology.get_datacenter(ep) == dc;
+        }) | std::ranges::to<host_id_vector_replica_set>();
+        if (candidates.empty()) {
+            continue;
+        }
+        static thread_local std::default_random_engine re{std::random_device{}()};
+        auto alternative = candidates[std::uniform_int_distribution<size_t>(0, candidates.size() - 1)(re)];
+        if (_replica_load.prefer_alternative(target, alternative)) {
+            if (*extra == alternative) {
+                *extra = target;
+            }
+            target = alternative;
+            _replica_load.on_diverted(target);
+        }
+    }
+}
+
 host_id_vector_replica_set storage_proxy::get_endpoints_for_reading(const sstring& ks_name, const locator::effective_replication_map& erm, const dht::token& token, node_local_only node_local_only) const {
     auto endpoints = erm.get_replicas_for_reading(token);
     validate_read_replicas(erm, endpoints);
@@ -7011,6 +7696,10 @@ void storage_proxy::on_leave_cluster(const gms::inet_address& endpoint, const lo
     // Discarding these futures is safe. They're awaited by db::hints::manager::stop().
     (void) _hints_manager.drain_for(hid, endpoint);
     (void) _hints_for_views_manager.drain_for(hid, endpoint);
+    _replica_load.remove(hid);
+    _db.local().get_tables_metadata().for_each_table([hid] (table_id, lw_shared_ptr<replica::table> t) {
+        t->remove_replica_read_latency(hid);
+    });
 }
 
 void storage_proxy::cancel_write_handlers(noncopyable_function<bool(const abstract_write_response_handler&)> filter_fun) {
@@ -40,6 +40,9 @@
 #include "service/storage_service.hh"
 #include "service/cas_shard.hh"
 #include "service/storage_proxy_fwd.hh"
+#include "service/hedged_read_budget.hh"
+#include "service/replica_load_tracker.hh"
+#include "service/paxos/lease_map.hh"
 
 class reconcilable_result;
 class frozen_mutation_and_schema;
@@ -286,6 +289,15 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     scheduling_group_key _stats_key;
     storage_proxy_stats::global_stats _global_stats;
     gms::feature_service& _features;
+    // Load of the replicas reads are sent to, for latency-aware replica selection.
+    replica_load_tracker _replica_load;
+    // Budget of hedged reads (see read_hedging_budget), capped at this many
+    // hedges in a burst.
+    static constexpr double max_hedged_reads_burst = 100;
+    hedged_read_budget _hedged_read_budget{max_hedged_reads_burst};
+    // Leases on the next paxos round of the keys whose cas operations this
+    // shard coordinated recently (see paxos::lease).
+    paxos::lease_map _paxos_leases{10000};
 
     class remote;
     std::unique_ptr<remote> _remote;
@@ -389,6 +401,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     bool hints_enabled(db::write_type type) const noexcept;
     db::hints::manager& hints_manager_for(db::write_type type);
     void sort_endpoints_by_proximity(const locator::effective_replication_map& erm, host_id_vector_replica_set& eps) const;
+    void divert_reads_from_loaded_replicas(const locator::effective_replication_map& erm, host_id_vector_replica_set& targets,
+            const host_id_vector_replica_set& all_replicas, const host_id_vector_replica_set& preferred_endpoints, std::optional<locator::host_id>* extra);
     host_id_vector_replica_set get_endpoints_for_reading(const sstring& ks_name, const locator::effective_replication_map& erm, const dht::token& token, node_local_only node_local_only) const;
     host_id_vector_replica_set filter_replicas_for_read(db::consistency_level, const locator::effective_replication_map&, host_id_vector_replica_set live_endpoints, const host_id_vector_replica_set& preferred_endpoints, db::read_repair_decision, std::optional<locator::host_id>* extra, replica::column_family*) const;
     // As above with read_repair_decision=NONE, extra=nullptr.
@@ -669,6 +683,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
 
     future<> send_hint_to_all_replicas(frozen_mutation_and_schema fm_a_s);
 
+    // The writes to remote replicas are coalesced per replica with those of
+    // the other batches replayed at the same time.
     future<> send_batchlog_replay_to_all_replicas(utils::chunked_vector<mutation> mutations, clock_type::time_point timeout);
 
     // Send a mutation to one specific remote target.
@@ -142,6 +142,9 @@ struct stats : public write_stats {
     uint64_t read_repair_attempts = 0;
     uint64_t read_repair_repaired_blocking = 0;
     uint64_t read_repair_repaired_background = 0;
+    // foreground read repairs which read and repaired only the clustering
+    // ranges the replicas disagreed on
+    uint64_t read_repair_repaired_partially = 0;
     uint64_t global_read_repairs_canceled_due_to_concurrent_write = 0;
 
     // number of mutations received as a coordinator
@@ -170,11 +173,26 @@ struct stats : public write_stats {
     uint64_t read_retries = 0; // read is retried with new limit
     uint64_t speculative_digest_reads = 0;
     uint64_t speculative_data_reads = 0;
+    uint64_t speculative_reads_throttled = 0;
+
+    // number of writes sent to replicas in a MUTATION_BATCH message, and
+    // the number of such messages
+    uint64_t coalesced_mutations = 0;
+    uint64_t mutation_batches = 0;
 
     uint64_t cas_read_unfinished_commit = 0;
     uint64_t cas_foreground = 0;
     uint64_t cas_total_running = 0;
     uint64_t cas_total_operations = 0;
+    // paxos rounds (prepare, accept, learn, commit repair and read) waited
+    // for by cas operations
+    uint64_t cas_round_trips = 0;
+    // cas operations which proposed on a lease, and those of them whose
+    // proposal was rejected, so that they fell back to the full protocol
+    uint64_t cas_lease_hits = 0;
+    uint64_t cas_lease_misses = 0;
+    uint64_t cas_leases_granted = 0;
+    uint16_t cas_now_preparing_lease = 0;
 
     // Data read attempts
     split_stats data_read_attempts;
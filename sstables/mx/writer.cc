@@ -544,6 +544,9 @@ class writer : public sstable_writer::writer_impl {
     index_sampling_state _index_sampling_state;
     bytes_ostream _tmp_bufs;
     uint64_t _num_partitions_consumed = 0;
+    // Set when the bloom filter was provided by sstable_writer_config::prebuilt_filter
+    // and so doesn't need partition keys to be added to it.
+    bool _has_prebuilt_filter = false;
 
     const sstable_schema _sst_schema;
 
@@ -805,7 +808,12 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _sst._schema->bloom_filter_fp_chance(), utils::filter_format::m_format);
+        if (auto filter = _cfg.prebuilt_filter ? _cfg.prebuilt_filter() : utils::filter_ptr()) {
+            _sst._components->filter = std::move(filter);
+            _has_prebuilt_filter = true;
+        } else {
+            _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _sst._schema->bloom_filter_fp_chance(), utils::filter_format::m_format);
+        }
         _pi_write_m.promoted_index_block_size = cfg.promoted_index_block_size;
         _pi_write_m.promoted_index_auto_scale_threshold = cfg.promoted_index_auto_scale_threshold;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
@@ -926,7 +934,9 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     _partition_key = key::from_partition_key(_schema, dk.key());
     maybe_add_summary_entry(dk.token(), bytes_view(*_partition_key));
 
-    _sst._components->filter->add(bytes_view(*_partition_key));
+    if (!_has_prebuilt_filter) {
+        _sst._components->filter->add(bytes_view(*_partition_key));
+    }
     _collector.add_key(bytes_view(*_partition_key));
     _num_partitions_consumed++;
 
@@ -1522,7 +1532,9 @@ void writer::consume_end_of_stream() {
         _sst._schema, _sst.get_first_decorated_key(), _sst.get_last_decorated_key(), _enc_stats);
     close_data_writer();
     _sst.write_summary();
-    _sst.maybe_rebuild_filter_from_index(_num_partitions_consumed);
+    if (!_has_prebuilt_filter) {
+        _sst.maybe_rebuild_filter_from_index(_num_partitions_consumed);
+    }
     _sst.write_filter();
     _sst.write_statistics();
     _sst.write_compression();
@@ -28,6 +28,7 @@
 #include <seastar/util/file.hh>
 #include <seastar/util/closeable.hh>
 #include <seastar/util/short_streams.hh>
+#include <seastar/util/defer.hh>
 #include <iterator>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/maybe_yield.hh>
@@ -1516,6 +1517,53 @@ void sstable::maybe_rebuild_filter_from_index(uint64_t num_partitions) {
     _components->filter.swap(optimal_filter);
 }
 
+utils::filter_ptr sstable::make_merged_filter(const std::vector<shared_sstable>& sstables, const schema& s, utils::filter_format format) {
+    // merge() yields, so keep the sstables manager from freeing the filters
+    // under our feet by reclaiming their memory.
+    for (auto& sst : sstables) {
+        sst->_filter_pins++;
+    }
+    auto unpin = defer([&] () noexcept {
+        for (auto& sst : sstables) {
+            if (--sst->_filter_pins == 0) {
+                sst->_pinned_reclaimed_filters.clear();
+            }
+        }
+    });
+
+    std::vector<const utils::filter::bloom_filter*> filters;
+    filters.reserve(sstables.size());
+    for (auto& sst : sstables) {
+        // A filter might be missing, or reclaimed and replaced by an always present one.
+        auto f = dynamic_cast<const utils::filter::bloom_filter*>(sst->_components->filter.get());
+        if (!f || f->format() != format || (!filters.empty() && !f->is_mergeable_with(*filters.front()))) {
+            return nullptr;
+        }
+        filters.push_back(f);
+    }
+    if (filters.empty()) {
+        return nullptr;
+    }
+
+    auto& first = *filters.front();
+    auto merged = utils::filter::create_filter(first.num_hashes(), large_bitset(first.bits().size()), format);
+    auto& merged_bf = *downcast_ptr<utils::filter::bloom_filter>(merged.get());
+    for (auto f : filters) {
+        merged_bf.merge(*f);
+    }
+
+    // The false positive rate of a bloom filter only depends on the fraction
+    // of bits set, so it can be checked without knowing how many distinct
+    // keys the inputs have in common. Allow the same 125% margin as
+    // maybe_rebuild_filter_from_index().
+    auto fp_chance = merged_bf.estimated_false_positive_chance();
+    if (fp_chance > s.bloom_filter_fp_chance() * 1.25) {
+        sstlog.debug("Not merging bloom filters: estimated false positive chance {} exceeds configured {}", fp_chance, s.bloom_filter_fp_chance());
+        return nullptr;
+    }
+    return merged;
+}
+
 size_t sstable::total_reclaimable_memory_size() const {
     if (!_total_reclaimable_memory) {
         _total_reclaimable_memory = _components->filter ? _components->filter->memory_size() : 0;
@@ -1532,7 +1580,10 @@ size_t sstable::reclaim_memory_from_components() {
         if (filter_memory_size > 0) {
             // Discard it from memory by replacing it with an always present variant.
             // No need to remove it from _recognized_components as the filter is still in disk.
-            _components->filter = std::make_unique<utils::filter::always_present_filter>();
+            auto reclaimed = std::exchange(_components->filter, std::make_unique<utils::filter::always_present_filter>());
+            if (_filter_pins) {
+                _pinned_reclaimed_filters.push_back(std::move(reclaimed));
+            }
             memory_reclaimed_this_iteration += filter_memory_size;
         }
     }
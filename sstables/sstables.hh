@@ -114,6 +114,12 @@ struct sstable_writer_config {
     size_t summary_byte_cost;
     sstring origin;
     bool correct_pi_block_width = true;
+    // When set and returning a non-null filter, the result is used as the
+    // bloom filter of the new sstable instead of building one by hashing
+    // every written partition key. The returned filter must already contain
+    // all the keys that will be written. Called from the writer, which
+    // runs in a seastar thread, so it may block.
+    std::function<utils::filter_ptr()> prebuilt_filter;
 
 private:
     explicit sstable_writer_config() {}
@@ -616,6 +622,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     mutable std::optional<size_t> _total_reclaimable_memory{0};
     // Total memory reclaimed so far from this sstable
     size_t _total_memory_reclaimed{0};
+    // Number of make_merged_filter() calls reading the bloom filter. While
+    // non-zero, filters dropped by reclaim_memory_from_components() are kept
+    // alive in _pinned_reclaimed_filters.
+    unsigned _filter_pins = 0;
+    std::vector<utils::filter_ptr> _pinned_reclaimed_filters;
 public:
     bool has_component(component_type f) const;
     sstables_manager& manager() { return _manager; }
@@ -671,6 +682,17 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // filter initialisation was not good.
     // This should be called only before an sstable is sealed.
     void maybe_rebuild_filter_from_index(uint64_t num_partitions);
+public:
+    // Builds a bloom filter containing the keys of all the given sstables by
+    // merging their filters, without rehashing any key. Returns nullptr
+    // unless all filters are loaded, mergeable and of the given format, and
+    // the merged filter honors the schema's false positive chance. As the
+    // inputs' filters are sized for their own keys, the last condition
+    // usually holds only when the inputs share most of their keys or their
+    // filters are oversized. The filters are pinned against reclaim while
+    // they're merged. Must be called in a seastar thread.
+    static utils::filter_ptr make_merged_filter(const std::vector<shared_sstable>& sstables, const schema& s, utils::filter_format format);
+private:
 
     future<> update_info_for_opened_data(sstable_open_config cfg = {});
 
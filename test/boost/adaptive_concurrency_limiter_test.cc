@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils/adaptive_concurrency_limiter.hh"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Keeps the limiter saturated: completes `count` requests with the given
+// latency, admitting new requests up to the limit after each.
+void run_saturated(utils::adaptive_concurrency_limiter& limiter, std::chrono::nanoseconds latency, size_t count) {
+    while (limiter.try_acquire()) { }
+    for (size_t i = 0; i < count; ++i) {
+        limiter.release(latency);
+        while (limiter.try_acquire()) { }
+    }
+}
+
+void release_all(utils::adaptive_concurrency_limiter& limiter, std::chrono::nanoseconds latency) {
+    while (limiter.inflight()) {
+        limiter.release(latency);
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_admission_up_to_limit) {
+    utils::adaptive_concurrency_limiter limiter({.min_limit = 1, .max_limit = 1000, .initial_limit = 10});
+    for (int i = 0; i < 10; ++i) {
+        BOOST_REQUIRE(limiter.try_acquire());
+    }
+    BOOST_REQUIRE(!limiter.try_acquire());
+    BOOST_REQUIRE_EQUAL(limiter.inflight(), 10);
+
+    {
+        limiter.release(1ms);
+        auto permit = limiter.try_get_permit();
+        BOOST_REQUIRE(permit);
+        BOOST_REQUIRE(!limiter.try_get_permit());
+    }
+    BOOST_REQUIRE_EQUAL(limiter.inflight(), 9);
+}
+
+BOOST_AUTO_TEST_CASE(test_limit_grows_while_latency_is_stable) {
+    utils::adaptive_concurrency_limiter limiter({.min_limit = 1, .max_limit = 1000, .initial_limit = 10});
+    run_saturated(limiter, 1ms, 10000);
+    BOOST_REQUIRE_EQUAL(limiter.limit(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_limit_shrinks_when_latency_grows) {
+    utils::adaptive_concurrency_limiter limiter({.min_limit = 5, .max_limit = 1000, .initial_limit = 500});
+    run_saturated(limiter, 1ms, 1000);
+    auto limit = limiter.limit();
+
+    // Latency ten times the baseline, as when requests queue up behind an
+    // overloaded resource.
+    run_saturated(limiter, 10ms, 100);
+    BOOST_REQUIRE_LT(limiter.limit(), limit / 2);
+
+    // The limit recovers once the latency goes back to normal.
+    run_saturated(limiter, 1ms, 10000);
+    BOOST_REQUIRE_EQUAL(limiter.limit(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_limit_does_not_grow_when_unused) {
+    utils::adaptive_concurrency_limiter limiter({.min_limit = 1, .max_limit = 1000, .initial_limit = 10});
+    for (int i = 0; i < 1000; ++i) {
+        BOOST_REQUIRE(limiter.try_acquire());
+        limiter.release(1ms);
+    }
+    BOOST_REQUIRE_EQUAL(limiter.limit(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_bounds) {
+    utils::adaptive_concurrency_limiter limiter({.min_limit = 1, .max_limit = 1000, .initial_limit = 100});
+    limiter.set_bounds(5, 50);
+    BOOST_REQUIRE_EQUAL(limiter.limit(), 50);
+
+    run_saturated(limiter, 1ms, 100);
+    run_saturated(limiter, 100ms, 100);
+    BOOST_REQUIRE_EQUAL(limiter.limit(), 5);
+    release_all(limiter, 100ms);
+
+    limiter.set_bounds(20, 50);
+    BOOST_REQUIRE_EQUAL(limiter.limit(), 20);
+}
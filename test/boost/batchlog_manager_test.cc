@@ -22,6 +22,7 @@
 #include "db/commitlog/commitlog.hh"
 #include "message/messaging_service.hh"
 #include "service/storage_proxy.hh"
+#include "utils/UUID_gen.hh"
 
 BOOST_AUTO_TEST_SUITE(batchlog_manager_test)
 
@@ -67,4 +68,36 @@ SEASTAR_TEST_CASE(test_execute_batch) {
     });
 }
 
+SEASTAR_TEST_CASE(test_replay_backlog) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        using namespace std::chrono_literals;
+        auto& qp = e.local_qp();
+        auto& bp = e.batchlog_manager().local();
+
+        e.execute_cql("create table cf (p1 varchar, c1 int, r1 int, PRIMARY KEY (p1, c1));").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+        const column_definition& r1_col = *s->get_column_definition("r1");
+
+        // A backlog of batches, left behind by coordinators which failed
+        // before removing them, spanning several pages of the batchlog.
+        const int batches = 1000;
+        auto version = netw::messaging_service::current_version;
+        for (int i = 0; i < batches; ++i) {
+            auto key = partition_key::from_exploded(*s, {to_bytes(format("key{}", i % 10))});
+            auto c_key = clustering_key::from_exploded(*s, {int32_type->decompose(i)});
+            mutation m(s, key);
+            m.set_clustered_cell(c_key, r1_col, make_atomic_cell(int32_type, int32_type->decompose(i)));
+            auto bm = qp.proxy().get_batchlog_mutation_for({ m }, utils::UUID_gen::get_time_UUID(), version, db_clock::now() - db_clock::duration(3h));
+            qp.proxy().mutate_locally(bm, tracing::trace_state_ptr(), db::commitlog::force_sync::no).get();
+        }
+        BOOST_REQUIRE_EQUAL(bp.count_all_batches().get(), batches);
+
+        bp.do_batch_log_replay(db::batchlog_manager::post_replay_cleanup::yes).get();
+
+        BOOST_REQUIRE_EQUAL(bp.count_all_batches().get(), 0);
+        auto rs = qp.execute_internal("select count(*) from ks.cf;", cql3::query_processor::cache_internal::no).get();
+        BOOST_REQUIRE_EQUAL(rs->one().get_as<int64_t>("count"), batches);
+    });
+}
+
 BOOST_AUTO_TEST_SUITE_END()
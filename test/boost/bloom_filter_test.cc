@@ -405,3 +405,57 @@ SEASTAR_TEST_CASE(test_components_memory_reclaim_threshold_liveupdateness) {
         .available_memory = 1000
     });
 }
+
+SEASTAR_TEST_CASE(test_merged_bloom_filter) {
+    return test_env::do_with_async([](test_env& env) {
+        simple_schema ss;
+        auto schema = ss.schema();
+        const auto partition_count = 100;
+
+        auto make_mutations = [&] (const std::vector<dht::decorated_key>& pks, api::timestamp_type ts) {
+            utils::chunked_vector<mutation> mutations;
+            for (auto& pk : pks) {
+                auto mut = mutation(schema, pk);
+                mut.partition().apply_insert(*schema, ss.make_ckey(1), ts);
+                mutations.push_back(std::move(mut));
+            }
+            return mutations;
+        };
+        auto make_sst = [&] (utils::chunked_vector<mutation> mutations) {
+            return make_sstable_easy(env, make_mutation_reader_from_mutations(schema, env.make_reader_permit(), std::move(mutations)),
+                                     env.manager().configure_writer(), sstables::get_highest_sstable_version(), partition_count);
+        };
+
+        auto pks = ss.make_pkeys(partition_count * 2);
+        auto first_half = pks | std::views::take(partition_count) | std::ranges::to<std::vector<dht::decorated_key>>();
+        auto second_half = pks | std::views::drop(partition_count) | std::ranges::to<std::vector<dht::decorated_key>>();
+
+        auto sst1 = make_sst(make_mutations(first_half, ss.new_timestamp()));
+        auto sst2 = make_sst(make_mutations(first_half, ss.new_timestamp()));
+        auto sst3 = make_sst(make_mutations(second_half, ss.new_timestamp()));
+        const auto format = utils::filter_format::m_format;
+
+        // A single filter merges into an identical one.
+        auto merged = sstables::sstable::make_merged_filter({sst1}, *schema, format);
+        BOOST_REQUIRE(merged);
+        bloom_filters_require_equal(merged, sstables::test(sst1).get_filter());
+
+        // Filters of sstables with the same keys merge into one with the same false positive chance.
+        merged = sstables::sstable::make_merged_filter({sst1, sst2}, *schema, format);
+        BOOST_REQUIRE(merged);
+        bloom_filters_require_equal(merged, sstables::test(sst1).get_filter());
+        for (auto& pk : first_half) {
+            BOOST_REQUIRE(merged->is_present(key::from_partition_key(*schema, pk.key()).get_bytes()));
+        }
+
+        // Disjoint key sets of the size each filter was built for would overload the merged filter.
+        BOOST_REQUIRE(!sstables::sstable::make_merged_filter({sst1, sst3}, *schema, format));
+
+        // Filters with a different format can't be merged.
+        BOOST_REQUIRE(!sstables::sstable::make_merged_filter({sst1}, *schema, utils::filter_format::k_l_format));
+
+        // Reclaimed filters can't be merged.
+        sstables::test(sst2).reclaim_memory_from_components();
+        BOOST_REQUIRE(!sstables::sstable::make_merged_filter({sst1, sst2}, *schema, format));
+    });
+}
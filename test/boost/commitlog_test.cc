@@ -38,6 +38,7 @@
 #include "db/commitlog/rp_set.hh"
 #include "db/extensions.hh"
 #include "readers/combined.hh"
+#include "schema/schema_builder.hh"
 #include "utils/log.hh"
 #include "test/lib/exception_utils.hh"
 #include "test/lib/cql_test_env.hh"
@@ -1041,6 +1042,43 @@ SEASTAR_TEST_CASE(test_commitlog_add_entry) {
     });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_add_compressed_entry) {
+    return cl_test([](commitlog& log) {
+        return seastar::async([&] {
+            auto s = schema_builder("ks", "cf")
+                    .with_column("pk", bytes_type, column_kind::partition_key)
+                    .with_column("v", bytes_type)
+                    .build();
+            mutation m(s, partition_key::from_single_value(*s, to_bytes("key")));
+            m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(bytes(10000, int8_t('a'))), api::new_timestamp());
+            auto fm = freeze(m);
+
+            commitlog_entry_writer w(s, fm, commitlog_entry_writer::force_sync::no);
+            w.set_compressed(true);
+            w.set_with_schema(true);
+            BOOST_REQUIRE_LT(w.size(), w.mutation_size());
+
+            auto h = log.add_entry(s->id(), w, db::timeout_clock::now() + 60s).get();
+            auto rp = h.rp();
+            log.sync_all_segments().get();
+
+            bool found = false;
+            for (auto& seg : log.get_active_segment_names()) {
+                db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, [&](db::commitlog::buffer_and_replay_position buf_rp) {
+                    if (buf_rp.position == rp) {
+                        commitlog_entry_reader r(buf_rp.buffer);
+                        BOOST_REQUIRE(r.get_column_mapping());
+                        BOOST_CHECK_EQUAL(r.mutation().unfreeze(s), m);
+                        found = true;
+                    }
+                    return make_ready_future<>();
+                }).get();
+            }
+            BOOST_REQUIRE(found);
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_commitlog_add_entries) {
     return cl_test([](commitlog& log) {
         return seastar::async([&] {
@@ -2418,6 +2418,35 @@ SEASTAR_TEST_CASE(test_order_by) {
                 {int32_type->decompose(1), int32_type->decompose(1), int32_type->decompose(4)},
             });
         }
+
+        // The limit applies to the rows in the requested order, not to the
+        // first rows of the partitions which match the filter.
+        {
+            auto msg = e.execute_cql("select c1, c2, r1 from torder where p1 in (0, 1) and r1 > 0 order by c1 desc, c2 desc limit 2 allow filtering;").get();
+            assert_that(msg).is_rows().with_rows({
+                {int32_type->decompose(2), int32_type->decompose(3), int32_type->decompose(7)},
+                {int32_type->decompose(2), int32_type->decompose(2), int32_type->decompose(5)},
+            });
+        }
+
+        {
+            auto msg = e.execute_cql("select c1, c2, r1 from torder where p1 in (0, 1) and r1 > 0 order by c1 asc, c2 asc limit 2 allow filtering;").get();
+            assert_that(msg).is_rows().with_rows({
+                {int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(6)},
+                {int32_type->decompose(1), int32_type->decompose(1), int32_type->decompose(4)},
+            });
+        }
+
+        {
+            auto msg = e.execute_cql("select c1, c2, r1 from torder where p1 in (0, 1) and r1 > 0 order by c1 desc, c2 desc allow filtering;").get();
+            assert_that(msg).is_rows().with_rows({
+                {int32_type->decompose(2), int32_type->decompose(3), int32_type->decompose(7)},
+                {int32_type->decompose(2), int32_type->decompose(2), int32_type->decompose(5)},
+                {int32_type->decompose(1), int32_type->decompose(2), int32_type->decompose(3)},
+                {int32_type->decompose(1), int32_type->decompose(1), int32_type->decompose(4)},
+                {int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(6)},
+            });
+        }
     });
 }
 
@@ -5076,6 +5105,47 @@ SEASTAR_TEST_CASE(test_counter_column_added_into_non_counter_table) {
     });
 }
 
+// Counter updates of cells whose local shards are cached skip the
+// read-before-write, and must yield the same values as those which don't.
+SEASTAR_TEST_CASE(test_counter_cache) {
+    auto db_cfg = make_shared<db::config>();
+    db_cfg->counter_cache_size_in_mb(1);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto hits = [&e] {
+            return e.db().map_reduce0([] (replica::database& db) {
+                return db.get_counter_cache_tracker().get_stats().hits;
+            }, uint64_t(0), std::plus<uint64_t>()).get();
+        };
+        auto assert_value = [&e] (int64_t expected) {
+            assert_that(e.execute_cql("SELECT c FROM t WHERE pk = 0 AND ck = 0").get())
+                .is_rows().with_rows({{long_type->decompose(expected)}});
+        };
+
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, c counter, PRIMARY KEY (pk, ck))");
+        cquery_nofail(e, "UPDATE t SET c = c + 1 WHERE pk = 0 AND ck = 0");
+        auto hits_before = hits();
+        for (int i = 0; i < 10; ++i) {
+            cquery_nofail(e, "UPDATE t SET c = c + 2 WHERE pk = 0 AND ck = 0");
+        }
+        BOOST_REQUIRE_EQUAL(hits(), hits_before + 10);
+        assert_value(21);
+
+        // The data the cache was based on is gone.
+        cquery_nofail(e, "TRUNCATE t");
+        hits_before = hits();
+        cquery_nofail(e, "UPDATE t SET c = c + 5 WHERE pk = 0 AND ck = 0");
+        BOOST_REQUIRE_EQUAL(hits(), hits_before);
+        assert_value(5);
+
+        // Flushing doesn't change the state of the counters.
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.flush("ks", "t");
+        }).get();
+        cquery_nofail(e, "UPDATE t SET c = c - 1 WHERE pk = 0 AND ck = 0");
+        assert_value(4);
+    }, db_cfg);
+}
+
 SEASTAR_THREAD_TEST_CASE(test_invalid_using_timestamps) {
     do_with_cql_env_thread([] (cql_test_env& e) {
         auto now_nano = std::chrono::duration_cast<std::chrono::nanoseconds>(db_clock::now().time_since_epoch()).count();
@@ -5420,7 +5490,106 @@ SEASTAR_TEST_CASE(test_parallelized_select_sum_group_by) {
             {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t((value_count - 1) * value_count / 2))}
         });
 
-        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_group_by_fallback) {
+    auto db_cfg_ptr = make_shared<db::config>();
+    db_cfg_ptr->enable_parallelized_aggregation({true}, db::config::config_source::CommandLine);
+    db_cfg_ptr->parallelized_aggregation_max_groups({3}, db::config::config_source::CommandLine);
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+        auto stat_fallbacks = qp.get_cql_stats().select_parallelized_fallbacks;
+
+        e.execute_cql("CREATE TABLE tbl (k int, c1 int, c2 int, v int, PRIMARY KEY (k, c1, c2));").get();
+        for (int k = 0; k < 2; k++) {
+            for (int c1 = 0; c1 < 2; c1++) {
+                for (int c2 = 0; c2 < 3; c2++) {
+                    e.execute_cql(format("INSERT INTO tbl (k, c1, c2, v) VALUES ({:d}, {:d}, {:d}, {:d});", k, c1, c2, c2)).get();
+                }
+            }
+        }
+
+        // 2 groups, within the limit.
+        auto msg = e.execute_cql("SELECT COUNT(*), MAX(v) FROM tbl GROUP BY k;").get();
+        assert_that(msg).is_rows().with_rows({
+            {long_type->decompose(int64_t(6)), int32_type->decompose(int32_t(2))},
+            {long_type->decompose(int64_t(6)), int32_type->decompose(int32_t(2))}
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_fallbacks, qp.get_cql_stats().select_parallelized_fallbacks);
+
+        // 4 groups, above the limit, so the query is executed again without mapreduce_service.
+        msg = e.execute_cql("SELECT k, c1, SUM(v) FROM tbl GROUP BY k, c1;").get();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(int32_t(1)), int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t(3))},
+            {int32_type->decompose(int32_t(1)), int32_type->decompose(int32_t(1)), int32_type->decompose(int32_t(3))},
+            {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t(3))},
+            {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t(1)), int32_type->decompose(int32_t(3))}
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 2, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_fallbacks + 1, qp.get_cql_stats().select_parallelized_fallbacks);
+
+        // Selecting a column which isn't grouped can't be parallelized.
+        msg = e.execute_cql("SELECT k, c2, SUM(v) FROM tbl GROUP BY k;").get();
+        assert_that(msg).is_rows().with_size(2);
+        BOOST_CHECK_EQUAL(stat_parallelized + 2, qp.get_cql_stats().select_parallelized);
+
+        // 2 groups don't fit in a page of 1 row, so paging is left to the regular path.
+        auto qo = std::make_unique<cql3::query_options>(db::consistency_level::ONE,
+                std::vector<cql3::raw_value>{},
+                cql3::query_options::specific_options{1, nullptr, {}, api::new_timestamp()});
+        msg = e.execute_cql("SELECT COUNT(*), MAX(v) FROM tbl GROUP BY k;", std::move(qo)).get();
+        assert_that(msg).is_rows().with_size(2);
+        BOOST_CHECK_EQUAL(stat_parallelized + 3, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_fallbacks + 2, qp.get_cql_stats().select_parallelized_fallbacks);
+    }, db_cfg_ptr);
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_with_filtering) {
+    return with_parallelized_aggregation_enabled_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+
+        e.execute_cql("CREATE TABLE tbl (k int, c int, v int, PRIMARY KEY (k, c));").get();
+        int value_count = 10;
+        for (int k = 0; k < 2; k++) {
+            for (int c = 0; c < value_count; c++) {
+                e.execute_cql(format("INSERT INTO tbl (k, c, v) VALUES ({:d}, {:d}, {:d});", k, c, c)).get();
+            }
+        }
+
+        auto msg = e.execute_cql("SELECT COUNT(v) FROM tbl WHERE v > 5 ALLOW FILTERING;").get();
+        assert_that(msg).is_rows().with_rows({
+            {long_type->decompose(int64_t(8))}
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+
+        // The filtered column is also aggregated.
+        msg = e.execute_cql("SELECT SUM(v), MIN(v) FROM tbl WHERE c < 3 AND v >= 1 ALLOW FILTERING;").get();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(int32_t(6)), int32_type->decompose(int32_t(1))}
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 2, qp.get_cql_stats().select_parallelized);
+
+        // Bind variables are evaluated by the coordinator.
+        auto id = e.prepare("SELECT k, COUNT(v) FROM tbl WHERE v < ? GROUP BY k ALLOW FILTERING;").get();
+        msg = e.execute_prepared(id, {cql3::raw_value::make_value(int32_type->decompose(int32_t(2)))}).get();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(int32_t(1)), long_type->decompose(int64_t(2))},
+            {int32_type->decompose(int32_t(0)), long_type->decompose(int64_t(2))}
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 3, qp.get_cql_stats().select_parallelized);
+
+        // The filtered column isn't selected. It's retrieved by the regular path
+        // for filtering only, and isn't sent to the client.
+        msg = e.execute_cql("SELECT COUNT(*) FROM tbl WHERE v > 5 ALLOW FILTERING;").get();
+        assert_that(msg).is_rows().with_rows({
+            {long_type->decompose(int64_t(8)), std::nullopt}
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 4, qp.get_cql_stats().select_parallelized);
     });
 }
 
@@ -5508,15 +5677,16 @@ SEASTAR_TEST_CASE(test_single_partition_aggregation_is_not_parallelized) {
         });
         BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
 
-        // Query with only partly restricted partition key requires `ALLOW FILTERING` clause
-        // and we doesn't parallelize queries which need filtering.
-        // See issue #19369.
+        // Query with only partly restricted partition key requires `ALLOW FILTERING` clause.
+        // It reads many partitions, so it's parallelized, with the filtering done by
+        // the shards computing the partial aggregates. See issue #19369.
         const auto result_pk1 = e.execute_cql("SELECT COUNT(*) FROM tbl2 WHERE pk1 = 1 ALLOW FILTERING;").get();
-        // This query contains also column for pk1
+        // This query contains also column for pk1, which isn't sent to the client
+        // and isn't computed by a parallelized query
         assert_that(result_pk1).is_rows().with_rows({
-            {long_type->decompose(int64_t(value_count * 2)), int32_type->decompose(int32_t(1))}
+            {long_type->decompose(int64_t(value_count * 2)), std::nullopt}
         });
-        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
     });
 }
 
@@ -6066,4 +6236,49 @@ SEASTAR_TEST_CASE(test_schema_change_events) {
      });
 }
 
+
+// Selections which repeat or reorder columns of the table are written out
+// straight from the query results, like trivial ones.
+SEASTAR_TEST_CASE(test_select_repeated_columns) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, s int static, v int, PRIMARY KEY (pk, ck))");
+        cquery_nofail(e, "INSERT INTO t (pk, ck, s, v) VALUES (0, 0, 10, 100)");
+        cquery_nofail(e, "INSERT INTO t (pk, ck, v) VALUES (0, 1, 101)");
+        cquery_nofail(e, "INSERT INTO t (pk, s) VALUES (1, 11)");
+
+        auto i = [] (int32_t v) { return int32_type->decompose(v); };
+
+        assert_that(e.execute_cql("SELECT v, pk, v, s FROM t WHERE pk = 0").get())
+            .is_rows().with_rows({
+                {i(100), i(0), i(100), i(10)},
+                {i(101), i(0), i(101), i(10)},
+            });
+
+        // A partition with only a static row.
+        assert_that(e.execute_cql("SELECT s, pk, v, s FROM t WHERE pk = 1").get())
+            .is_rows().with_rows({
+                {i(11), i(1), std::nullopt, i(11)},
+            });
+
+        // Paged.
+        std::vector<std::vector<bytes_opt>> rows;
+        lw_shared_ptr<service::pager::paging_state> paging_state;
+        do {
+            auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                    cql3::query_options::specific_options{1, paging_state, {}, api::new_timestamp()});
+            auto msg = e.execute_cql("SELECT ck, ck, v FROM t WHERE pk = 0", std::move(qo)).get();
+            auto rs = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+            BOOST_REQUIRE(rs);
+            for (auto& row : rs->rs().result_set().rows()) {
+                rows.push_back(row | std::views::transform([] (const managed_bytes_opt& c) { return to_bytes_opt(c); }) | std::ranges::to<std::vector>());
+            }
+            paging_state = extract_paging_state(msg);
+        } while (paging_state);
+        BOOST_REQUIRE(rows == (std::vector<std::vector<bytes_opt>>{
+            {i(0), i(0), i(100)},
+            {i(1), i(1), i(101)},
+        }));
+    });
+}
+
 BOOST_AUTO_TEST_SUITE_END()
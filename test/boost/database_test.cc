@@ -1216,6 +1216,43 @@ SEASTAR_THREAD_TEST_CASE(max_result_size_for_query_selection_test) {
     }, std::move(cfg)).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_partition_write_coalescing) {
+    cql_test_config cfg;
+    cfg.db_config->enable_partition_write_coalescing(true, utils::config_file::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (pk int, ck int, v int, primary key (pk, ck));").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+        const auto pk = partition_key::from_single_value(*s, int32_type->decompose(int32_t(0)));
+        const auto shard = e.local_db().find_column_family(s).shard_for_reads(dht::get_token(*s, pk));
+
+        e.db().invoke_on(shard, [&pk] (replica::database& db) -> future<> {
+            auto& t = db.find_column_family("ks", "cf");
+            auto s = t.schema();
+            const auto key = partition_key(pk);
+
+            std::vector<frozen_mutation> muts;
+            for (int32_t ck = 0; ck < 100; ++ck) {
+                mutation m(s, key);
+                m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), "v", ck, api::new_timestamp());
+                muts.push_back(freeze(m));
+            }
+
+            // All writes are issued within the same task quota, so they are applied to the memtable at once.
+            co_await parallel_for_each(muts, [&t, s] (const frozen_mutation& fm) {
+                return t.apply(fm, s, db::rp_handle(), db::no_timeout);
+            });
+            BOOST_REQUIRE_EQUAL(t.get_stats().memtable_coalesced_writes, 99);
+
+            auto cmd = query::read_command(s->id(), s->version(), partition_slice_builder(*s).build(),
+                    query::max_result_size(std::numeric_limits<size_t>::max()), query::tombstone_limit::max, query::row_limit(1000));
+            auto pr = dht::partition_range::make_singular(dht::decorate_key(*s, key));
+            auto&& [result, temperature] = co_await db.query(s, cmd, query::result_options::only_result(), {pr}, nullptr, db::no_timeout);
+            assert_that(query::result_set::from_raw_result(s, cmd.slice, *result)).has_size(100);
+        }).get();
+    }, std::move(cfg)).get();
+}
+
 // Check that during a multi-page range scan:
 // * semaphore mismatch is detected
 // * code is exception safe w.r.t. to the mismatch exception, e.g. readers are closed properly
@@ -1908,4 +1945,41 @@ SEASTAR_TEST_CASE(test_max_purgeable_can_purge) {
     return make_ready_future<>();
 }
 
+SEASTAR_TEST_CASE(test_replica_read_latency_percentile) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.cf (p int PRIMARY KEY)").get();
+        auto& t = e.local_db().find_column_family("ks", "cf");
+        auto fast = locator::host_id::create_random_id();
+        auto slow = locator::host_id::create_random_id();
+
+        // Too few reads were sent to the replica to tell its latency.
+        BOOST_REQUIRE(!t.get_replica_read_latency_percentile(fast, 0.99));
+        for (int i = 0; i < 10; ++i) {
+            t.add_replica_read_latency(fast, 1ms);
+        }
+        BOOST_REQUIRE(!t.get_replica_read_latency_percentile(fast, 0.99));
+
+        for (int i = 0; i < 90; ++i) {
+            t.add_replica_read_latency(fast, 1ms);
+        }
+        for (int i = 0; i < 100; ++i) {
+            t.add_replica_read_latency(slow, 50ms);
+        }
+        auto fast_latency = t.get_replica_read_latency_percentile(fast, 0.99);
+        auto slow_latency = t.get_replica_read_latency_percentile(slow, 0.99);
+        BOOST_REQUIRE(fast_latency && slow_latency);
+        // The histogram buckets are approximate, but each replica gets a
+        // percentile close to its own latency.
+        BOOST_REQUIRE_GE(fast_latency->count(), 1000);
+        BOOST_REQUIRE_LT(fast_latency->count(), 1500);
+        BOOST_REQUIRE_GE(slow_latency->count(), 50000);
+        BOOST_REQUIRE_LT(slow_latency->count(), 75000);
+
+        // A replica which left the cluster is forgotten.
+        t.remove_replica_read_latency(slow);
+        BOOST_REQUIRE(!t.get_replica_read_latency_percentile(slow, 0.99));
+        BOOST_REQUIRE(t.get_replica_read_latency_percentile(fast, 0.99));
+    });
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
 #include "types/user.hh"
 #include "test/lib/expr_test_utils.hh"
 #include "test/lib/test_utils.hh"
+#include "cql3/expr/compiled_filter.hh"
 #include "cql3/expr/evaluate.hh"
 #include "cql3/expr/expr-utils.hh"
 
@@ -4818,3 +4819,64 @@ BOOST_AUTO_TEST_CASE(test_levellize_aggregation_depth) {
     // Somewhat fragile, but easiest way to test entire structure
     BOOST_REQUIRE_EQUAL(fmt::format("{:debug}", e2), "foo.my_agg(system.sum(system.$$first$$(r)), system.$$first$$(system.$$first$$(TTL(r))))");
 }
+
+// compiled_filter must agree with is_satisfied_by() on every row, whether
+// evaluated row by row or in a batch.
+BOOST_AUTO_TEST_CASE(compiled_filter_matches_evaluation) {
+    schema_ptr table_schema = schema_builder("test_ks", "test_cf")
+                                  .with_column("pk", int32_type, column_kind::partition_key)
+                                  .with_column("ck", int32_type, column_kind::clustering_key)
+                                  .with_column("r", int32_type, column_kind::regular_column)
+                                  .with_column("s", utf8_type, column_kind::regular_column)
+                                  .build();
+    auto col = [&] (const char* name) -> expression {
+        return column_value(table_schema->get_column_definition(name));
+    };
+    struct test_filter {
+        expression filter;
+        size_t compiled_terms;
+    };
+    const std::vector<test_filter> filters = {
+        {conjunction{{binary_operator(col("ck"), oper_t::GTE, make_int_const(1)),
+                      binary_operator(col("r"), oper_t::IN, make_int_list_const({1, 3, std::nullopt}))}}, 2},
+        {binary_operator(col("r"), oper_t::NOT_IN, make_int_list_const({1, 5})), 1},
+        {binary_operator(col("r"), oper_t::NOT_IN, make_int_list_const({1, std::nullopt})), 1},
+        {conjunction{{binary_operator(col("s"), oper_t::LIKE, make_text_const("a%")),
+                      binary_operator(col("r"), oper_t::LT, new_bind_variable(0))}}, 2},
+        {conjunction{{binary_operator(col("r"), oper_t::EQ, col("pk")),
+                      binary_operator(col("ck"), oper_t::NEQ, make_int_const(2))}}, 1},
+        {binary_operator(col("r"), oper_t::GT, constant::make_null(int32_type)), 1},
+    };
+    const std::vector<raw_value> r_values = {raw_value::make_null(), make_int_raw(1), make_int_raw(3), make_int_raw(5)};
+    const std::vector<raw_value> s_values = {raw_value::make_null(), make_text_raw("abc"), make_text_raw("bcd")};
+
+    std::vector<evaluation_inputs> rows;
+    std::vector<std::unique_ptr<evaluation_inputs_data>> rows_data;
+    for (int32_t ck = 0; ck < 3; ck++) {
+        for (const auto& r : r_values) {
+            for (const auto& s : s_values) {
+                auto [inputs, inputs_data] = make_evaluation_inputs(table_schema, {
+                    {"pk", make_int_raw(3)},
+                    {"ck", make_int_raw(ck)},
+                    {"r", r},
+                    {"s", s},
+                }, {make_int_raw(5)});
+                rows.push_back(inputs);
+                rows_data.push_back(std::move(inputs_data));
+            }
+        }
+    }
+
+    for (const auto& [filter, compiled_terms] : filters) {
+        compiled_filter compiled(filter);
+        BOOST_REQUIRE_EQUAL(compiled.compiled_terms(), compiled_terms);
+        auto bound = compiled.bind(*rows.front().selection, *rows.front().options);
+        boost::dynamic_bitset<> selected(rows.size());
+        selected.set();
+        bound.filter_batch(rows, selected);
+        for (size_t i = 0; i < rows.size(); i++) {
+            BOOST_REQUIRE_EQUAL(bound.is_satisfied_by(rows[i]), is_satisfied_by(filter, rows[i]));
+            BOOST_REQUIRE_EQUAL(selected.test(i), is_satisfied_by(filter, rows[i]));
+        }
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include "service/hedged_read_budget.hh"
+
+SEASTAR_THREAD_TEST_CASE(test_hedges_are_limited_by_budget) {
+    service::hedged_read_budget budget(100);
+
+    // Nothing was earned yet.
+    BOOST_REQUIRE(!budget.try_spend());
+
+    // With a budget of 0.1 per read, one in ten reads may be hedged.
+    int hedges = 0;
+    for (int i = 0; i < 1000; ++i) {
+        budget.earn(0.1);
+        hedges += budget.try_spend();
+    }
+    BOOST_REQUIRE_GE(hedges, 99);
+    BOOST_REQUIRE_LE(hedges, 100);
+    BOOST_REQUIRE(!budget.try_spend());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hedges_burst_is_capped) {
+    service::hedged_read_budget budget(10);
+
+    // Many reads which didn't need hedging don't allow an unbounded burst
+    // of hedges later.
+    for (int i = 0; i < 1000; ++i) {
+        budget.earn(0.5);
+    }
+    int hedges = 0;
+    while (budget.try_spend()) {
+        ++hedges;
+    }
+    BOOST_REQUIRE_EQUAL(hedges, 10);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include "service/replica_load_tracker.hh"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+void complete_request(service::replica_load_tracker& tracker, locator::host_id ep, std::chrono::microseconds latency) {
+    tracker.on_request_sent(ep);
+    tracker.on_request_done(ep, latency);
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_prefer_less_loaded_replica) {
+    service::replica_load_tracker tracker;
+    auto a = locator::host_id::create_random_id();
+    auto b = locator::host_id::create_random_id();
+
+    // Nothing is known about the chosen replica, so it stays.
+    BOOST_REQUIRE(!tracker.prefer_alternative(a, b));
+
+    complete_request(tracker, a, 1000us);
+    complete_request(tracker, b, 1000us);
+    BOOST_REQUIRE(!tracker.prefer_alternative(a, b));
+    BOOST_REQUIRE(!tracker.prefer_alternative(b, a));
+
+    // A slightly slower replica is not diverted from.
+    for (int i = 0; i < 100; ++i) {
+        complete_request(tracker, a, 1500us);
+    }
+    BOOST_REQUIRE(!tracker.prefer_alternative(a, b));
+
+    // A replica which became much slower is.
+    for (int i = 0; i < 100; ++i) {
+        complete_request(tracker, a, 10ms);
+    }
+    BOOST_REQUIRE(tracker.prefer_alternative(a, b));
+    BOOST_REQUIRE(!tracker.prefer_alternative(b, a));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_prefer_replica_with_fewer_outstanding_reads) {
+    service::replica_load_tracker tracker;
+    auto a = locator::host_id::create_random_id();
+    auto b = locator::host_id::create_random_id();
+
+    complete_request(tracker, a, 1000us);
+    complete_request(tracker, b, 1000us);
+    for (int i = 0; i < 5; ++i) {
+        tracker.on_request_sent(a);
+    }
+    BOOST_REQUIRE(tracker.prefer_alternative(a, b));
+    BOOST_REQUIRE(!tracker.prefer_alternative(b, a));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_probe_unknown_replica) {
+    service::replica_load_tracker tracker;
+    auto a = locator::host_id::create_random_id();
+    auto b = locator::host_id::create_random_id();
+
+    complete_request(tracker, a, 1000us);
+    // Nothing is known about b, so it's worth trying once...
+    BOOST_REQUIRE(tracker.prefer_alternative(a, b));
+    tracker.on_request_sent(b);
+    // ...but not flooded with reads until it responds.
+    for (int i = 0; i < 10; ++i) {
+        complete_request(tracker, a, 1000us);
+    }
+    BOOST_REQUIRE(!tracker.prefer_alternative(a, b));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_remove_replica) {
+    service::replica_load_tracker tracker;
+    auto a = locator::host_id::create_random_id();
+    auto b = locator::host_id::create_random_id();
+
+    complete_request(tracker, a, 1000us);
+    for (int i = 0; i < 10; ++i) {
+        complete_request(tracker, b, 10ms);
+    }
+    BOOST_REQUIRE(tracker.prefer_alternative(b, a));
+
+    // A removed replica is forgotten, so it's unknown when it comes back.
+    tracker.on_request_sent(b);
+    tracker.remove(b);
+    // A response which was in flight when it was removed is ignored.
+    tracker.on_request_done(b, 10ms);
+    BOOST_REQUIRE(!tracker.prefer_alternative(b, a));
+}
@@ -2090,6 +2090,72 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     });
 }
 
+SEASTAR_TEST_CASE(tombstone_gc_compaction_considers_overlapping_sstables) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "tombstone_gc_overlap")
+                .with_column("p1", utf8_type, column_kind::partition_key)
+                .with_column("c1", utf8_type, column_kind::clustering_key)
+                .with_column("r1", utf8_type)
+                .set_gc_grace_seconds(0)
+                .set_compaction_strategy(sstables::compaction_strategy_type::size_tiered)
+                .build();
+        auto sst_gen = env.make_sst_factory(s);
+        const column_definition& r1_col = *s->get_column_definition("r1");
+        auto c_key = clustering_key::from_exploded(*s, {to_bytes("c1")});
+        constexpr int keys = 100;
+        constexpr api::timestamp_type tombstone_timestamp = 1000;
+
+        auto make_sst = [&] (std::function<atomic_cell(int)> make_cell) {
+            utils::chunked_vector<mutation> muts;
+            for (auto i = 0; i < keys; i++) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+                m.set_clustered_cell(c_key, r1_col, make_cell(i));
+                muts.push_back(std::move(m));
+            }
+            return make_sstable_containing(sst_gen, std::move(muts));
+        };
+
+        // Expired tombstones, spread over [tombstone_timestamp, tombstone_timestamp + keys).
+        auto deletion_time = gc_clock::now() - std::chrono::hours(1);
+        auto deleted = make_sst([&] (int i) { return atomic_cell::make_dead(tombstone_timestamp + i, deletion_time); });
+        sstables::test(deleted).set_data_file_write_time(db_clock::time_point::min());
+        auto make_live_sst = [&] (api::timestamp_type ts) {
+            return make_sst([&] (int) { return atomic_cell::make_live(*utf8_type, ts, utf8_type->decompose("v")); });
+        };
+
+        std::map<sstring, sstring> options;
+        options.emplace("tombstone_threshold", "0.3");
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, options);
+
+        auto get_tombstone_gc_job = [&] (shared_sstable overlapping) {
+            auto t = env.make_table_for_tests(s);
+            auto close_t = deferred_stop(t);
+            column_family_test(t).add_sstable(deleted).get();
+            column_family_test(t).add_sstable(overlapping).get();
+            return get_sstables_for_compaction(cs, t.as_compaction_group_view(), { deleted }).get();
+        };
+
+        // Data newer than all tombstones cannot be shadowed by them.
+        auto descriptor = get_tombstone_gc_job(make_live_sst(tombstone_timestamp + keys));
+        BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), 1);
+        BOOST_REQUIRE(descriptor.sstables.front() == deleted);
+
+        // Half of the tombstones may shadow overlapping data, so about half are purgeable.
+        descriptor = get_tombstone_gc_job(make_live_sst(tombstone_timestamp + keys / 2));
+        BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), 1);
+        BOOST_REQUIRE(descriptor.sstables.front() == deleted);
+
+        // All tombstones may shadow overlapping data, so compacting the sstable alone is futile.
+        descriptor = get_tombstone_gc_job(make_live_sst(tombstone_timestamp - 1));
+        BOOST_REQUIRE(descriptor.sstables.empty());
+
+        options["tombstone_threshold"] = "0.7";
+        cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, options);
+        descriptor = get_tombstone_gc_job(make_live_sst(tombstone_timestamp + keys / 2));
+        BOOST_REQUIRE(descriptor.sstables.empty());
+    });
+}
+
 SEASTAR_TEST_CASE(compaction_correctness_with_partitioned_sstable_set) {
     return test_env::do_with_async([] (test_env& env) {
         auto builder = schema_builder("tests", "tombstone_purge")
@@ -5746,6 +5812,115 @@ SEASTAR_TEST_CASE(compaction_optimization_to_avoid_bloom_filter_checks) {
     });
 }
 
+SEASTAR_TEST_CASE(compaction_bypasses_mutation_compactor_without_purgeable_data_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto builder = schema_builder("tests", "compactor_bypass")
+            .with_column("id", utf8_type, column_kind::partition_key)
+            .with_column("value", int32_type);
+        builder.set_gc_grace_seconds(0);
+        auto s = builder.build();
+        auto sst_gen = env.make_sst_factory(s);
+
+        auto compact = [&, s] (std::vector<shared_sstable> c) -> compaction_result {
+            auto t = env.make_table_for_tests(s);
+            auto stop = deferred_stop(t);
+            for (auto& sst : c) {
+                column_family_test(t).add_sstable(sst).get();
+            }
+            return compact_sstables(env, sstables::compaction_descriptor(std::move(c)), t, sst_gen).get();
+        };
+
+        auto make_insert = [&] (sstring key, int32_t value, std::optional<gc_clock::duration> ttl = std::nullopt) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            if (ttl) {
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(value), api::new_timestamp(), *ttl);
+            } else {
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(value), api::new_timestamp());
+            }
+            return m;
+        };
+
+        auto a1 = make_insert("a", 1);
+        auto b1 = make_insert("b", 1);
+        auto a2 = make_insert("a", 2);
+        auto c1 = make_insert("c", 1);
+
+        std::set<mutation, mutation_decorated_key_less_comparator> expected;
+        for (auto& m : {a1, b1, a2, c1}) {
+            auto [it, inserted] = expected.insert(m);
+            if (!inserted) {
+                auto merged = *it + m;
+                expected.erase(it);
+                expected.insert(std::move(merged));
+            }
+        }
+
+        // Neither tombstones nor expiring cells in the input, cells of the
+        // overlapping partition are still reconciled by the combined reader.
+        auto result = compact({
+            make_sstable_containing(sst_gen, {a1, b1}),
+            make_sstable_containing(sst_gen, {a2}),
+            make_sstable_containing(sst_gen, {c1}),
+        });
+        BOOST_REQUIRE_EQUAL(1, result.new_sstables.size());
+        BOOST_REQUIRE_EQUAL(expected.size(), result.stats.passed_through_partitions);
+        auto assertions = assert_that(sstable_reader(result.new_sstables.front(), s, env.make_reader_permit()));
+        for (auto& m : expected) {
+            assertions.produces(m);
+        }
+        assertions.produces_end_of_stream();
+
+        // A single input with expiring data requires the mutation compactor.
+        auto d1 = make_insert("d", 1, std::chrono::seconds(1));
+        result = compact({
+            make_sstable_containing(sst_gen, {a1, b1}),
+            make_sstable_containing(sst_gen, {d1}),
+        });
+        BOOST_REQUIRE_EQUAL(1, result.new_sstables.size());
+        BOOST_REQUIRE_EQUAL(0, result.stats.passed_through_partitions);
+    });
+}
+
+SEASTAR_TEST_CASE(compaction_merges_input_bloom_filters_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto sst_gen = env.make_sst_factory(s);
+
+        auto compact = [&, s] (std::vector<shared_sstable> c) -> compaction_result {
+            auto t = env.make_table_for_tests(s);
+            auto stop = deferred_stop(t);
+            for (auto& sst : c) {
+                column_family_test(t).add_sstable(sst).get();
+            }
+            return compact_sstables(env, sstables::compaction_descriptor(std::move(c)), t, sst_gen).get();
+        };
+
+        utils::chunked_vector<mutation> muts;
+        for (auto& pk : ss.make_pkeys(10)) {
+            mutation m(s, pk);
+            ss.add_row(m, ss.make_ckey(0), "v");
+            muts.push_back(std::move(m));
+        }
+
+        // The output of a compaction with nothing to purge contains exactly the input keys.
+        auto input = make_sstable_containing(sst_gen, muts);
+        auto result = compact({input});
+        BOOST_REQUIRE_EQUAL(1, result.new_sstables.size());
+        BOOST_REQUIRE_EQUAL(1, result.stats.merged_bloom_filters);
+        for (auto& m : muts) {
+            BOOST_REQUIRE(result.new_sstables.front()->filter_has_key(*s, m.key()));
+        }
+
+        // Purgeable data requires the filter to be built from the written keys.
+        mutation del(s, muts.front().decorated_key());
+        del.partition().apply(ss.new_tombstone());
+        result = compact({input, make_sstable_containing(sst_gen, {del})});
+        BOOST_REQUIRE_EQUAL(1, result.new_sstables.size());
+        BOOST_REQUIRE_EQUAL(0, result.stats.merged_bloom_filters);
+    });
+}
+
 static future<> run_incremental_compaction_test(sstables::offstrategy offstrategy, std::function<future<>(table_for_tests&, owned_ranges_ptr)> run_compaction) {
     return test_env::do_with_async([run_compaction = std::move(run_compaction), offstrategy] (test_env& env) {
         auto builder = schema_builder("tests", "test")
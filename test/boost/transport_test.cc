@@ -13,6 +13,8 @@
 
 #include "transport/request.hh"
 #include "transport/response.hh"
+#include "transport/segment.hh"
+#include "exceptions/exceptions.hh"
 
 #include "test/lib/random_utils.hh"
 #include "test/lib/test_utils.hh"
@@ -160,3 +162,86 @@ SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
     BOOST_CHECK_EQUAL(req.read_short(), 1);
     BOOST_CHECK_EQUAL(req.read_string(), "zed");
 }
+
+namespace {
+
+// Decodes all the segments in buf, returning their payloads and whether
+// they are self-contained.
+std::vector<std::pair<bytes, bool>> decode_segments(bytes_ostream& buf, bool compressed) {
+    namespace segment = cql_transport::segment;
+    auto data = buf.linearize();
+    std::vector<std::pair<bytes, bool>> ret;
+    while (!data.empty()) {
+        auto h = segment::parse_header(data.substr(0, segment::header_size(compressed)), compressed);
+        data.remove_prefix(segment::header_size(compressed));
+        auto body = data.substr(0, h.payload_size + segment::trailer_size);
+        data.remove_prefix(body.size());
+        auto payload = segment::decode_payload(h, temporary_buffer<char>(reinterpret_cast<const char*>(body.data()), body.size()));
+        ret.emplace_back(bytes(reinterpret_cast<const int8_t*>(payload.get()), payload.size()), h.self_contained);
+    }
+    return ret;
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_round_trip) {
+    namespace segment = cql_transport::segment;
+    for (bool compressed : {false, true}) {
+        auto small = tests::random::get_bytes(100);
+        auto repetitive = bytes(1000, int8_t('a'));
+        auto large = tests::random::get_bytes(2 * segment::max_payload_size + 10);
+
+        // Small frames are packed together into a single self-contained segment.
+        std::vector<bytes_view> frames{small, repetitive, small};
+        bytes_ostream out;
+        segment::encode(out, frames, compressed);
+        auto segments = decode_segments(out, compressed);
+        BOOST_REQUIRE_EQUAL(segments.size(), 1);
+        BOOST_REQUIRE(segments[0].second);
+        BOOST_REQUIRE(segments[0].first == small + repetitive + small);
+        if (compressed) {
+            BOOST_REQUIRE_LT(out.size(), small.size() * 2 + repetitive.size());
+        }
+
+        // A frame larger than a segment is split among segments which aren't
+        // self-contained, and frames around it go into segments of their own.
+        frames = {small, large, small};
+        out = bytes_ostream();
+        segment::encode(out, frames, compressed);
+        segments = decode_segments(out, compressed);
+        BOOST_REQUIRE_EQUAL(segments.size(), 5);
+        BOOST_REQUIRE(segments[0].second);
+        BOOST_REQUIRE(segments[0].first == small);
+        bytes reassembled;
+        for (size_t i = 1; i < 4; ++i) {
+            BOOST_REQUIRE(!segments[i].second);
+            BOOST_REQUIRE_LE(segments[i].first.size(), segment::max_payload_size);
+            reassembled += segments[i].first;
+        }
+        BOOST_REQUIRE(reassembled == large);
+        BOOST_REQUIRE(segments[4].second);
+        BOOST_REQUIRE(segments[4].first == small);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_corruption) {
+    namespace segment = cql_transport::segment;
+    for (bool compressed : {false, true}) {
+        auto frame = tests::random::get_bytes(100);
+        std::vector<bytes_view> frames{frame};
+        bytes_ostream out;
+        segment::encode(out, frames, compressed);
+        auto data = out.linearize();
+        auto hsize = segment::header_size(compressed);
+
+        auto corrupt_header = to_bytes(data);
+        corrupt_header[1] ^= 1;
+        BOOST_REQUIRE_THROW(segment::parse_header(bytes_view(corrupt_header).substr(0, hsize), compressed), exceptions::protocol_exception);
+
+        auto h = segment::parse_header(data.substr(0, hsize), compressed);
+        auto corrupt_payload = to_bytes(data.substr(hsize));
+        corrupt_payload[0] ^= 1;
+        BOOST_REQUIRE_THROW(segment::decode_payload(h, temporary_buffer<char>(reinterpret_cast<const char*>(corrupt_payload.data()), corrupt_payload.size())),
+                exceptions::protocol_exception);
+    }
+}
@@ -10,7 +10,7 @@ import logging
 import time
 from test.pylib.manager_client import ManagerClient
 from test.pylib.util import wait_for
-from test.cluster.util import new_test_keyspace, reconnect_driver, wait_for_cql_and_get_hosts
+from test.cluster.util import new_test_keyspace, reconnect_driver, wait_for_cql_and_get_hosts, get_metric_total
 from test.cluster.conftest import skip_mode
 
 logger = logging.getLogger(__name__)
@@ -202,3 +202,48 @@ async def test_batchlog_replay_includes_cdc(manager: ManagerClient) -> None:
 
         result2 = await cql.run_async(f"SELECT * FROM {cdc_table_name} WHERE key = 40 ALLOW FILTERING")
         assert len(result2) == 1, f"Expected 1 CDC mutation for key 40, got {len(result2)}"
+
+@pytest.mark.asyncio
+@skip_mode('release', 'error injections are not supported in release mode')
+async def test_batchlog_replay_coalesces_writes(manager: ManagerClient) -> None:
+    """ Test that the writes of batches replayed together are coalesced per replica,
+        even though write coalescing is disabled for the other writes.
+    1. Create a cluster with 3 nodes.
+    2. Write many batches, failing their removal from the batchlog, so they need to be replayed.
+    3. Wait for the batches to be replayed and removed from the batchlog.
+    4. Verify that the replayed writes were sent to the replicas in fewer messages than writes.
+    """
+
+    config = {'error_injections_at_startup': ['short_batchlog_manager_replay_interval'], 'write_request_timeout_in_ms': 2000,
+              'batchlog_replay_scheduling_group': 'main'}
+    servers = await manager.servers_add(3, config=config, auto_rack_dc="dc1")
+    cql, hosts = await manager.get_ready_cql(servers)
+
+    async with new_test_keyspace(manager, "WITH replication = {'class': 'NetworkTopologyStrategy', 'replication_factor': 3}") as ks:
+        await cql.run_async(f"CREATE TABLE {ks}.tab (key int, c int, v int, PRIMARY KEY (key, c))")
+
+        await asyncio.gather(*[manager.api.enable_injection(s.ip_addr, "storage_proxy_fail_remove_from_batchlog", one_shot=False) for s in servers])
+        await asyncio.gather(*[manager.api.enable_injection(s.ip_addr, "skip_batch_replay", one_shot=False) for s in servers])
+
+        async def write_batch(i):
+            try:
+                await cql.run_async(f"BEGIN BATCH INSERT INTO {ks}.tab (key, c, v) VALUES ({i},0,0); INSERT INTO {ks}.tab (key, c, v) VALUES ({i + 1000},0,0); APPLY BATCH")
+            except Exception as e:
+                # injected error is expected
+                logger.info(f"Error executing batch: {e}")
+        await asyncio.gather(*[write_batch(i) for i in range(100)])
+
+        await asyncio.gather(*[manager.api.disable_injection(s.ip_addr, "storage_proxy_fail_remove_from_batchlog") for s in servers])
+        await asyncio.gather(*[manager.api.disable_injection(s.ip_addr, "skip_batch_replay") for s in servers])
+
+        async def batchlog_empty() -> bool:
+            for h in hosts:
+                if (await cql.run_async("SELECT COUNT(*) FROM system.batchlog", host=h))[0].count > 0:
+                    return None
+            return True
+        await wait_for(batchlog_empty, time.time() + 60)
+
+        coalesced = await get_metric_total(manager, servers, "scylla_storage_proxy_coordinator_coalesced_mutations")
+        batches = await get_metric_total(manager, servers, "scylla_storage_proxy_coordinator_mutation_batches")
+        logger.info(f"{coalesced} replayed writes sent in {batches} batches")
+        assert 0 < batches < coalesced
@@ -321,3 +321,53 @@ async def test_canceling_hint_draining(manager: ManagerClient):
     # Make sure draining finishes successfully.
     assert await_sync_point(s1, sync_point, 60)
     await s1_log.wait_for(f"Removed hint directory for {host_id2}")
+
+@pytest.mark.asyncio
+async def test_replay_compressed_coalesced_hints(manager: ManagerClient):
+    """
+    Hints stored compressed are replayed in batches, in which the hints of
+    the same partition are merged before they are sent. Verify that all the
+    hinted writes reach the recovered node, and that they were coalesced.
+    """
+    cfg = {"hints_compression_enabled": True}
+    s1, s2 = await manager.servers_add(2, config=cfg)
+    cql = await manager.get_cql_exclusive(s1)
+
+    async with new_test_keyspace(manager, "WITH replication = {'class': 'NetworkTopologyStrategy', 'replication_factor': 2}") as ks:
+        table = f"{ks}.t"
+        await cql.run_async(f"CREATE TABLE {table} (pk int, ck int, v text, PRIMARY KEY (pk, ck))")
+
+        await manager.server_stop_gracefully(s2.server_id)
+        await manager.server_not_sees_other_server(s1.ip_addr, s2.ip_addr)
+
+        partitions = 10
+        rows = 100
+        insert = cql.prepare(f"INSERT INTO {table} (pk, ck, v) VALUES (?, ?, ?)")
+        insert.consistency_level = ConsistencyLevel.ONE
+        for pk in range(partitions):
+            for ck in range(rows):
+                await cql.run_async(insert, [pk, ck, "x" * 100 + str(ck)])
+
+        async def no_hints_in_progress() -> bool:
+            return get_hint_manager_metric(s1, "size_of_hints_in_progress") == 0 or None
+        await wait_for(no_hints_in_progress, time.time() + 30)
+
+        sent_before = get_hint_manager_metric(s1, "sent_total")
+        sync_point = create_sync_point(s1)
+        await manager.server_start(s2.server_id)
+        await manager.server_sees_other_server(s1.ip_addr, s2.ip_addr)
+        assert await_sync_point(s1, sync_point, 60)
+
+        assert get_hint_manager_metric(s1, "sent_total") - sent_before == partitions * rows
+        assert get_hint_manager_metric(s1, "coalesced_total") > 0
+        assert get_hint_manager_metric(s1, "discarded") == 0
+
+        # All the writes must have reached s2 through the hints alone.
+        await manager.server_stop_gracefully(s1.server_id)
+        cql2 = await manager.get_cql_exclusive(s2)
+        for pk in range(partitions):
+            res = await cql2.run_async(SimpleStatement(f"SELECT ck, v FROM {table} WHERE pk = {pk}", consistency_level=ConsistencyLevel.ONE))
+            assert [(r.ck, r.v) for r in res] == [(ck, "x" * 100 + str(ck)) for ck in range(rows)]
+
+        # For dropping the keyspace
+        await manager.server_start(s1.server_id)
@@ -0,0 +1,59 @@
+#
+# Copyright (C) 2025-present ScyllaDB
+#
+# SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+#
+import asyncio
+import pytest
+import logging
+
+from cassandra.query import SimpleStatement, ConsistencyLevel
+
+from test.pylib.manager_client import ManagerClient
+from test.cluster.util import new_test_keyspace, cas_increment, get_metric_total
+
+
+logger = logging.getLogger(__name__)
+
+# Conditional updates of a key through the coordinator which updated it last
+# skip the prepare round by proposing on a lease, and conditional updates of
+# the same keys from several coordinators at once, which invalidate each
+# other's leases, must remain linearizable.
+@pytest.mark.asyncio
+@pytest.mark.parametrize("tablets", [False, True])
+async def test_lwt_lease(manager: ManagerClient, tablets: bool):
+    cfg = {'paxos_lease_period_in_ms': 10000}
+    servers = await manager.servers_add(3, config=cfg, auto_rack_dc='dc1')
+
+    cql = manager.get_cql()
+    tablets_opt = "{'enabled': true}" if tablets else "{'enabled': false}"
+    async with new_test_keyspace(manager, f"WITH replication = {{'class': 'NetworkTopologyStrategy', 'replication_factor': 3}} AND tablets = {tablets_opt}") as ks:
+        table = f"{ks}.t"
+        await cql.run_async(f"CREATE TABLE {table} (pk int PRIMARY KEY, v int)")
+        keys = 4
+        for pk in range(keys):
+            await cql.run_async(f"INSERT INTO {table} (pk, v) VALUES ({pk}, 0)")
+
+        hosts = cql.cluster.metadata.all_hosts()
+
+        # Every update of the key goes through the same coordinator, so all
+        # but the first one may propose on the lease granted after the
+        # previous one.
+        updates = 20
+        for i in range(updates):
+            res = await cql.run_async(f"UPDATE {table} SET v = {i + 1} WHERE pk = 0 IF v = {i}", host=hosts[0])
+            assert res[0].applied
+
+        hits = await get_metric_total(manager, servers, "scylla_storage_proxy_coordinator_cas_lease_hits")
+        rounds = await get_metric_total(manager, servers, "scylla_storage_proxy_coordinator_cas_round_trips")
+        logger.info(f"{hits} lease hits, {rounds} paxos rounds for {updates} updates")
+        assert hits > 0
+
+        increments = 20
+        await asyncio.gather(*[cas_increment(cql, table, keys, increments, h) for h in hosts])
+
+        rows = await cql.run_async(SimpleStatement(f"SELECT pk, v FROM {table}", consistency_level=ConsistencyLevel.SERIAL))
+        assert sum(r.v for r in rows) == updates + increments * len(hosts)
+
+        misses = await get_metric_total(manager, servers, "scylla_storage_proxy_coordinator_cas_lease_misses")
+        logger.info(f"{misses} lease misses")
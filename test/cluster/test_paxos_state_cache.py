@@ -0,0 +1,54 @@
+#
+# Copyright (C) 2025-present ScyllaDB
+#
+# SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+#
+import asyncio
+import pytest
+import logging
+
+from cassandra.query import SimpleStatement, ConsistencyLevel
+
+from test.pylib.manager_client import ManagerClient
+from test.cluster.util import new_test_keyspace, cas_increment, get_metric_total
+
+
+logger = logging.getLogger(__name__)
+
+# Conditional updates of the same keys from several coordinators at once, which
+# steal the ballots from each other, must remain linearizable when the replicas
+# serve the paxos state from the paxos state cache.
+@pytest.mark.asyncio
+@pytest.mark.parametrize("tablets", [False, True])
+async def test_paxos_state_cache(manager: ManagerClient, tablets: bool):
+    cfg = {'paxos_state_cache_size_in_mb': 16}
+    servers = await manager.servers_add(3, config=cfg, auto_rack_dc='dc1')
+
+    cql = manager.get_cql()
+    tablets_opt = "{'enabled': true}" if tablets else "{'enabled': false}"
+    async with new_test_keyspace(manager, f"WITH replication = {{'class': 'NetworkTopologyStrategy', 'replication_factor': 3}} AND tablets = {tablets_opt}") as ks:
+        table = f"{ks}.t"
+        await cql.run_async(f"CREATE TABLE {table} (pk int PRIMARY KEY, v int)")
+        keys = 4
+        for pk in range(keys):
+            await cql.run_async(f"INSERT INTO {table} (pk, v) VALUES ({pk}, 0)")
+
+        increments = 20
+        hosts = cql.cluster.metadata.all_hosts()
+        await asyncio.gather(*[cas_increment(cql, table, keys, increments, h) for h in hosts])
+
+        rows = await cql.run_async(SimpleStatement(f"SELECT pk, v FROM {table}", consistency_level=ConsistencyLevel.SERIAL))
+        assert sum(r.v for r in rows) == increments * len(hosts)
+
+        # Conditional updates of many keys at once are pruned on the replicas
+        # within the same prune batch delay.
+        many_keys = 200
+        await asyncio.gather(*[cql.run_async(f"INSERT INTO {table} (pk, v) VALUES ({pk}, 0) IF NOT EXISTS") for pk in range(keys, keys + many_keys)])
+
+        hits = await get_metric_total(manager, servers, "scylla_paxos_state_cache_hits")
+        prunes = await get_metric_total(manager, servers, "scylla_paxos_prunes")
+        batches = await get_metric_total(manager, servers, "scylla_paxos_prune_batches")
+        superseded = await get_metric_total(manager, servers, "scylla_paxos_superseded_prunes")
+        logger.info(f"{hits} paxos state cache hits, {prunes} prunes in {batches} batches, {superseded} superseded")
+        assert hits > 0
+        assert 0 < batches < prunes
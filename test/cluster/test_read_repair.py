@@ -344,3 +344,54 @@ async def test_read_repair_with_trace_logging(request, manager):
             found_read_repair |= "digest mismatch, starting read repair" == event.description
 
         assert found_read_repair
+
+
+@pytest.mark.asyncio
+@skip_mode('release', 'error injections are not supported in release mode')
+async def test_partial_read_repair(manager):
+    """Replicas of a large partition which disagree on only a few of its rows
+    are repaired by reading only the clustering ranges they disagree on.
+    """
+    cmdline = ["--hinted-handoff-enabled", "0"]
+    config = {"read_repair_digest_tree_fanout": 4}
+
+    [node1, node2] = await manager.servers_add(2, cmdline=cmdline, config=config, auto_rack_dc="dc1")
+
+    cql = manager.get_cql()
+    srvs = await manager.running_servers()
+    await wait_for_cql_and_get_hosts(cql, srvs, time.time() + 60)
+
+    async with new_test_keyspace(manager, "WITH replication = {'class': 'NetworkTopologyStrategy', 'replication_factor': 2};") as ks:
+        await cql.run_async(f"CREATE TABLE {ks}.t (pk bigint, ck bigint, c int, PRIMARY KEY (pk, ck));")
+
+        total_rows = 200
+        insert_stmt = cql.prepare(f"INSERT INTO {ks}.t (pk, ck, c) VALUES (?, ?, ?)")
+        insert_stmt.consistency_level = ConsistencyLevel.ALL
+        for ck in range(total_rows):
+            await cql.run_async(insert_stmt, (0, ck, ck))
+
+        # Only node2 gets the updates of a few rows.
+        update_stmt = cql.prepare(f"UPDATE {ks}.t SET c = ? WHERE pk = ? AND ck = ?")
+        update_stmt.consistency_level = ConsistencyLevel.ONE
+        updated = {17, 18, 150}
+        await manager.api.enable_injection(node1.ip_addr, "database_apply", one_shot=False)
+        for ck in updated:
+            await cql.run_async(update_stmt, (-ck, 0, ck))
+        await manager.api.disable_injection(node1.ip_addr, "database_apply")
+
+        select = SimpleStatement(f"SELECT * FROM {ks}.t WHERE pk = 0", consistency_level=ConsistencyLevel.ALL)
+        rows = await cql.run_async(select)
+        assert len(rows) == total_rows
+        for row in rows:
+            assert row.c == (-row.ck if row.ck in updated else row.ck)
+
+        partial_repairs = 0
+        for srv in srvs:
+            metrics = await manager.metrics.query(srv.ip_addr)
+            partial_repairs += metrics.get("scylla_storage_proxy_coordinator_partial_read_repairs") or 0
+        assert partial_repairs == 1
+
+        # The replicas agree on the partition after the repair.
+        tracing = execute_with_tracing(cql, select, log=True)
+        for event in tracing[0]:
+            assert "digest mismatch" not in event.description
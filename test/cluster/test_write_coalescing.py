@@ -0,0 +1,54 @@
+#
+# Copyright (C) 2025-present ScyllaDB
+#
+# SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+#
+import asyncio
+import pytest
+import logging
+
+from cassandra.query import SimpleStatement, ConsistencyLevel
+
+from test.pylib.internal_types import ServerInfo
+from test.pylib.manager_client import ManagerClient
+from test.cluster.util import new_test_keyspace
+
+
+logger = logging.getLogger(__name__)
+
+async def get_coordinator_metric(manager: ManagerClient, servers: list[ServerInfo], metric_name: str) -> int:
+    total = 0
+    for s in servers:
+        metrics = await manager.metrics.query(s.ip_addr)
+        total += metrics.get(f"scylla_storage_proxy_coordinator_{metric_name}") or 0
+    return int(total)
+
+# Writes sent to the same replicas within write_coalescing_window_in_us should
+# be sent in MUTATION_BATCH messages, and still each be acknowledged by all the
+# replicas, as required by their consistency level.
+@pytest.mark.asyncio
+async def test_coalesced_writes(manager: ManagerClient):
+    cfg = {'write_coalescing_window_in_us': 2000}
+    servers = await manager.servers_add(3, config=cfg)
+
+    cql = manager.get_cql()
+    async with new_test_keyspace(manager, "WITH replication = {'class': 'NetworkTopologyStrategy', 'replication_factor': 3}") as ks:
+        table = f"{ks}.t"
+        await cql.run_async(f"CREATE TABLE {table} (pk int primary key, v int)")
+
+        insert = cql.prepare(f"INSERT INTO {table} (pk, v) VALUES (?, ?)")
+        insert.consistency_level = ConsistencyLevel.ALL
+        await asyncio.gather(*[cql.run_async(insert, [i, i + 1]) for i in range(1000)])
+
+        coalesced = await get_coordinator_metric(manager, servers, "coalesced_mutations")
+        batches = await get_coordinator_metric(manager, servers, "mutation_batches")
+        logger.info(f"{coalesced} mutations sent in {batches} batches")
+        assert coalesced > 0
+        # With this many concurrent writes, batches hold more than one write
+        # on average.
+        assert 0 < batches < coalesced
+
+        # Every replica received every write, so reading from any one of them
+        # sees all the rows.
+        rows = await cql.run_async(SimpleStatement(f"SELECT pk, v FROM {table}", consistency_level=ConsistencyLevel.ONE))
+        assert sorted((r.pk, r.v) for r in rows) == [(i, i + 1) for i in range(1000)]
@@ -412,6 +412,28 @@ async def start_writes_to_cdc_table(cql: Session, concurrency: int = 3):
 
     return restart, stop_and_verify
 
+async def cas_increment(cql: Session, table: str, keys: int, increments: int, host: Host) -> None:
+    """Increments the v column of keys 0..keys-1 of the table in turn, increments
+    times in total, with compare-and-set through the given host. Each update is
+    retried until it applies, so every increment is counted exactly once, even
+    when several such workers contend on the same keys."""
+    select = SimpleStatement(f"SELECT v FROM {table} WHERE pk = %s", consistency_level=ConsistencyLevel.SERIAL)
+    for i in range(increments):
+        pk = i % keys
+        while True:
+            v = (await cql.run_async(select, [pk], host=host))[0].v
+            res = await cql.run_async(f"UPDATE {table} SET v = {v + 1} WHERE pk = {pk} IF v = {v}", host=host)
+            if res[0].applied:
+                break
+
+async def get_metric_total(manager: ManagerClient, servers: list[ServerInfo], name: str) -> int:
+    """Sum of the values of the metric over all the shards of the servers"""
+    total = 0
+    for s in servers:
+        metrics = await manager.metrics.query(s.ip_addr)
+        total += metrics.get(name) or 0
+    return int(total)
+
 def log_run_time(f):
     @functools.wraps(f)
     async def wrapped(*args, **kwargs):
@@ -10,6 +10,7 @@ import pytest
 from cassandra.cluster import NoHostAvailable
 from cassandra.protocol import InvalidRequest
 from .util import unique_name, new_cql, ScyllaMetrics
+from .rest_api import scylla_inject_error
 from contextlib import contextmanager
 
 
@@ -88,3 +89,22 @@ def test_shed_too_large_request(cql, table1, scylla_only):
     cql.execute(prepared, ["small_string"])
     res = [row for row in cql.execute(f"SELECT p, t FROM {table1}")]
     assert len(res) == 1 and res[0].p == 42 and res[0].t == "small_string"
+
+# Many requests pipelined over one connection should all be answered, and
+# their responses are coalesced into fewer writes than there are frames.
+def test_pipelined_requests(cql, table1, scylla_only):
+    prepared = cql.prepare(f"INSERT INTO {table1} (p,t) VALUES (?,?)")
+    # Each flush of responses is delayed, so that the responses of the
+    # requests completing meanwhile are queued, and written together with
+    # others. Without coalescing, every frame would be a write of its own.
+    with scylla_inject_error(cql, "cql_delay_response_flush"):
+        initial_metrics = ScyllaMetrics.query(cql)
+        futures = [cql.execute_async(prepared, [i, str(i)]) for i in range(1000)]
+        for f in futures:
+            f.result()
+        current_metrics = ScyllaMetrics.query(cql)
+    frames = current_metrics.get('scylla_transport_response_frames') - initial_metrics.get('scylla_transport_response_frames')
+    writes = current_metrics.get('scylla_transport_response_writes') - initial_metrics.get('scylla_transport_response_writes')
+    assert frames >= 1000
+    assert 0 < writes < frames
+    assert cql.execute(f"SELECT t FROM {table1} WHERE p = 999").one().t == "999"
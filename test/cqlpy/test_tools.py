@@ -1214,6 +1214,62 @@ def test_scrub_validate_mode(scylla_path, scrub_workdir, scrub_schema_file, scru
         assert os.path.exists(scrub_bad_sstable)
 
 
+def test_simulate_compaction(scylla_path, scrub_workdir, scrub_schema_file):
+    with tempfile.TemporaryDirectory(prefix="test_simulate_compaction", dir=scrub_workdir) as tmp_dir:
+        input_dir = os.path.join(tmp_dir, "input")
+        output_dir = os.path.join(tmp_dir, "output")
+        os.mkdir(input_dir)
+        os.mkdir(output_dir)
+        sst_json_path = os.path.join(tmp_dir, "sst.json")
+        num_sstables = 4
+        for generation in range(1, num_sstables + 1):
+            with open(sst_json_path, "w") as f:
+                sst_json = [
+                    {
+                        "key": { "raw": "0004000000c8" },
+                        "clustering_elements": [
+                            { "type": "clustering-row", "key": { "raw": "000400000001" }, "columns": { "v": { "is_live": True, "type": "regular", "timestamp": 1686815362417553 + generation, "value": "vv" } } }
+                        ]
+                    }
+                ]
+                json.dump(sst_json, f)
+            subprocess.check_call([scylla_path, "sstable", "write", "--schema-file", scrub_schema_file, "--output-dir", input_dir, "--generation", str(generation), "--input-file", sst_json_path])
+        ssts = glob.glob(os.path.join(input_dir, "*-Data.db"))
+        assert len(ssts) == num_sstables
+
+        res = json.loads(subprocess.check_output([scylla_path, "sstable", "simulate-compaction", "--schema-file", scrub_schema_file,
+                                                  "--compaction-strategy", "SizeTieredCompactionStrategy",
+                                                  "--output-dir", output_dir] + ssts))
+
+        assert res["compaction_strategy"] == "SizeTieredCompactionStrategy"
+        steps = res["steps"]
+        assert len(steps) == num_sstables
+        # The minimum threshold isn't enforced, so any pair of sstables in the same tier is compacted.
+        assert [step["sstables"] for step in steps] == [1, 1, 1, 1]
+        assert [step["compactions"] for step in steps] == [0, 1, 2, 3]
+        assert steps[-1]["written_bytes"] > steps[-1]["flushed_bytes"]
+        assert res["write_amplification"] > 1
+        assert res["sstables_per_read"] == 1
+        # The input sstables are left intact, sstables written by the simulation are removed.
+        assert len(glob.glob(os.path.join(input_dir, "*-Data.db"))) == num_sstables
+        assert len(glob.glob(os.path.join(output_dir, "*-Data.db"))) == 0
+
+        # Without compaction, all sstables overlap, and the final read
+        # amplification isn't affected by the major compaction measuring space
+        # amplification.
+        res = json.loads(subprocess.check_output([scylla_path, "sstable", "simulate-compaction", "--schema-file", scrub_schema_file,
+                                                  "--compaction-strategy", "NullCompactionStrategy",
+                                                  "--output-dir", output_dir] + ssts))
+
+        steps = res["steps"]
+        assert [step["sstables"] for step in steps] == [1, 2, 3, 4]
+        assert [step["compactions"] for step in steps] == [0, 0, 0, 0]
+        assert [step["sstables_per_read"] for step in steps] == [1, 2, 3, 4]
+        assert res["write_amplification"] == 1
+        assert res["sstables_per_read"] == num_sstables
+        assert len(glob.glob(os.path.join(output_dir, "*-Data.db"))) == 0
+
+
 def _to_cql3_type(t: Type) -> str:
     # map from Python type to Cassandra type, only a small subset is supported
     py_to_cql3_type = {int: "Int32Type",
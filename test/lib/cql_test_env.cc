@@ -1111,6 +1111,7 @@ class single_node_cql_env : public cql_test_env {
             bmcfg.replay_rate = 100000000;
             bmcfg.write_request_timeout = 2s;
             bmcfg.delay = 0ms;
+            bmcfg.replay_concurrency = cfg->batchlog_replay_concurrency();
             _batchlog_manager.start(std::ref(_qp), std::ref(_sys_ks), bmcfg).get();
             auto stop_bm = defer_verbose_shutdown("batchlog manager", [this] {
                 _batchlog_manager.stop().get();
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/testing/random.hh>
+#include <seastar/testing/test_runner.hh>
+
+#include <random>
+
+#include "cql3/expr/compiled_filter.hh"
+#include "cql3/expr/expr-utils.hh"
+#include "schema/schema_builder.hh"
+#include "test/lib/expr_test_utils.hh"
+
+using namespace cql3::expr;
+using namespace cql3::expr::test_utils;
+
+// Evaluates `v > ? AND ts < ? AND s LIKE 'a%'` over a batch of rows, the way
+// restrictions_filter does when filtering the rows of a partition.
+class filter_evaluation {
+public:
+    static constexpr size_t count = 256;
+private:
+    schema_ptr _schema;
+    std::vector<std::unique_ptr<evaluation_inputs_data>> _inputs_data;
+    std::vector<evaluation_inputs> _inputs;
+    expression _filter;
+    compiled_filter _compiled;
+    std::optional<compiled_filter::bound> _bound;
+public:
+    filter_evaluation()
+        : _schema(schema_builder("ks", "cf")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type, column_kind::regular_column)
+                .with_column("ts", timestamp_type, column_kind::regular_column)
+                .with_column("s", utf8_type, column_kind::regular_column)
+                .build())
+    {
+        auto eng = seastar::testing::local_random_engine;
+        auto dist = std::uniform_int_distribution<int32_t>(0, 1000);
+        for (size_t i = 0; i < count; i++) {
+            auto [inputs, data] = make_evaluation_inputs(_schema, {
+                {"pk", make_int_raw(0)},
+                {"ck", make_int_raw(i)},
+                {"v", make_int_raw(dist(eng))},
+                {"ts", cql3::raw_value::make_value(timestamp_type->decompose(db_clock::time_point(db_clock::duration(dist(eng)))))},
+                {"s", make_text_raw(dist(eng) % 2 ? "abc" : "bcd")},
+            }, {make_int_raw(500), cql3::raw_value::make_value(timestamp_type->decompose(db_clock::time_point(db_clock::duration(500))))});
+            _inputs.push_back(inputs);
+            _inputs_data.push_back(std::move(data));
+        }
+        auto col = [&] (const char* name) -> expression {
+            return column_value(_schema->get_column_definition(name));
+        };
+        _filter = conjunction{{
+            binary_operator(col("v"), oper_t::GT, make_bind_variable(0, int32_type)),
+            binary_operator(col("ts"), oper_t::LT, make_bind_variable(1, timestamp_type)),
+            binary_operator(col("s"), oper_t::LIKE, make_text_const("a%")),
+        }};
+        _compiled = compiled_filter(_filter);
+        _bound.emplace(_compiled.bind(*_inputs.front().selection, *_inputs.front().options));
+    }
+
+    const expression& expr() const { return _filter; }
+    const compiled_filter::bound& bound_filter() const { return *_bound; }
+    std::span<const evaluation_inputs> inputs() const { return _inputs; }
+};
+
+PERF_TEST_F(filter_evaluation, evaluate_row_by_row) {
+    for (auto& inputs : this->inputs()) {
+        perf_tests::do_not_optimize(is_satisfied_by(expr(), inputs));
+    }
+    return count;
+}
+
+PERF_TEST_F(filter_evaluation, compiled_row_by_row) {
+    for (auto& inputs : this->inputs()) {
+        perf_tests::do_not_optimize(bound_filter().is_satisfied_by(inputs));
+    }
+    return count;
+}
+
+PERF_TEST_F(filter_evaluation, compiled_batch) {
+    boost::dynamic_bitset<> selected(count);
+    selected.set();
+    bound_filter().filter_batch(inputs(), selected);
+    perf_tests::do_not_optimize(selected);
+    return count;
+}
@@ -18,6 +18,7 @@
 #include "db/config.hh"
 #include "generic_server.hh"
 #include "test/perf/perf.hh"
+#include "transport/segment.hh"
 
 seastar::logger plog("perf");
 
@@ -27,10 +28,43 @@ struct test_config {
     uint64_t requests_per_connection;
     unsigned request_size;
     unsigned response_size;
+    unsigned frames_per_segment;
+    bool compress_segments;
     std::string server_host;
     uint16_t server_port;
 };
 
+// Frames of the given size and count, packed into segments.
+static bytes_ostream make_segments(unsigned frame_size, unsigned count, bool compressed) {
+    // Somewhat compressible, like real frames.
+    bytes frame(bytes::initialized_later(), frame_size);
+    for (unsigned i = 0; i < frame_size; ++i) {
+        frame[i] = int8_t(i % 64);
+    }
+    std::vector<bytes_view> frames(count, bytes_view(frame));
+    bytes_ostream out;
+    cql_transport::segment::encode(out, frames, compressed);
+    return out;
+}
+
+static future<> write_segments(output_stream<char>& out, const bytes_ostream& segments) {
+    for (bytes_view fragment : segments.fragments()) {
+        co_await out.write(reinterpret_cast<const char*>(fragment.data()), fragment.size());
+    }
+    co_await out.flush();
+}
+
+// Reads segments until they carry the given number of bytes of frames.
+static future<> read_segments(input_stream<char>& in, size_t size, bool compressed) {
+    while (size) {
+        auto segment = co_await cql_transport::segment::read(in, compressed);
+        if (!segment) {
+            throw std::runtime_error("unexpected end of stream");
+        }
+        size -= std::min(size, segment->payload.size());
+    }
+}
+
 class test_connection : public generic_server::connection {
     const test_config& _conf;
     uint64_t _requests;
@@ -51,9 +85,14 @@ class test_connection : public generic_server::connection {
     }
 
     virtual future<> process_request() override {
-        co_await _read_buf.read_exactly(_conf.request_size);
-        co_await _write_buf.write(temporary_buffer<char>(_conf.response_size));
-        co_await _write_buf.flush();
+        if (_conf.frames_per_segment) {
+            co_await read_segments(_read_buf, size_t(_conf.request_size) * _conf.frames_per_segment, _conf.compress_segments);
+            co_await write_segments(_write_buf, make_segments(_conf.response_size, _conf.frames_per_segment, _conf.compress_segments));
+        } else {
+            co_await _read_buf.read_exactly(_conf.request_size);
+            co_await _write_buf.write(temporary_buffer<char>(_conf.response_size));
+            co_await _write_buf.flush();
+        }
     // simulate that it take 2 exchanges to establish logical connection
     // this is important for performance as server disables cpu concurrency
     // limiting code after that
@@ -98,6 +137,11 @@ struct tester {
                 auto out = sock.output();
                 auto in = sock.input();
                 for (uint64_t i = 0; i <= conf.requests_per_connection; i++) {
+                    if (conf.frames_per_segment) {
+                        co_await write_segments(out, make_segments(conf.request_size, conf.frames_per_segment, conf.compress_segments));
+                        co_await read_segments(in, size_t(conf.response_size) * conf.frames_per_segment, conf.compress_segments);
+                        continue;
+                    }
                     co_await out.write(temporary_buffer<char>(conf.request_size));
                     co_await out.flush();
                     co_await in.read_exactly(conf.response_size);
@@ -126,6 +170,8 @@ int main(int argc, char** argv) {
         ("requests-per-connection", bpo::value<uint64_t>()->default_value(1024), "number of requests issued before closing the connection and making new one")
         ("request-size", bpo::value<unsigned>()->default_value(1024), "request size")
         ("response-size", bpo::value<unsigned>()->default_value(1024), "response size")
+        ("frames-per-segment", bpo::value<unsigned>()->default_value(0), "if non-zero, each request and response is this many frames packed into CQL v5 segments")
+        ("compress-segments", bpo::value<bool>()->default_value(false), "compress segments with lz4")
         ("server-host", bpo::value<std::string>()->default_value("127.0.0.1"), "server address, defaults to localhost")
         ("server-port", bpo::value<uint16_t>()->default_value(1234), "server port")
     ;
@@ -136,6 +182,8 @@ int main(int argc, char** argv) {
         conf.requests_per_connection = app.configuration()["requests-per-connection"].as<uint64_t>();
         conf.request_size = app.configuration()["request-size"].as<unsigned>();
         conf.response_size = app.configuration()["response-size"].as<unsigned>();
+        conf.frames_per_segment = app.configuration()["frames-per-segment"].as<unsigned>();
+        conf.compress_segments = app.configuration()["compress-segments"].as<bool>();
         conf.server_host = app.configuration()["server-host"].as<std::string>();
         conf.server_port = app.configuration()["server-port"].as<uint16_t>();
 
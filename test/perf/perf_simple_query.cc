@@ -15,6 +15,7 @@
 #include "test/lib/cql_test_env.hh"
 #include "test/perf/perf.hh"
 #include <seastar/core/app-template.hh>
+#include <seastar/core/coroutine.hh>
 #include <seastar/testing/test_runner.hh>
 #include "test/lib/random_utils.hh"
 #include "db/config.hh"
@@ -73,6 +74,7 @@ struct test_config {
     bool stop_on_error;
     sstring timeout;
     bool bypass_cache;
+    bool lwt;
     std::optional<unsigned> initial_tablets;
 };
 
@@ -91,6 +93,7 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", mode=" << cfg.mode
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", lwt=" << (cfg.lwt ? "yes" : "no")
            << "}";
 }
 
@@ -158,6 +161,58 @@ static std::vector<perf_result> test_write(cql_test_env& env, test_config& cfg)
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
 }
 
+// Executes a prepared statement with the key as the only value, and follows
+// its bounces to the shard which owns the partition, like cql_server does.
+static future<> execute_prepared_on_owner(cql_test_env& env, cql3::prepared_cache_key_type id, bytes key) {
+    auto msg = co_await env.execute_prepared(id, {{cql3::raw_value::make_value(key)}});
+    auto shard = msg->move_to_shard();
+    while (shard) {
+        shard = co_await smp::submit_to(*shard, [&env, id, key] () -> future<std::optional<unsigned>> {
+            auto msg = co_await env.execute_prepared(id, {{cql3::raw_value::make_value(key)}});
+            co_return msg->move_to_shard();
+        });
+    }
+}
+
+static std::vector<perf_result> test_lwt_write(cql_test_env& env, test_config& cfg) {
+    create_partitions(env, cfg);
+    sstring usings;
+    if (!cfg.timeout.empty()) {
+        usings += "USING TIMEOUT " + cfg.timeout;
+    }
+    sstring query = format("UPDATE cf {}SET "
+            "\"C0\" = 0x8f75da6b3dcec90c8a404fb9a5f6b0621e62d39c69ba5758e5f41b78311fbb26cc7a "
+            "WHERE \"KEY\" = ? IF EXISTS", usings);
+    auto id = env.prepare(query).get();
+    auto bounces = [&env] {
+        return env.qp().map_reduce0([] (cql3::query_processor& qp) { return qp.bounces_to_shard(); }, uint64_t(0), std::plus<uint64_t>()).get();
+    };
+    const auto bounces_before = bounces();
+    auto results = time_parallel([&env, &cfg, id] {
+            return execute_prepared_on_owner(env, id, make_random_key(cfg));
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+    std::cout << "Bounced requests: " << bounces() - bounces_before << std::endl;
+    // Paxos rounds waited for per operation, and how many operations proposed
+    // on a lease instead of preparing a ballot (see --paxos-lease-period-in-ms).
+    struct cas_stats {
+        uint64_t operations = 0;
+        uint64_t round_trips = 0;
+        uint64_t lease_hits = 0;
+    };
+    auto sum = [] (cas_stats a, cas_stats b) {
+        return cas_stats{a.operations + b.operations, a.round_trips + b.round_trips, a.lease_hits + b.lease_hits};
+    };
+    auto cas = env.get_storage_proxy().map_reduce0([sum] (const service::storage_proxy& sp) {
+        return map_reduce_scheduling_group_specific<service::storage_proxy_stats::stats>([] (const service::storage_proxy_stats::stats& stats) {
+            return cas_stats{stats.cas_total_operations, stats.cas_round_trips, stats.cas_lease_hits};
+        }, sum, cas_stats{}, sp.get_stats_key());
+    }, cas_stats{}, sum).get();
+    if (cas.operations) {
+        std::cout << fmt::format("Paxos rounds per operation: {:.2f}, lease hits: {}", double(cas.round_trips) / cas.operations, cas.lease_hits) << std::endl;
+    }
+    return results;
+}
+
 static std::vector<perf_result> test_delete(cql_test_env& env, test_config& cfg) {
     create_partitions(env, cfg);
     sstring usings;
@@ -230,6 +285,8 @@ static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg)
     case test_config::run_mode::write:
         if (cfg.counters) {
             return test_counter_update(env, cfg);
+        } else if (cfg.lwt) {
+            return test_lwt_write(env, cfg);
         } else {
             return test_write(env, cfg);
         }
@@ -276,6 +333,9 @@ void write_json_result(std::string result_file, const test_config& cfg, const ag
     if (cfg.counters) {
         test_type += "_counters";
     }
+    if (cfg.lwt) {
+        test_type += "_lwt";
+    }
     results["test_properties"]["type"] = test_type;
 
     // <version>-<release>
@@ -328,6 +388,9 @@ int scylla_simple_query_main(int argc, char** argv) {
         ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
         ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
         ("counters", "test counters")
+        ("counter-cache-size-in-mb", bpo::value<uint32_t>()->default_value(0), "size of the counter cache, used with --counters")
+        ("lwt", "test conditional updates, which are forwarded to the shard owning the partition (with --write)")
+        ("paxos-lease-period-in-ms", bpo::value<uint32_t>()->default_value(0), "keep leases on the next paxos round of updated partitions for this long, used with --lwt")
         ("tablets", "use tablets")
         ("initial-tablets", bpo::value<unsigned>()->default_value(128), "initial number of tablets")
         ("flush", "flush memtables before test")
@@ -359,6 +422,8 @@ int scylla_simple_query_main(int argc, char** argv) {
             const auto enable_cache = app.configuration()["enable-cache"].as<bool>();
             std::cout << "enable-cache=" << enable_cache << '\n';
             db_cfg->enable_cache(enable_cache);
+            db_cfg->counter_cache_size_in_mb(app.configuration()["counter-cache-size-in-mb"].as<uint32_t>());
+            db_cfg->paxos_lease_period_in_ms(app.configuration()["paxos-lease-period-in-ms"].as<uint32_t>());
             cql_test_config cfg(db_cfg);
             if (app.configuration().contains("tablets")) {
                 cfg.db_config->tablets_mode_for_new_keyspaces.set(db::tablets_mode_t::mode::enabled);
@@ -375,6 +440,7 @@ int scylla_simple_query_main(int argc, char** argv) {
             cfg.concurrency = app.configuration()["concurrency"].as<unsigned>();
             cfg.query_single_key = app.configuration().contains("query-single-key");
             cfg.counters = app.configuration().contains("counters");
+            cfg.lwt = app.configuration().contains("lwt");
             cfg.flush_memtables = app.configuration().contains("flush");
             if (app.configuration().contains("tablets")) {
                 cfg.initial_tablets = app.configuration()["initial-tablets"].as<unsigned>();
@@ -948,7 +948,18 @@ class scylla_sstable_compaction_group_view : public compaction::compaction_group
         , _backlog_tracker(std::make_unique<dummy_compaction_backlog_tracker>())
         , _group_id("dummy-group")
         , _generation_generator()
-    { }
+    {
+        _main_set = _compaction_strategy.make_sstable_set(*this);
+    }
+    void add_sstable(sstables::shared_sstable sst) {
+        _main_set.insert(std::move(sst));
+    }
+    void remove_sstable(sstables::shared_sstable sst) {
+        _main_set.erase(std::move(sst));
+    }
+    const sstables::sstable_set& sstables() const noexcept {
+        return _main_set;
+    }
     virtual dht::token_range token_range() const noexcept override { return dht::token_range::make(dht::first_token(), dht::last_token()); }
     virtual const schema_ptr& schema() const noexcept override { return _schema; }
     virtual unsigned min_compaction_threshold() const noexcept override { return _schema->min_compaction_threshold(); }
@@ -1060,6 +1071,201 @@ void scrub_operation(schema_ptr schema, reader_permit permit, const std::vector<
     sstables::compact_sstables(std::move(compaction_descriptor), compaction_data, compaction_group_view, progress_monitor).get();
 }
 
+class simulated_strategy_control : public compaction::strategy_control {
+public:
+    virtual bool has_ongoing_compaction(compaction::compaction_group_view&) const noexcept override {
+        return false;
+    }
+    virtual future<std::vector<sstables::shared_sstable>> candidates(compaction::compaction_group_view& t) const override {
+        auto main_set = co_await t.main_sstable_set();
+        co_return *main_set->all() | std::ranges::to<std::vector>();
+    }
+    virtual future<std::vector<sstables::frozen_sstable_run>> candidates_as_runs(compaction::compaction_group_view& t) const override {
+        auto main_set = co_await t.main_sstable_set();
+        co_return main_set->all_sstable_runs();
+    }
+};
+
+// Average number of sstables a single-partition read has to look at,
+// sampled at the first key of each sstable, ignoring bloom filters.
+double sstables_per_read(const schema& s, const sstables::sstable_set& set) {
+    auto all = set.all();
+    if (all->empty()) {
+        return 0.0;
+    }
+    uint64_t total = 0;
+    for (const auto& sample : *all) {
+        const auto& key = sample->get_first_decorated_key();
+        for (const auto& sst : *all) {
+            total += sst->get_first_decorated_key().tri_compare(s, key) <= 0 && sst->get_last_decorated_key().tri_compare(s, key) >= 0;
+        }
+        seastar::thread::maybe_yield();
+    }
+    return double(total) / all->size();
+}
+
+uint64_t sstables_disk_size(const sstables::sstable_set& set) {
+    uint64_t size = 0;
+    for (const auto& sst : *set.all()) {
+        size += sst->bytes_on_disk();
+    }
+    return size;
+}
+
+void simulate_compaction_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
+        sstables::sstables_manager& sst_man, const bpo::variables_map& vm) {
+    if (sstables.empty()) {
+        throw std::invalid_argument("no sstables specified on the command line");
+    }
+
+    if (vm.count("compaction-strategy")) {
+        auto type = sstables::compaction_strategy::type(vm["compaction-strategy"].as<std::string>());
+        auto options = vm.count("compaction-strategy-option")
+                ? vm["compaction-strategy-option"].as<program_options::string_map>() | std::ranges::to<std::map<sstring, sstring>>()
+                : std::map<sstring, sstring>{};
+        schema = schema_builder(schema)
+                .set_compaction_strategy(type)
+                .set_compaction_strategy_options(std::move(options))
+                .build();
+    }
+    // Bytes per second, 0 means compaction is assumed to keep up with any write rate.
+    const uint64_t compaction_throughput = vm["compaction-throughput"].as<uint64_t>() * 1024 * 1024;
+
+    auto output_dir = vm["output-dir"].as<std::string>();
+    validate_output_dir(output_dir, vm.count("unsafe-accept-nonempty-output-dir"));
+
+    scylla_sstable_compaction_group_view view(schema, permit, sst_man, output_dir);
+    simulated_strategy_control control;
+    auto& cs = view.get_compaction_strategy();
+
+    const auto input_sstables = std::unordered_set<sstables::shared_sstable>(sstables.begin(), sstables.end());
+    // Sstables written by the simulation are removed as soon as they are compacted.
+    auto unlink_if_output = [&] (const sstables::shared_sstable& sst) {
+        if (!input_sstables.contains(sst)) {
+            sst->unlink().get();
+        }
+    };
+
+    auto compact = [&] (sstables::compaction_descriptor desc) -> sstables::compaction_result {
+        desc.creator = [&view] (shard_id) { return view.make_sstable(); };
+        desc.replacer = [] (sstables::compaction_completion_desc) { };
+        auto compaction_data = sstables::compaction_data{};
+        compaction_progress_monitor progress_monitor;
+        auto inputs = desc.sstables;
+        auto result = sstables::compact_sstables(std::move(desc), compaction_data, view, progress_monitor).get();
+        for (const auto& sst : inputs) {
+            view.remove_sstable(sst);
+        }
+        for (const auto& sst : result.new_sstables) {
+            view.add_sstable(sst);
+        }
+        cs.notify_completion(view, inputs, result.new_sstables);
+        for (const auto& sst : inputs) {
+            unlink_if_output(sst);
+        }
+        return result;
+    };
+
+    // Sstables are replayed in the order they were written in, as if they were
+    // just flushed from memtables, at the time of their newest write.
+    auto timeline = sstables;
+    std::ranges::sort(timeline, std::less<>{}, [] (const sstables::shared_sstable& sst) { return sst->get_stats_metadata().max_timestamp; });
+    const auto start_time = timeline.front()->get_stats_metadata().max_timestamp;
+    auto seconds_since_start = [start_time] (api::timestamp_type ts) {
+        return std::chrono::duration<double>(std::chrono::microseconds(ts - start_time)).count();
+    };
+
+    json_writer writer;
+    writer.StartObject();
+    writer.Key("compaction_strategy");
+    writer.String(cs.name());
+    writer.Key("steps");
+    writer.StartArray();
+
+    uint64_t flushed_bytes = 0;
+    uint64_t written_bytes = 0;
+    uint64_t compactions = 0;
+    const unsigned max_compactions_per_flush = 1000;
+    // The time at which all compactions scheduled so far are done, given the modeled throughput.
+    double compaction_done_at = 0;
+
+    for (auto it = timeline.begin(); it != timeline.end(); ++it) {
+        const auto now = seconds_since_start((*it)->get_stats_metadata().max_timestamp);
+        const auto next_flush_at = std::next(it) == timeline.end()
+                ? std::numeric_limits<double>::infinity()
+                : seconds_since_start((*std::next(it))->get_stats_metadata().max_timestamp);
+
+        view.add_sstable(*it);
+        flushed_bytes += (*it)->bytes_on_disk();
+        written_bytes += (*it)->bytes_on_disk();
+        compaction_done_at = std::max(compaction_done_at, now);
+
+        // Keep compacting until the strategy is satisfied, or until compaction
+        // runs out of its I/O budget before the next flush arrives. A strategy
+        // that keeps asking for compactions without converging is cut off.
+        for (unsigned round = 0; !compaction_throughput || compaction_done_at < next_flush_at; ++round) {
+            if (round == max_compactions_per_flush) {
+                sst_log.warn("Compaction strategy {} didn't converge after {} compactions, moving on to the next flush", cs.name(), round);
+                break;
+            }
+            auto desc = cs.get_sstables_for_compaction(view, control).get();
+            if (desc.sstables.empty()) {
+                break;
+            }
+            const auto result = compact(std::move(desc));
+            ++compactions;
+            written_bytes += result.stats.end_size;
+            if (compaction_throughput) {
+                compaction_done_at += double(result.stats.start_size + result.stats.end_size) / compaction_throughput;
+            }
+        }
+
+        writer.StartObject();
+        writer.Key("time");
+        writer.Double(now);
+        writer.Key("flushed_bytes");
+        writer.Uint64(flushed_bytes);
+        writer.Key("written_bytes");
+        writer.Uint64(written_bytes);
+        writer.Key("write_amplification");
+        writer.Double(double(written_bytes) / flushed_bytes);
+        writer.Key("compactions");
+        writer.Uint64(compactions);
+        writer.Key("sstables");
+        writer.Uint64(view.sstables().size());
+        writer.Key("disk_size");
+        writer.Uint64(sstables_disk_size(view.sstables()));
+        writer.Key("sstables_per_read");
+        writer.Double(sstables_per_read(*schema, view.sstables()));
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+
+    // Space amplification is relative to the size of the data once fully compacted.
+    // The major compaction below only serves to measure that, so collect the
+    // state of the table left by the simulated strategy before running it.
+    const auto disk_size = sstables_disk_size(view.sstables());
+    const auto final_sstables_per_read = sstables_per_read(*schema, view.sstables());
+    auto major = cs.get_major_compaction_job(view, *view.sstables().all() | std::ranges::to<std::vector>());
+    uint64_t compacted_size = disk_size;
+    if (!major.sstables.empty()) {
+        compacted_size = compact(std::move(major)).stats.end_size;
+    }
+
+    writer.Key("write_amplification");
+    writer.Double(double(written_bytes) / flushed_bytes);
+    writer.Key("space_amplification");
+    writer.Double(compacted_size ? double(disk_size) / compacted_size : 1.0);
+    writer.Key("sstables_per_read");
+    writer.Double(final_sstables_per_read);
+    writer.EndObject();
+
+    for (const auto& sst : *view.sstables().all()) {
+        unlink_if_output(sst);
+    }
+}
+
 void dump_index_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
         sstables::sstables_manager& sst_man, const bpo::variables_map&) {
     if (sstables.empty()) {
@@ -3241,6 +3447,64 @@ for more information on this operation, including what the different modes do.
                     typed_option<>("unsafe-accept-nonempty-output-dir", "allow the operation to write into a non-empty output directory, acknowledging the risk that this may result in sstable clash"),
             }},
             scrub_operation},
+/* simulate-compaction */
+    {{"simulate-compaction",
+            "Simulate compaction of the sstable(s) with a compaction strategy",
+R"(
+Replay the sstables as if they were flushed one by one, in the order of their
+newest write timestamp, into a table using the specified compaction strategy
+(by default the one in the schema). After each flush, the compaction jobs
+selected by the strategy are executed, using the real compaction strategy and
+compaction implementations. Sstables produced by compactions are written to
+the directory specified via `--output-dir` and removed as soon as they are
+compacted again, or when the simulation ends. Input sstables are not modified.
+
+The I/O budget of compaction can be modeled with `--compaction-throughput`.
+Compaction of a job is assumed to take the time needed to read its input and
+write its output at the given throughput and compaction stops picking new jobs
+once it falls behind the next flush, so the strategy sees the resulting
+backlog. By default, compaction is assumed to keep up with any write rate.
+
+Reported for each flush are the write amplification (bytes written by flushes
+and compactions relative to bytes flushed), the number and size of sstables in
+the table, and the read amplification (the average number of sstables a
+single-partition read has to look at, ignoring bloom filters). At the end of
+the simulation, the read amplification of the table as left by the strategy is
+reported, together with the space amplification, which is the size of the
+table relative to its size after a major compaction.
+
+The output is a JSON object:
+
+    $ROOT := {
+        "compaction_strategy": String,
+        "steps": [$STEP, ...],
+        "write_amplification": Double,
+        "space_amplification": Double,
+        "sstables_per_read": Double
+    }
+
+    $STEP := {
+        "time": Double, // seconds since the first flush
+        "flushed_bytes": Uint64,
+        "written_bytes": Uint64,
+        "write_amplification": Double,
+        "compactions": Uint64,
+        "sstables": Uint64,
+        "disk_size": Uint64,
+        "sstables_per_read": Double
+    }
+
+See https://docs.scylladb.com/operating-scylla/admin-tools/scylla-sstable#simulate-compaction
+for more information on this operation.
+)",
+            {
+                    typed_option<std::string>("compaction-strategy", "the compaction strategy to simulate, defaults to the one in the schema"),
+                    typed_option<program_options::string_map>("compaction-strategy-option", {}, "option(s) for the compaction strategy, e.g. sstable_size_in_mb=160"),
+                    typed_option<uint64_t>("compaction-throughput", uint64_t(0), "modeled compaction throughput in MB/s, 0 means unlimited"),
+                    typed_option<std::string>("output-dir", ".", "directory to place the sstables written by the simulation to"),
+                    typed_option<>("unsafe-accept-nonempty-output-dir", "allow the operation to write into a non-empty output directory, acknowledging the risk that this may result in sstable clash"),
+            }},
+            simulate_compaction_operation},
 /* validate-checksums */
     {{"validate-checksums",
             "Validate the checksums of the sstable(s)",
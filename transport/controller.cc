@@ -240,6 +240,9 @@ future<> controller::do_start_server() {
               .allow_shard_aware_drivers = cfg.enable_shard_aware_drivers(),
               .bounce_request_smp_service_group = bounce_request_smp_service_group,
               .max_concurrent_requests = cfg.max_concurrent_requests_per_shard,
+              .max_pipelined_requests_per_connection = cfg.max_pipelined_requests_per_connection,
+              .adaptive_concurrency_limit = cfg.adaptive_concurrency_limit,
+              .adaptive_concurrency_limit_min = cfg.adaptive_concurrency_limit_min,
               .cql_duplicate_bind_variable_names_refer_to_same_variable = cfg.cql_duplicate_bind_variable_names_refer_to_same_variable,
               .uninitialized_connections_semaphore_cpu_concurrency = cfg.uninitialized_connections_semaphore_cpu_concurrency,
               .request_timeout_on_shutdown_in_seconds = cfg.request_timeout_on_shutdown_in_seconds
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include "transport/segment.hh"
+
+#include <lz4.h>
+#include <zlib.h>
+
+#include <seastar/core/coroutine.hh>
+
+#include "exceptions/exceptions.hh"
+
+namespace cql_transport::segment {
+
+static constexpr uint64_t payload_size_mask = (1 << 17) - 1;
+
+// The header CRC of the protocol: CRC-24 with the polynomial of OpenPGP,
+// over the bytes of the header in little-endian order.
+static uint32_t crc24(uint64_t bytes, size_t len) {
+    uint32_t crc = 0x875060;
+    while (len-- > 0) {
+        crc ^= (bytes & 0xff) << 16;
+        bytes >>= 8;
+        for (int i = 0; i < 8; i++) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= 0x1974f0b;
+            }
+        }
+    }
+    return crc;
+}
+
+// The payload CRC of the protocol: CRC-32 seeded with four fixed bytes.
+static uint32_t crc32(const char* data, size_t size) {
+    static constexpr Bytef initial_bytes[] = { 0xfa, 0x2d, 0x55, 0xca };
+    auto crc = ::crc32(0, initial_bytes, sizeof(initial_bytes));
+    return ::crc32(crc, reinterpret_cast<const Bytef*>(data), size);
+}
+
+static void write_le(bytes_ostream& out, uint64_t v, size_t len) {
+    auto p = out.write_place_holder(len);
+    for (size_t i = 0; i < len; ++i) {
+        p[i] = int8_t(v >> (8 * i));
+    }
+}
+
+static uint64_t read_le(const int8_t* p, size_t len) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; ++i) {
+        v |= uint64_t(uint8_t(p[i])) << (8 * i);
+    }
+    return v;
+}
+
+static void write_segment(bytes_ostream& out, std::span<const char> payload, bool self_contained, bool compressed) {
+    if (!compressed) {
+        uint64_t h = payload.size() | (uint64_t(self_contained) << 17);
+        write_le(out, h, 3);
+        write_le(out, crc24(h, 3), 3);
+        out.write(bytes_view(reinterpret_cast<const int8_t*>(payload.data()), payload.size()));
+        write_le(out, crc32(payload.data(), payload.size()), trailer_size);
+        return;
+    }
+    std::vector<char> buf(LZ4_COMPRESSBOUND(payload.size()));
+    auto compressed_size = LZ4_compress_default(payload.data(), buf.data(), payload.size(), buf.size());
+    std::span<const char> wire = payload;
+    uint64_t uncompressed_size = 0;
+    // An uncompressed size of zero tells that the payload is sent as is,
+    // when compressing it doesn't make it smaller.
+    if (compressed_size > 0 && size_t(compressed_size) < payload.size()) {
+        wire = std::span<const char>(buf.data(), compressed_size);
+        uncompressed_size = payload.size();
+    }
+    uint64_t h = wire.size() | (uncompressed_size << 17) | (uint64_t(self_contained) << 34);
+    write_le(out, h | (uint64_t(crc24(h, 5)) << 40), 8);
+    out.write(bytes_view(reinterpret_cast<const int8_t*>(wire.data()), wire.size()));
+    write_le(out, crc32(wire.data(), wire.size()), trailer_size);
+}
+
+header parse_header(bytes_view buf, bool compressed) {
+    if (buf.size() != header_size(compressed)) {
+        throw exceptions::protocol_exception(format("Invalid segment header size {}", buf.size()));
+    }
+    if (!compressed) {
+        auto h = read_le(buf.data(), 3);
+        if (crc24(h, 3) != read_le(buf.data() + 3, 3)) {
+            throw exceptions::protocol_exception("Segment header CRC mismatch");
+        }
+        return header{
+            .payload_size = uint32_t(h & payload_size_mask),
+            .uncompressed_size = 0,
+            .self_contained = bool((h >> 17) & 1),
+        };
+    }
+    auto h8 = read_le(buf.data(), 8);
+    auto h = h8 & ((uint64_t(1) << 40) - 1);
+    if (crc24(h, 5) != (h8 >> 40)) {
+        throw exceptions::protocol_exception("Segment header CRC mismatch");
+    }
+    return header{
+        .payload_size = uint32_t(h & payload_size_mask),
+        .uncompressed_size = uint32_t((h >> 17) & payload_size_mask),
+        .self_contained = bool((h >> 34) & 1),
+    };
+}
+
+temporary_buffer<char> decode_payload(const header& h, temporary_buffer<char> payload_and_trailer) {
+    if (payload_and_trailer.size() != h.payload_size + trailer_size) {
+        throw exceptions::protocol_exception(format("Truncated segment: expected {} bytes, got {}",
+                h.payload_size + trailer_size, payload_and_trailer.size()));
+    }
+    auto crc = read_le(reinterpret_cast<const int8_t*>(payload_and_trailer.get() + h.payload_size), trailer_size);
+    if (crc32(payload_and_trailer.get(), h.payload_size) != crc) {
+        throw exceptions::protocol_exception("Segment payload CRC mismatch");
+    }
+    payload_and_trailer.trim(h.payload_size);
+    if (!h.uncompressed_size) {
+        return payload_and_trailer;
+    }
+    temporary_buffer<char> out(h.uncompressed_size);
+    auto ret = LZ4_decompress_safe(payload_and_trailer.get(), out.get_write(), h.payload_size, h.uncompressed_size);
+    if (ret < 0 || uint32_t(ret) != h.uncompressed_size) {
+        throw exceptions::protocol_exception("Segment payload LZ4 uncompression failure");
+    }
+    return out;
+}
+
+void encode(bytes_ostream& out, std::span<const bytes_view> frames, bool compressed) {
+    std::vector<char> payload;
+    auto append = [&] (bytes_view v) {
+        auto p = reinterpret_cast<const char*>(v.data());
+        payload.insert(payload.end(), p, p + v.size());
+    };
+    for (auto frame : frames) {
+        if (!payload.empty() && payload.size() + frame.size() > max_payload_size) {
+            write_segment(out, payload, true, compressed);
+            payload.clear();
+        }
+        if (frame.size() <= max_payload_size) {
+            append(frame);
+            continue;
+        }
+        while (!frame.empty()) {
+            auto part = frame.substr(0, std::min(frame.size(), max_payload_size));
+            write_segment(out, std::span<const char>(reinterpret_cast<const char*>(part.data()), part.size()), false, compressed);
+            frame.remove_prefix(part.size());
+        }
+    }
+    if (!payload.empty()) {
+        write_segment(out, payload, true, compressed);
+    }
+}
+
+future<std::optional<decoded_segment>> read(input_stream<char>& in, bool compressed) {
+    auto buf = co_await in.read_exactly(header_size(compressed));
+    if (buf.empty()) {
+        co_return std::nullopt;
+    }
+    auto h = parse_header(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size()), compressed);
+    auto payload = co_await in.read_exactly(h.payload_size + trailer_size);
+    co_return decoded_segment{
+        .payload = decode_payload(h, std::move(payload)),
+        .self_contained = h.self_contained,
+    };
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <span>
+
+#include <seastar/core/future.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "bytes.hh"
+#include "bytes_ostream.hh"
+#include "seastarx.hh"
+
+namespace cql_transport::segment {
+
+// Segment framing of the native protocol v5 (section 2 of native_protocol_v5.spec).
+//
+// Once a v5 connection is established, frames aren't written to it directly,
+// but packed into segments. A segment carries either a number of complete
+// frames, in which case it's self-contained, or a part of a frame which is
+// too large for a single segment. The header and the payload of a segment
+// are protected by checksums. With compression, the payload of a segment is
+// compressed with lz4 as a whole, which is more effective than compressing
+// each of many small frames on its own.
+//
+// This is only the codec: cql_server doesn't use it yet. The server
+// negotiates protocol versions up to v4, and segment framing can only be
+// switched on for a connection together with the rest of v5 (after the
+// STARTUP/READY or AUTHENTICATE exchange, as the specification requires).
+// Until then it is exercised by transport_test and perf-generic-server.
+
+// Maximum size of the payload of a segment, before compression.
+constexpr size_t max_payload_size = 128 * 1024 - 1;
+
+constexpr size_t header_size(bool compressed) {
+    return compressed ? 8 : 6;
+}
+
+// The CRC32 of the payload, which follows it.
+constexpr size_t trailer_size = 4;
+
+struct header {
+    // Size of the payload on the wire.
+    uint32_t payload_size;
+    // Size of the payload once decompressed, zero if it isn't compressed.
+    uint32_t uncompressed_size;
+    bool self_contained;
+};
+
+struct decoded_segment {
+    temporary_buffer<char> payload;
+    bool self_contained;
+};
+
+// Parses the header of a segment and verifies its checksum.
+// Throws exceptions::protocol_exception if the header is corrupt.
+header parse_header(bytes_view buf, bool compressed);
+
+// Verifies the checksum of the payload of a segment, followed by its trailer,
+// and decompresses it.
+// Throws exceptions::protocol_exception if the payload is corrupt.
+temporary_buffer<char> decode_payload(const header& h, temporary_buffer<char> payload_and_trailer);
+
+// Appends to \p out the segments carrying \p frames. Frames are packed into
+// self-contained segments, as many as fit into each. A frame which doesn't
+// fit into a single segment is split among segments which aren't
+// self-contained.
+void encode(bytes_ostream& out, std::span<const bytes_view> frames, bool compressed);
+
+// Reads a segment from \p in and decodes its payload.
+// Returns a disengaged optional at the end of the stream.
+future<std::optional<decoded_segment>> read(input_stream<char>& in, bool compressed);
+
+}
@@ -29,6 +29,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/coroutine/as_future.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/net/byteorder.hh>
 #include <seastar/core/metrics.hh>
 #include <seastar/net/byteorder.hh>
@@ -38,6 +39,7 @@
 #include <seastar/core/execution_stage.hh>
 #include "utils/assert.hh"
 #include "utils/exception_container.hh"
+#include "utils/error_injection.hh"
 #include "utils/log.hh"
 #include "utils/result_try.hh"
 #include "utils/result_combinators.hh"
@@ -293,6 +295,29 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
                         sm::description(
                             seastar::format("Holds an incrementing counter with the requests that ever blocked due to reaching the memory quota limit ({}B). "
                                             "The first derivative of this value shows how often we block due to memory exhaustion in the \"CQL transport\" component.", _config.max_request_size))),
+        sm::make_counter("requests_shed_concurrency_limit", _stats.requests_shed_concurrency_limit,
+                        sm::description("Counts the requests that were shed because the adaptive limit of concurrent requests of their service level "
+                                            "was reached (enabled via adaptive_concurrency_limit).")),
+        sm::make_gauge("adaptive_concurrency_limit", [this] {
+                            uint64_t limit = 0;
+                            for (auto& [sg, limiter] : _concurrency_limiters) {
+                                limit += limiter.limit();
+                            }
+                            return limit;
+                        },
+                        sm::description("Holds the sum of the adaptive limits of concurrent requests of all service levels.")),
+        sm::make_counter("requests_bounced_out", _stats.requests_bounced_out,
+                        sm::description("Counts the requests that were forwarded to another shard, which owns the partition they access (e.g. LWT requests).")),
+        sm::make_counter("requests_bounced_in", _stats.requests_bounced_in,
+                        sm::description("Counts the requests that were forwarded to this shard by other shards, because it owns the partition they access.")),
+        sm::make_counter("requests_pipeline_throttled", _stats.requests_pipeline_throttled,
+                        sm::description("Counts the number of times reading requests from a connection was paused, because it had too many requests in flight "
+                                            "(threshold configured via max_pipelined_requests_per_connection).")),
+        sm::make_counter("response_frames", _stats.response_frames,
+                        sm::description("Counts the number of response frames written to clients.")),
+        sm::make_counter("response_writes", _stats.response_writes,
+                        sm::description("Counts the number of batches of response frames flushed to clients. "
+                                            "The ratio of response_frames to response_writes is the average number of frames coalesced into a single write.")),
         sm::make_counter("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component."))(basic_level),
@@ -330,6 +355,17 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
 
 cql_server::~cql_server() = default;
 
+utils::adaptive_concurrency_limiter& cql_server::get_concurrency_limiter(scheduling_group sg) {
+    auto it = _concurrency_limiters.find(sg);
+    if (it == _concurrency_limiters.end()) {
+        it = _concurrency_limiters.emplace(sg, utils::adaptive_concurrency_limiter(utils::adaptive_concurrency_limiter::config{})).first;
+    }
+    // The limit never exceeds the static one, and both may be updated live.
+    auto max_limit = std::min(_config.max_concurrent_requests(), utils::adaptive_concurrency_limiter::config{}.max_limit);
+    it->second.set_bounds(std::min(_config.adaptive_concurrency_limit_min(), max_limit), max_limit);
+    return it->second;
+}
+
 shared_ptr<generic_server::connection>
 cql_server::make_connection(socket_address server_addr, connected_socket&& fd, socket_address addr, named_semaphore& sem, semaphore_units<named_semaphore_exception_factory> initial_sem_units) {
     return make_shared<connection>(*this, server_addr, std::move(fd), std::move(addr), sem, std::move(initial_sem_units));
@@ -768,6 +804,24 @@ future<> cql_server::connection::process_request() {
             });
         }
 
+        std::optional<utils::adaptive_concurrency_limiter::permit> concurrency_permit;
+        if (allow_shedding && _server._config.adaptive_concurrency_limit()) {
+            auto& limiter = _server.get_concurrency_limiter(_current_scheduling_group);
+            concurrency_permit = limiter.try_get_permit();
+            if (!concurrency_permit) {
+                ++_server._stats.requests_shed;
+                ++_server._stats.requests_shed_concurrency_limit;
+                return _read_buf.skip(f.length).then([this, stream = f.stream, limit = limiter.limit()] {
+                    const auto message = format("too many in-flight requests (adaptive concurrency limit of the service level): {}", limit);
+                    clogger.debug("{}: {}, request dropped", _client_state.get_remote_address(), message);
+                    write_response(make_error(stream, exceptions::exception_code::OVERLOADED,
+                        message,
+                        tracing::trace_state_ptr()));
+                    return make_ready_future<>();
+                });
+            }
+        }
+
         const auto shedding_timeout = std::chrono::milliseconds(50);
         auto fut = allow_shedding
                 ? get_units(_server._memory_available, mem_estimate, shedding_timeout).then_wrapped([this, length = f.length] (auto f) {
@@ -791,19 +845,20 @@ future<> cql_server::connection::process_request() {
             ++_server._stats.requests_blocked_memory;
         }
 
-        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested] (auto mem_permit_fut) {
+        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested, concurrency_permit = std::move(concurrency_permit)] (auto mem_permit_fut) mutable {
           if (mem_permit_fut.failed()) {
               // Ignore semaphore errors - they are expected if load shedding took place
               mem_permit_fut.ignore_ready_future();
               return make_ready_future<>();
           }
           semaphore_units<> mem_permit = mem_permit_fut.get();
-          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
+          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit)), concurrency_permit = std::move(concurrency_permit)] (fragmented_temporary_buffer buf) mutable {
 
             ++_server._stats.requests_served;
             ++_server._stats.requests_serving;
 
             _pending_requests_gate.enter();
+            auto slot = pipeline_slot(*this);
             auto leave = defer([this] {
                 _shedding_timer.cancel();
                 _shed_incoming_requests = false;
@@ -823,16 +878,18 @@ future<> cql_server::connection::process_request() {
                     _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit) :
                     process_request_one(istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit);
 
-            future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), stream] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+            future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), slot = std::move(slot), stream, concurrency_permit = std::move(concurrency_permit)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+                // The request is served, what remains is to write its response.
+                concurrency_permit.reset();
                 try {
                     if (response_f.failed()) {
                         const auto message = format("request processing failed, error [{}]", response_f.get_exception());
                         clogger.error("{}: {}", _client_state.get_remote_address(), message);
                         write_response(make_error(stream, exceptions::exception_code::SERVER_ERROR,
                                                   message,
-                                                  tracing::trace_state_ptr()));
+                                                  tracing::trace_state_ptr()), empty_service_permit(), cql_compression::none, std::move(slot));
                     } else {
-                        write_response(response_f.get(), std::move(mem_permit), _compression);
+                        write_response(response_f.get(), std::move(mem_permit), _compression, std::move(slot));
                     }
                     _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
                 } catch (...) {
@@ -842,7 +899,10 @@ future<> cql_server::connection::process_request() {
             });
 
             if (should_paralelize) {
-                return make_ready_future<>();
+                // Don't read further requests of a connection with too many
+                // of them in flight, so that a deep pipeline of a single
+                // client can't take over the shard.
+                return wait_for_pipeline_slot();
             } else {
                 return request_response_future;
             }
@@ -1045,7 +1105,12 @@ cql_server::connection::process_on_shard(shard_id shard, uint16_t stream, fragme
     auto sg = _server._config.bounce_request_smp_service_group;
     auto gcs = cs.move_to_other_shard();
     auto gt = tracing::global_trace_state_ptr(std::move(trace_state));
+    ++_server._stats.requests_bounced_out;
+    // The request is read in place from the buffers of this shard, which
+    // stay alive until the other shard is done with it, and the response
+    // comes back as a foreign pointer, so neither is copied.
     co_return co_await _server.container().invoke_on(shard, sg, [&, stream, dialect] (cql_server& server) -> future<process_fn_return_type> {
+        ++server._stats.requests_bounced_in;
         bytes_ostream linearization_buffer;
         request_reader in(is, linearization_buffer);
         auto client_state = gcs.get();
@@ -1691,17 +1756,77 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
     return response;
 }
 
-void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
+void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression,
+        pipeline_slot slot)
 {
-    _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
-        auto message = response->make_message(_version, compression);
-        message.on_delete([response = std::move(response)] { });
-        return _write_buf.write(std::move(message)).then([this] {
-            return _write_buf.flush();
-        });
+    _pending_responses.push_back(pending_response{std::move(response), std::move(permit), compression, std::move(slot)});
+    if (_writing_responses) {
+        // Will be written by the running write_pending_responses().
+        return;
+    }
+    _writing_responses = true;
+    _ready_to_respond = _ready_to_respond.then_wrapped([this] (future<> f) {
+        if (f.failed()) {
+            // Responses queued after a failed write are dropped, like
+            // the failed ones.
+            _pending_responses.clear();
+            _writing_responses = false;
+            return f;
+        }
+        return write_pending_responses();
     });
 }
 
+future<> cql_server::connection::write_pending_responses() {
+    try {
+        while (!_pending_responses.empty()) {
+            // Write all the responses ready so far and flush them together,
+            // so that a pipelining client gets many of them in a single
+            // write. Bound the batch, so that a connection with a deep
+            // pipeline yields to the others between batches.
+            size_t frames = 0;
+            size_t bytes = 0;
+            std::vector<service_permit> permits;
+            // Released once the batch is flushed, letting more requests in.
+            std::vector<pipeline_slot> slots;
+            while (!_pending_responses.empty() && frames < max_coalesced_response_frames && bytes < max_coalesced_response_bytes) {
+                auto r = std::move(_pending_responses.front());
+                _pending_responses.pop_front();
+                auto message = r.response->make_message(_version, r.compression);
+                bytes += message.size();
+                message.on_delete([response = std::move(r.response)] { });
+                permits.push_back(std::move(r.permit));
+                slots.push_back(std::move(r.slot));
+                ++frames;
+                co_await _write_buf.write(std::move(message));
+            }
+            co_await utils::get_local_injector().inject("cql_delay_response_flush", std::chrono::milliseconds(100));
+            co_await _write_buf.flush();
+            _server._stats.response_frames += frames;
+            ++_server._stats.response_writes;
+            if (!_pending_responses.empty()) {
+                co_await coroutine::maybe_yield();
+            }
+        }
+    } catch (...) {
+        _pending_responses.clear();
+        _writing_responses = false;
+        throw;
+    }
+    _writing_responses = false;
+}
+
+future<> cql_server::connection::wait_for_pipeline_slot() {
+    auto fits = [this] {
+        return _pipelined_requests == 0 || _pipelined_requests < _server._config.max_pipelined_requests_per_connection();
+    };
+    if (fits()) {
+        return make_ready_future<>();
+    }
+    ++_server._stats.requests_pipeline_throttled;
+    return _pipelined_request_done.wait(std::move(fits));
+}
+
 scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
     if (compression != cql_compression::none) {
         compress(compression);
@@ -19,6 +19,8 @@
 #include "service/qos/qos_configuration_change_subscriber.hh"
 #include "timeout_config.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/condition-variable.hh>
+#include <deque>
 #include <memory>
 #include <type_traits>
 #include <boost/intrusive/list.hpp>
@@ -30,6 +32,7 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/core/execution_stage.hh>
 #include "utils/updateable_value.hh"
+#include "utils/adaptive_concurrency_limiter.hh"
 #include "generic_server.hh"
 #include "service/query_state.hh"
 #include "cql3/query_options.hh"
@@ -119,6 +122,9 @@ struct cql_server_config {
     bool allow_shard_aware_drivers = true;
     smp_service_group bounce_request_smp_service_group = default_smp_service_group();
     utils::updateable_value<uint32_t> max_concurrent_requests;
+    utils::updateable_value<uint32_t> max_pipelined_requests_per_connection;
+    utils::updateable_value<bool> adaptive_concurrency_limit;
+    utils::updateable_value<uint32_t> adaptive_concurrency_limit_min;
     utils::updateable_value<bool> cql_duplicate_bind_variable_names_refer_to_same_variable;
     utils::updateable_value<uint32_t> uninitialized_connections_semaphore_cpu_concurrency;
     utils::updateable_value<uint32_t> request_timeout_on_shutdown_in_seconds;
@@ -191,6 +197,12 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint32_t requests_serving = 0;
         uint64_t requests_blocked_memory = 0;
         uint64_t requests_shed = 0;
+        uint64_t requests_shed_concurrency_limit = 0;
+        uint64_t requests_bounced_out = 0;
+        uint64_t requests_bounced_in = 0;
+        uint64_t requests_pipeline_throttled = 0;
+        uint64_t response_frames = 0;
+        uint64_t response_writes = 0;
 
         std::unordered_map<exceptions::exception_code, uint64_t> errors;
     };
@@ -210,6 +222,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     qos::service_level_controller& _sl_controller;
     gms::gossiper& _gossiper;
     scheduling_group_key _stats_key;
+    // Adaptive limits of the requests served concurrently, per service level.
+    std::unordered_map<scheduling_group, utils::adaptive_concurrency_limiter> _concurrency_limiters;
 public:
     cql_server(distributed<cql3::query_processor>& qp, auth::service&,
             service::memory_limiter& ml,
@@ -238,6 +252,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     future<> update_connections_service_level_params();
     future<std::vector<connection_service_level_params>> get_connections_service_level_params();
 private:
+    utils::adaptive_concurrency_limiter& get_concurrency_limiter(scheduling_group sg);
+
     class fmt_visitor;
     friend class connection;
     friend std::unique_ptr<cql_server::response> make_result(int16_t stream, messages::result_message& msg,
@@ -257,6 +273,44 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         bool _authenticating = false;
         bool _tenant_switch = false;
 
+        // Requests processed concurrently, whose responses weren't written yet.
+        uint32_t _pipelined_requests = 0;
+        condition_variable _pipelined_request_done;
+
+        // Counts a request in _pipelined_requests until its response is
+        // written, or dropped.
+        class pipeline_slot {
+            connection* _conn = nullptr;
+        public:
+            pipeline_slot() noexcept = default;
+            explicit pipeline_slot(connection& conn) noexcept : _conn(&conn) {
+                ++_conn->_pipelined_requests;
+            }
+            pipeline_slot(pipeline_slot&& o) noexcept : _conn(std::exchange(o._conn, nullptr)) {}
+            pipeline_slot& operator=(pipeline_slot&&) = delete;
+            ~pipeline_slot() {
+                if (_conn) {
+                    --_conn->_pipelined_requests;
+                    _conn->_pipelined_request_done.signal();
+                }
+            }
+        };
+
+        struct pending_response {
+            foreign_ptr<std::unique_ptr<cql_server::response>> response;
+            service_permit permit;
+            cql_compression compression;
+            pipeline_slot slot;
+        };
+        // Responses which are ready, but not written yet. They are written by
+        // a single fiber, which coalesces them into as few writes as possible.
+        std::deque<pending_response> _pending_responses;
+        bool _writing_responses = false;
+
+        // Bounds on the responses coalesced into a single write.
+        static constexpr size_t max_coalesced_response_frames = 128;
+        static constexpr size_t max_coalesced_response_bytes = 1024 * 1024;
+
         enum class tracing_request_type : uint8_t {
             not_requested,
             no_write_on_close,
@@ -358,7 +412,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         process_on_shard(shard_id shard, uint16_t stream, fragmented_temporary_buffer::istream is, service::client_state& cs,
                 tracing::trace_state_ptr trace_state, cql3::dialect dialect, cql3::computed_function_values&& cached_vals, Process process_fn);
 
-        void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none);
+        void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none,
+                pipeline_slot slot = {});
+        future<> write_pending_responses();
+        future<> wait_for_pipeline_slot();
 
         friend event_notifier;
     };
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#include "utils/adaptive_concurrency_limiter.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace utils {
+
+// Weights of a new sample in the short-term and the long-term moving
+// averages of the latency.
+static constexpr double short_latency_weight = 0.1;
+static constexpr double long_latency_weight = 0.002;
+
+adaptive_concurrency_limiter::adaptive_concurrency_limiter(config cfg)
+    : _cfg(cfg)
+    , _limit(std::clamp(cfg.initial_limit, cfg.min_limit, std::max(cfg.min_limit, cfg.max_limit)))
+{ }
+
+bool adaptive_concurrency_limiter::try_acquire() {
+    if (_inflight >= limit()) {
+        return false;
+    }
+    ++_inflight;
+    return true;
+}
+
+void adaptive_concurrency_limiter::release(std::chrono::nanoseconds latency) {
+    update_limit(std::max<double>(latency.count(), 1));
+    --_inflight;
+}
+
+void adaptive_concurrency_limiter::set_bounds(uint32_t min_limit, uint32_t max_limit) {
+    _cfg.min_limit = min_limit;
+    _cfg.max_limit = std::max(min_limit, max_limit);
+    _limit = std::clamp<double>(_limit, _cfg.min_limit, _cfg.max_limit);
+}
+
+uint32_t adaptive_concurrency_limiter::limit() const {
+    return uint32_t(_limit);
+}
+
+void adaptive_concurrency_limiter::update_limit(double latency) {
+    if (!_short_latency) {
+        _short_latency = _long_latency = latency;
+        return;
+    }
+    _short_latency += (latency - _short_latency) * short_latency_weight;
+    _long_latency += (latency - _long_latency) * long_latency_weight;
+    // After a long period of high latency, the baseline has crept up and
+    // would take long to come back once the load goes away. Pull it down
+    // faster so that the limit can recover.
+    if (_long_latency > 2 * _short_latency) {
+        _long_latency = 0.95 * _long_latency + 0.05 * _short_latency;
+    }
+
+    // Don't grow the limit while it isn't even used, or it would grow
+    // without bounds under a light load, and provide no protection when an
+    // overload finally comes.
+    if (_inflight < _limit / 2) {
+        return;
+    }
+
+    auto gradient = std::clamp(_cfg.latency_tolerance * _long_latency / _short_latency, 0.5, 1.0);
+    auto new_limit = _limit * gradient + std::sqrt(_limit);
+    _limit = std::clamp<double>(_limit * (1 - _cfg.smoothing) + new_limit * _cfg.smoothing, _cfg.min_limit, _cfg.max_limit);
+}
+
+}
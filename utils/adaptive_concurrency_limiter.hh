@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2025-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: LicenseRef-ScyllaDB-Source-Available-1.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace utils {
+
+/**
+ * Limits the number of concurrently served requests to a value which adapts
+ * to the observed latency of the requests.
+ *
+ * The limiter tracks two moving averages of the latency: a short-term one,
+ * which follows the current latency, and a long-term one, which serves as the
+ * baseline latency of the unloaded system. While the short-term latency stays
+ * close to the baseline, the limit grows, by roughly the square root of the
+ * limit per request. Once requests queue up somewhere and the short-term
+ * latency grows above the baseline, the limit shrinks in proportion
+ * (the "gradient" of the latency), down to half of it per request.
+ *
+ * Requests in excess of the limit are meant to be rejected right away, so that
+ * the latency of the admitted ones stays bounded under overload, instead of
+ * all requests queueing up and timing out.
+ */
+class adaptive_concurrency_limiter {
+public:
+    struct config {
+        uint32_t min_limit = 16;
+        uint32_t max_limit = 10000;
+        uint32_t initial_limit = 128;
+        // Latency above the baseline by at most this factor doesn't reduce
+        // the limit.
+        double latency_tolerance = 1.5;
+        // The weight of a new limit estimate against the current limit.
+        double smoothing = 0.2;
+    };
+private:
+    config _cfg;
+    double _limit;
+    uint32_t _inflight = 0;
+    // Moving averages of the latency, in nanoseconds. Zero until the first
+    // sample.
+    double _short_latency = 0;
+    double _long_latency = 0;
+public:
+    // An admitted request, which is released when the permit is destroyed,
+    // with the time since the admission as its latency.
+    class permit {
+        adaptive_concurrency_limiter* _limiter;
+        std::chrono::steady_clock::time_point _start;
+    public:
+        explicit permit(adaptive_concurrency_limiter& limiter)
+            : _limiter(&limiter)
+            , _start(std::chrono::steady_clock::now())
+        { }
+        permit(permit&& o) noexcept
+            : _limiter(std::exchange(o._limiter, nullptr))
+            , _start(o._start)
+        { }
+        permit& operator=(permit&& o) noexcept {
+            if (this != &o) {
+                // Releases the request held so far.
+                permit old(std::move(*this));
+                _limiter = std::exchange(o._limiter, nullptr);
+                _start = o._start;
+            }
+            return *this;
+        }
+        ~permit() {
+            if (_limiter) {
+                _limiter->release(std::chrono::steady_clock::now() - _start);
+            }
+        }
+    };
+
+    explicit adaptive_concurrency_limiter(config cfg);
+
+    // Admits a request if fewer than limit() requests are in flight.
+    // Every successful call must be paired with a call to release().
+    bool try_acquire();
+
+    // Like try_acquire(), but returns a permit which releases the request.
+    std::optional<permit> try_get_permit() {
+        if (!try_acquire()) {
+            return std::nullopt;
+        }
+        return std::optional<permit>(std::in_place, *this);
+    }
+
+    // Marks an admitted request as completed, after the given service latency,
+    // and adjusts the limit accordingly.
+    void release(std::chrono::nanoseconds latency);
+
+    // Sets the bounds of the limit. The current limit is clamped to them.
+    void set_bounds(uint32_t min_limit, uint32_t max_limit);
+
+    uint32_t limit() const;
+    uint32_t inflight() const {
+        return _inflight;
+    }
+private:
+    void update_limit(double latency);
+};
+
+}
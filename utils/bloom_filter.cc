@@ -15,9 +15,11 @@
 #include <seastar/core/loop.hh>
 #include "utils/large_bitset.hh"
 #include <array>
+#include <cmath>
 #include <cstdlib>
 #include "utils/bloom_calculations.hh"
 #include "bloom_filter.hh"
+#include "utils/assert.hh"
 
 namespace utils {
 namespace filter {
@@ -68,6 +70,18 @@ void bloom_filter::add(const bytes_view& key) {
     });
 }
 
+void bloom_filter::merge(const bloom_filter& other) {
+    SCYLLA_ASSERT(is_mergeable_with(other));
+    _bitset.merge(other._bitset);
+}
+
+double bloom_filter::estimated_false_positive_chance() const {
+    if (!_bitset.size()) {
+        return 1.0;
+    }
+    return std::pow(double(_bitset.count()) / _bitset.size(), _hash_count);
+}
+
 bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
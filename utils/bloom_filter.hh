@@ -32,8 +32,10 @@ class bloom_filter: public i_filter {
     stats& _stats = _shard_stats;
 
 public:
-    int num_hashes() { return _hash_count; }
+    int num_hashes() const { return _hash_count; }
     bitmap& bits() { return _bitset; }
+    const bitmap& bits() const { return _bitset; }
+    filter_format format() const { return _format; }
 
     bloom_filter(int hashes, bitmap&& bs, filter_format format) noexcept;
     ~bloom_filter() noexcept;
@@ -54,6 +56,21 @@ class bloom_filter: public i_filter {
         return sizeof(_hash_count) + _bitset.memory_size();
     }
 
+    // Filters built with the same bitset size, number of hashes and format
+    // map every key to the same bits, so their bitsets can be merged.
+    bool is_mergeable_with(const bloom_filter& other) const noexcept {
+        return _bitset.size() == other._bitset.size() && _hash_count == other._hash_count && _format == other._format;
+    }
+
+    // Adds all keys present in the other filter to this one, without
+    // rehashing them. The filters must be mergeable. Must be called in a
+    // seastar thread.
+    void merge(const bloom_filter& other);
+
+    // Estimates the false positive chance from the fraction of set bits.
+    // Must be called in a seastar thread.
+    double estimated_false_positive_chance() const;
+
     static const stats& get_shard_stats() noexcept {
         return _shard_stats;
     }
@@ -13,6 +13,8 @@
 #include <seastar/core/align.hh>
 #include <seastar/core/thread.hh>
 
+#include <bit>
+
 using namespace seastar;
 
 large_bitset::large_bitset(size_t nr_bits) : _nr_bits(nr_bits) {
@@ -35,3 +37,25 @@ large_bitset::clear() {
         thread::maybe_yield();
     }
 }
+
+void
+large_bitset::merge(const large_bitset& other) {
+    SCYLLA_ASSERT(thread::running_in_thread());
+    SCYLLA_ASSERT(_nr_bits == other._nr_bits);
+    auto it = other._storage.begin();
+    for (auto&& pos: _storage) {
+        pos |= *it++;
+        thread::maybe_yield();
+    }
+}
+
+size_t
+large_bitset::count() const {
+    SCYLLA_ASSERT(thread::running_in_thread());
+    size_t ret = 0;
+    for (auto&& pos: _storage) {
+        ret += std::popcount(pos);
+        thread::maybe_yield();
+    }
+    return ret;
+}
@@ -54,6 +54,10 @@ class large_bitset {
         _storage[idx1] &= ~(int_type(1) << idx2);
     }
     void clear();
+    // Sets all bits which are set in the other bitset, which must have the same size.
+    void merge(const large_bitset& other);
+    // Returns the number of set bits.
+    size_t count() const;
 
     const utils::chunked_vector<int_type>& get_storage() const {
         return _storage;